@@ -0,0 +1,102 @@
+/* microbenchmark: compact dict table vs. the previous std::unordered_map-based __GC_DICT
+
+   both tables are driven through the same (find/operator[]/erase) interface, so they do
+   exactly the same work. build and run (from this directory):
+
+   g++ -O2 -std=c++17 -I../shedskin/lib bench_dict.cpp ../shedskin/lib/builtin.cpp -lgc -lgctba -o bench_dict
+   ./bench_dict
+*/
+
+#include "builtin.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace __shedskin__;
+
+template <class K, class V>
+using old_dict = std::unordered_map<K, V, ss_hash<K>, ss_eq<K>, gc_allocator< std::pair<K const, V> > >;
+
+template <class K, class V>
+using new_dict = __dicttable<K, V>;
+
+static const int N = 1000000;
+static const int ROUNDS = 5;
+
+struct timer {
+    std::chrono::steady_clock::time_point t0;
+    timer() : t0(std::chrono::steady_clock::now()) {}
+    double elapsed() { return std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count(); }
+};
+
+static void report(const char *name, double told, double tnew) {
+    printf("%-24s old %8.3fs  new %8.3fs  speedup %5.2fx\n", name, told, tnew, told/tnew);
+}
+
+/* integer keys: insert, lookup (hits and misses), iterate, delete */
+
+template<class D> static long long bench_int() {
+    long long s = 0;
+    for(int r=0; r<ROUNDS; r++) {
+        D d;
+        for(int i=0; i<N; i++)
+            d[i*7] = i;
+        for(int i=0; i<2*N; i++) {
+            auto it = d.find(i);
+            if(it != d.end())
+                s += (*it).second;
+        }
+        for(auto &e : d)
+            s += e.first;
+        for(int i=0; i<N; i+=2)
+            d.erase(d.find(i*7));
+        s += d.size();
+    }
+    return s;
+}
+
+/* string keys: word counting (symbol table-like workload) */
+
+static list<str *> *make_words() {
+    list<str *> *words = new list<str *>();
+    for(int i=0; i<N; i++)
+        words->append(__str((__ss_int)((i*2654435761u) % (N/10))));
+    return words;
+}
+
+template<class D> static long long bench_str(list<str *> *words) {
+    long long s = 0;
+    for(int r=0; r<ROUNDS; r++) {
+        D d;
+        for(str *w : words->units) {
+            auto it = d.find(w);
+            if(it == d.end())
+                d[w] = 1;
+            else
+                (*it).second += 1;
+        }
+        for(str *w : words->units)
+            s += d[w];
+    }
+    return s;
+}
+
+int main() {
+    __shedskin__::__init();
+
+    long long a, b;
+    double told, tnew;
+
+    { timer t; a = bench_int<old_dict<__ss_int, __ss_int> >(); told = t.elapsed(); }
+    { timer t; b = bench_int<new_dict<__ss_int, __ss_int> >(); tnew = t.elapsed(); }
+    if(a != b) { printf("int: result mismatch\n"); return 1; }
+    report("int keys", told, tnew);
+
+    list<str *> *words = make_words();
+    { timer t; a = bench_str<old_dict<str *, __ss_int> >(words); told = t.elapsed(); }
+    { timer t; b = bench_str<new_dict<str *, __ss_int> >(words); tnew = t.elapsed(); }
+    if(a != b) { printf("str: result mismatch\n"); return 1; }
+    report("str keys (counting)", told, tnew);
+
+    return 0;
+}
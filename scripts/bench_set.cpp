@@ -0,0 +1,98 @@
+/* microbenchmark: flat set table vs. the previous std::unordered_set-based __GC_SET
+
+   both tables are driven through the same (find/insert) interface, so they do exactly
+   the same work. build and run (from this directory):
+
+   g++ -O2 -std=c++17 -I../shedskin/lib bench_set.cpp ../shedskin/lib/builtin.cpp -lgc -lgctba -o bench_set
+   ./bench_set
+*/
+
+#include "builtin.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+using namespace __shedskin__;
+
+template <class T>
+using old_set = std::unordered_set<T, ss_hash<T>, ss_eq<T>, gc_allocator< T > >;
+
+template <class T>
+using new_set = __settable<T>;
+
+static const int N = 1000000;
+static const int ROUNDS = 5;
+
+struct timer {
+    std::chrono::steady_clock::time_point t0;
+    timer() : t0(std::chrono::steady_clock::now()) {}
+    double elapsed() { return std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count(); }
+};
+
+static void report(const char *name, double told, double tnew) {
+    printf("%-24s old %8.3fs  new %8.3fs  speedup %5.2fx\n", name, told, tnew, told/tnew);
+}
+
+/* visited-set: contains/add on integer states */
+
+template<class S> static long long bench_visited() {
+    long long s = 0;
+    for(int r=0; r<ROUNDS; r++) {
+        S visited;
+        for(int i=0; i<N; i++) {
+            __ss_int state = (i*31) % (N/2);
+            if(visited.find(state) == visited.end())
+                visited.insert(state);
+            else
+                s++;
+        }
+    }
+    return s;
+}
+
+/* intersection, difference and union of string sets */
+
+template<class S> static long long bench_bulk(list<str *> *a, list<str *> *b) {
+    long long s = 0;
+    S sa, sb;
+    for(str *k : a->units)
+        sa.insert(k);
+    for(str *k : b->units)
+        sb.insert(k);
+    for(int r=0; r<ROUNDS; r++) {
+        S i, d, u(sa);
+        for(str *k : sa)
+            if(sb.find(k) != sb.end())
+                i.insert(k);
+            else
+                d.insert(k);
+        for(str *k : sb)
+            u.insert(k);
+        s += i.size() + d.size() + u.size();
+    }
+    return s;
+}
+
+int main() {
+    __shedskin__::__init();
+
+    long long a, b;
+    double told, tnew;
+
+    { timer t; a = bench_visited<old_set<__ss_int> >(); told = t.elapsed(); }
+    { timer t; b = bench_visited<new_set<__ss_int> >(); tnew = t.elapsed(); }
+    if(a != b) { printf("visited: result mismatch\n"); return 1; }
+    report("int visited-set", told, tnew);
+
+    list<str *> *la = new list<str *>(), *lb = new list<str *>();
+    for(int i=0; i<N/4; i++) {
+        la->append(__str((__ss_int)(i*3)));
+        lb->append(__str((__ss_int)(i*5)));
+    }
+    { timer t; a = bench_bulk<old_set<str *> >(la, lb); told = t.elapsed(); }
+    { timer t; b = bench_bulk<new_set<str *> >(la, lb); tnew = t.elapsed(); }
+    if(a != b) { printf("bulk: result mismatch\n"); return 1; }
+    report("str and/sub/or", told, tnew);
+
+    return 0;
+}
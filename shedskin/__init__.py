@@ -77,7 +77,7 @@ class Shedskin:
         # print(args)
         gx = config.GlobalInfo(args)
 
-        if args.subcmd in ['build', 'run', 'test']:
+        if args.subcmd in ['build', 'run', 'test', 'bench']:
             # ensure cmake is available and installed.
             cmake.check_cmake_availability()
 
@@ -107,6 +107,9 @@ class Shedskin:
                     sys.exit(1)
                 gx.int128 = True
 
+            if args.bigint:
+                gx.bigint = True
+
             if args.float32:
                 gx.float32 = True
 
@@ -116,6 +119,12 @@ class Shedskin:
             if args.nogc:
                 gx.nogc = True
 
+            if args.arena:
+                gx.arena = True
+
+            if args.noescape:
+                gx.noescape = True
+
             if args.nowrap:
                 gx.wrap_around_check = False
 
@@ -125,6 +134,18 @@ class Shedskin:
             if args.noassert:
                 gx.assertions = False
 
+            if args.vtuples:
+                gx.vtuples = True
+
+            if args.intern:
+                gx.intern = True
+
+            if args.nogil:
+                gx.nogil = True
+
+            if args.profile:
+                gx.profile = True
+
             if args.subcmd == 'translate':
                 if args.nomakefile:
                     gx.nomakefile = True
@@ -199,6 +220,10 @@ class Shedskin:
             testrunner = cmake.TestRunner(self.gx.options)
             testrunner.run_tests()
 
+    def bench(self) -> None:
+        benchrunner = cmake.BenchRunner(self.gx.options)
+        benchrunner.run_benchmarks()
+
     def run(self) -> None:
         cwd = pathlib.Path.cwd()
         p = pathlib.Path(self.gx.options.name)
@@ -254,14 +279,21 @@ class Shedskin:
         opt("--int32",              help="Use 32-bit integers", action="store_true")
         opt("--int64",              help="Use 64-bit integers", action="store_true")
         opt("--int128",             help="Use 128-bit integers", action="store_true")
+        opt("--bigint",             help="Use arbitrary-precision integers", action="store_true")
         opt("--float32",            help="Use 32-bit floats", action="store_true")
         opt("--float64",            help="Use 64-bit floats", action="store_true")
 
         opt("--noassert",           help="Disable assert statements", action="store_true")
         opt("-b", "--nobounds",     help="Disable bounds checking", action="store_true")
         opt("--nogc",               help="Disable garbage collection", action="store_true")
+        opt("--arena",              help="Allocate from per-thread memory regions instead of the GC", action="store_true")
+        opt("--noescape",           help="Disable stack allocation of non-escaping objects", action="store_true")
         opt("--nomakefile",         help="Disable makefile generation", action="store_true")
         opt("-w", "--nowrap",             help="Disable wrap-around checking", action="store_true")
+        opt("--vtuples",            help="Return tuples that are unpacked right away by value", action="store_true")
+        opt("--intern",             help="Intern string constants", action="store_true")
+        opt("--nogil",              help="Release the GIL in extension module calls", action="store_true")
+        opt("--profile",            help="Sample and report time spent per function and line", action="store_true")
 
         parser_build = subparsers.add_parser('build', help="translate and build python module (CMake)")
         arg = opt = parser_build.add_argument
@@ -295,6 +327,7 @@ class Shedskin:
         opt("--int32",              help="Use 32-bit integers", action="store_true")
         opt("--int64",              help="Use 64-bit integers", action="store_true")
         opt("--int128",             help="Use 128-bit integers", action="store_true")
+        opt("--bigint",             help="Use arbitrary-precision integers", action="store_true")
         opt("--float32",            help="Use 32-bit floats", action="store_true")
         opt("--float64",            help="Use 64-bit floats", action="store_true")
 
@@ -302,7 +335,13 @@ class Shedskin:
         opt("--nobounds",           help="Disable bounds checking", action="store_true")
         opt("--nowarnings",         help="Disable '-Wall' compilation warnings", action="store_true")
         opt("--nogc",               help="Disable garbage collection", action="store_true")
+        opt("--arena",              help="Allocate from per-thread memory regions instead of the GC", action="store_true")
+        opt("--noescape",           help="Disable stack allocation of non-escaping objects", action="store_true")
         opt("--nowrap",             help="Disable wrap-around checking", action="store_true")
+        opt("--vtuples",            help="Return tuples that are unpacked right away by value", action="store_true")
+        opt("--intern",             help="Intern string constants", action="store_true")
+        opt("--nogil",              help="Release the GIL in extension module calls", action="store_true")
+        opt("--profile",            help="Sample and report time spent per function and line", action="store_true")
 
         parser_run = subparsers.add_parser('run', help="translate, build and run module (CMake)")
         arg = opt = parser_run.add_argument
@@ -336,14 +375,21 @@ class Shedskin:
         opt("--int32",              help="Use 32-bit integers", action="store_true")
         opt("--int64",              help="Use 64-bit integers", action="store_true")
         opt("--int128",             help="Use 128-bit integers", action="store_true")
+        opt("--bigint",             help="Use arbitrary-precision integers", action="store_true")
         opt("--float32",            help="Use 32-bit floats", action="store_true")
         opt("--float64",            help="Use 64-bit floats", action="store_true")
 
         opt("--noassert",           help="Disable assert statements", action="store_true")
         opt("--nobounds",           help="Disable bounds checking", action="store_true")
         opt("--nogc",               help="Disable garbage collection", action="store_true")
+        opt("--arena",              help="Allocate from per-thread memory regions instead of the GC", action="store_true")
+        opt("--noescape",           help="Disable stack allocation of non-escaping objects", action="store_true")
         opt("--nowarnings",         help="Disable '-Wall' compilation warnings", action="store_true")
         opt("--nowrap",             help="Disable wrap-around checking", action="store_true")
+        opt("--vtuples",            help="Return tuples that are unpacked right away by value", action="store_true")
+        opt("--intern",             help="Intern string constants", action="store_true")
+        opt("--nogil",              help="Release the GIL in extension module calls", action="store_true")
+        opt("--profile",            help="Sample and report time spent per function and line", action="store_true")
 
         parser_test = subparsers.add_parser('test', help="run tests")
         arg = opt = parser_test.add_argument
@@ -379,12 +425,30 @@ class Shedskin:
         opt("-c", "--cfg",        help="Add a cmake option '-D' prefix not needed", nargs='*', metavar="CMAKE_OPT")
         opt("--nowarnings",       help="Disable '-Wall' compilation warnings", action="store_true")
 
+        parser_bench = subparsers.add_parser('bench', help="benchmark examples")
+        arg = opt = parser_bench.add_argument
+
+        opt('--include',          help='provide regex of examples to include', metavar="PATTERN")
+        opt('--repeat',           help="run each example N times (default: %(default)s)", metavar="N", type=int, default=3)
+        opt('--timeout',          help="kill example after S seconds (default: %(default)s)", metavar="S", type=float, default=600)
+        opt('--baseline',         help="baseline json file (default: '%(default)s')", metavar="FILE", default="bench.json")
+        opt('--threshold',        help="flag regressions above PCT percent (default: %(default)s)", metavar="PCT", type=float, default=10)
+        opt('--update',           help='write results to baseline', action='store_true')
+
+        opt("--generator",        help="specify a cmake build system generator", metavar="G")
+        opt("--jobs",             help="build in parallel using N jobs", metavar="N", type=int)
+        opt("--build-type",       help="set cmake build type (default: '%(default)s')", metavar="T", default="Release")
+        opt("--reset",            help="reset cmake build", action="store_true")
+        opt("--conan",            help="install cmake dependencies with conan", action="store_true")
+        opt("--spm",              help="install cmake dependencies with spm", action="store_true")
+        opt("--extproject",       help="install cmake dependencies with externalproject", action="store_true")
+
         # make 'translate' the default subparser
         for _arg in sys.argv[1:]:
             if _arg in ('-h', '--help'):
                 break
         else:
-            if len(sys.argv) > 1 and sys.argv[1] not in ('analyze', 'translate', 'build', 'run', 'test'):
+            if len(sys.argv) > 1 and sys.argv[1] not in ('analyze', 'translate', 'build', 'run', 'test', 'bench'):
                 sys.argv.insert(1, 'translate')
 
         args = parser.parse_args(args=bypassargs)
@@ -408,6 +472,9 @@ class Shedskin:
         if args.subcmd == 'test':
             ss.test()
 
+        if args.subcmd == 'bench':
+            ss.bench()
+
         if args.subcmd == 'run':
             ss.build()
             ss.run()
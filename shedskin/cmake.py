@@ -5,10 +5,12 @@
 """
 import argparse
 import glob
+import json
 import logging
 import os
 import pathlib
 import platform
+import re
 import shutil
 import subprocess
 import sys
@@ -79,22 +81,22 @@ class ConanBDWGC:
 
 
 class ConanPCRE:
-    """conan pcre dependency"""
+    """conan pcre2 dependency"""
 
     def __init__(
         self,
-        name: str = "pcre",
-        version: str ="8.45",
-        build_pcrecpp: bool = True,
-        build_pcregrep: bool =False,
+        name: str = "pcre2",
+        version: str ="10.42",
+        build_pcre2grep: bool =False,
+        support_jit: bool = True,
         shared: bool =False,
         with_bzip2: bool =False,
         with_zlib: bool =False,
     ):
         self.name = name
         self.version = version
-        self.build_pcrecpp = build_pcrecpp
-        self.build_pcregrep = build_pcregrep
+        self.build_pcre2grep = build_pcre2grep
+        self.support_jit = support_jit
         self.shared = shared
         self.with_bzip2 = with_bzip2
         self.with_zlib = with_zlib
@@ -131,11 +133,11 @@ class ConanDependencyManager:
         bdwgc:gcj_support={bdwgc.gcj_support}
         bdwgc:java_finalization={bdwgc.java_finalization}
         bdwgc:shared={bdwgc.shared}
-        pcre:build_pcrecpp={pcre.build_pcrecpp}
-        pcre:build_pcregrep={pcre.build_pcregrep}
-        pcre:shared={pcre.shared}
-        pcre:with_bzip2={pcre.with_bzip2}
-        pcre:with_zlib={pcre.with_zlib}
+        pcre2:build_pcre2grep={pcre.build_pcre2grep}
+        pcre2:support_jit={pcre.support_jit}
+        pcre2:shared={pcre.shared}
+        pcre2:with_bzip2={pcre.with_bzip2}
+        pcre2:with_zlib={pcre.with_zlib}
         """
         )
         conanfile = self.source_dir / "conanfile.txt"
@@ -212,9 +214,9 @@ class ShedskinDependencyManager:
         """check if required targets exist"""
         libgc = self.lib_dir / f"libgc{self.lib_suffix}"
         libgccpp = self.lib_dir / f"libgccpp{self.lib_suffix}"
-        libpcre = self.lib_dir / f"libgccpp{self.lib_suffix}"
+        libpcre = self.lib_dir / f"libpcre2-8{self.lib_suffix}"
         gc_h = self.include_dir / "gc.h"
-        pcre_h = self.include_dir / "pcre.h"
+        pcre_h = self.include_dir / "pcre2.h"
 
         targets = [libgc, libgccpp, libpcre, gc_h, pcre_h]
         return all(t.exists() for t in targets)
@@ -307,26 +309,26 @@ class ShedskinDependencyManager:
     #         self.cmake_install(pcre_build)
 
     def install_pcre(self) -> None:
-        """download / build / install pcre"""
-        pcre_repo = "https://github.com/luvit/pcre.git"
-        pcre_src = self.src_dir / 'pcre'
+        """download / build / install pcre2"""
+        pcre_repo = "https://github.com/PCRE2Project/pcre2.git"
+        pcre_src = self.src_dir / 'pcre2'
         pcre_build =  pcre_src / "build"
-        print("download / build / install pcre")
-        self.git_clone(pcre_repo, pcre_src)
+        print("download / build / install pcre2")
+        self.git_clone(pcre_repo, pcre_src, branch="pcre2-10.42")
         pcre_build.mkdir(parents=True, exist_ok=True)
         self.cmake_generate(
             pcre_src,
             pcre_build,
             prefix=self.deps_dir,
             BUILD_SHARED_LIBS=False,
-            PCRE_BUILD_PCREGREP=False,
-            PCRE_BUILD_PCRECPP=True,
-            PCRE_SUPPORT_LIBREADLINE=False,
-            PCRE_SUPPORT_LIBEDIT=False,
-            PCRE_SUPPORT_LIBZ=False,
-            PCRE_SUPPORT_LIBBZ2=False,
-            PCRE_BUILD_TESTS=False,
-            PCRE_SHOW_REPORT=False,
+            PCRE2_SUPPORT_JIT=True,
+            PCRE2_BUILD_PCRE2GREP=False,
+            PCRE2_SUPPORT_LIBREADLINE=False,
+            PCRE2_SUPPORT_LIBEDIT=False,
+            PCRE2_SUPPORT_LIBZ=False,
+            PCRE2_SUPPORT_LIBBZ2=False,
+            PCRE2_BUILD_TESTS=False,
+            PCRE2_SHOW_REPORT=False,
         )
         self.cmake_build(pcre_build)
         self.cmake_install(pcre_build)
@@ -380,7 +382,7 @@ def add_shedskin_product(
     """
 
     if extra_lib_dir:
-        cmdline_options = '-X' + extra_lib_dir
+        cmdline_options = ' '.join(filter(None, [cmdline_options, '-X' + extra_lib_dir]))
         include_dirs = [extra_lib_dir]
 
     def mk_add(lines: list[str], spaces: int = 4) -> Callable[[int, str], None]:
@@ -500,6 +502,8 @@ def generate_cmakefile(gx: config.GlobalInfo) -> None:
         compile_options.append("-D__SS_INT64")
     if gx.int128:
         compile_options.append("-D__SS_INT128")
+    if gx.bigint:
+        compile_options.append("-D__SS_BIGINT")
     if gx.float32:
         compile_options.append("-D__SS_FLOAT32")
     if gx.float64:
@@ -516,8 +520,31 @@ def generate_cmakefile(gx: config.GlobalInfo) -> None:
         compile_options.append("-D__SS_BACKTRACE -rdynamic -fno-inline")
     if gx.nogc:
         compile_options.append("-D__SS_NOGC")
+    if gx.arena:
+        compile_options.append("-D__SS_ARENA")
+    if gx.nogil:
+        compile_options.append("-D__SS_THREADS -pthread")
+    if gx.profile:
+        compile_options.append("-D__SS_PROFILE")
     compile_opts = ' '.join(compile_options)
 
+    cmdline_options = []
+    if gx.vtuples:
+        cmdline_options.append("--vtuples")
+    if gx.intern:
+        cmdline_options.append("--intern")
+    if gx.nogil:
+        cmdline_options.append("--nogil")
+    if gx.profile:
+        cmdline_options.append("--profile")
+    if gx.noescape:
+        cmdline_options.append("--noescape")
+    if gx.arena:
+        cmdline_options.append("--arena")
+    if gx.bigint:
+        cmdline_options.append("--bigint")
+    cmdline_opts = ' '.join(cmdline_options)
+
     for module in modules:
         if module.builtin and module.filename.is_relative_to(gx.shedskin_lib):
             entry = module.filename.relative_to(gx.shedskin_lib)
@@ -553,6 +580,7 @@ def generate_cmakefile(gx: config.GlobalInfo) -> None:
                 link_libs=gx.options.link_libs,
                 extra_lib_dir=gx.options.extra_lib,
                 compile_options=compile_opts,
+                cmdline_options=cmdline_opts,
             ),
         )
         master_clfile.write_text(master_clfile_content)
@@ -572,6 +600,7 @@ def generate_cmakefile(gx: config.GlobalInfo) -> None:
                 link_libs=gx.options.link_libs,
                 extra_lib_dir=gx.options.extra_lib,
                 compile_options=compile_opts,
+                cmdline_options=cmdline_opts,
             )
         )
 
@@ -851,3 +880,213 @@ class TestRunner(CMakeBuilder):
         self.build_dir = pathlib.Path("build")
         self.tests = sorted(glob.glob("./test_*/test_*.py", recursive=True))
         self.log = logging.getLogger(self.__class__.__name__)
+
+
+# pinned command-line arguments for benchmarking examples (default: none)
+BENCH_ARGS = {
+    "bh": ["-b", "5000", "-m"],
+    "neural1": ["--test"],
+    "solitaire": ["-test"],
+}
+
+# interactive examples or servers, which cannot be benchmarked
+BENCH_SKIP = {"go", "msp_ss", "othello", "rdb", "voronoi2", "webserver"}
+
+# metrics compared against the baseline, with a noise floor below which differences are ignored
+BENCH_METRICS = [
+    ("compile_time", "compile (s)", 1.0),
+    ("wall_time", "wall (s)", 0.05),
+    ("max_rss", "max rss (KB)", 1024),
+]
+
+
+class BenchRunner(CMakeBuilder):
+    """benchmark runner for the examples"""
+
+    def __init__(self, options: argparse.Namespace):
+        self.options = options
+        self.source_dir = pathlib.Path.cwd()
+        self.build_dir = pathlib.Path("build")
+        self.bench_dir = self.build_dir / "bench"
+        self.log = logging.getLogger(self.__class__.__name__)
+
+    def get_examples(self) -> List[str]:
+        """returns names of examples added in CMakeLists.txt, except those to skip"""
+        examples = []
+        with open(self.source_dir / "CMakeLists.txt", encoding="utf8") as fopen:
+            for line in fopen:
+                match = re.match(r"\s*add_subdirectory\((\w+)\)", line)
+                if match and match.group(1) not in BENCH_SKIP:
+                    examples.append(match.group(1))
+        if self.options.include:
+            examples = [e for e in examples if re.search(self.options.include, e)]
+        return examples
+
+    def get_executable(self, name: str) -> Optional[pathlib.Path]:
+        """returns path of built executable, if any"""
+        for path in [self.build_dir / name / name, self.build_dir / name / self.options.build_type / f"{name}.exe"]:
+            if path.is_file():
+                return path.absolute()
+        return None
+
+    def compile(self, name: str) -> Optional[float]:
+        """build example from scratch, returning elapsed time (translation included)"""
+        opts = f"--parallel {self.options.jobs}" if self.options.jobs else ""
+        if platform.system() == 'Windows':
+            opts += f" --config {self.options.build_type}"
+        bld_cmd = f"cmake --build {self.build_dir} --target {name}-exe {opts}"
+        self.log.info(bld_cmd)
+        t0 = time.time()
+        result = subprocess.run(bld_cmd, shell=True, stdout=subprocess.DEVNULL)
+        if result.returncode != 0:
+            return None
+        return time.time() - t0
+
+    def execute(self, name: str, executable: pathlib.Path) -> Optional[dict]:
+        """run example once, returning wall time, max rss (KB) and gc statistics"""
+        stats = (self.bench_dir / f"{name}.stats.json").absolute()
+        if stats.exists():
+            stats.unlink()
+        env = dict(os.environ, SHEDSKIN_STATS=str(stats))
+
+        cmd = [str(executable)] + BENCH_ARGS.get(name, [])
+        t0 = time.time()
+        try:
+            subprocess.run(cmd, cwd=self.bench_dir, env=env, stdin=subprocess.DEVNULL,
+                           stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL,
+                           timeout=self.options.timeout, check=True)
+        except (subprocess.CalledProcessError, subprocess.TimeoutExpired):
+            return None
+        wall_time = time.time() - t0
+
+        result = {"wall_time": wall_time, "max_rss": None, "gc": None}
+        if stats.exists():  # written by the runtime at exit
+            result.update(json.loads(stats.read_text()))
+        return result
+
+    def compare(self, results: dict, baseline: dict) -> List[str]:
+        """print results next to baseline, and return regressions"""
+        threshold = self.options.threshold / 100
+        regressions = []
+        print(f"\n{'example':<16}" + "".join(f"{label:>26}" for _, label, _ in BENCH_METRICS))
+        for name, result in results.items():
+            old = baseline.get(name, {})
+            line = f"{name:<16}"
+            for metric, _, floor in BENCH_METRICS:
+                new_value, old_value = result.get(metric), old.get(metric)
+                if new_value is None:
+                    line += f"{'-':>26}"
+                    continue
+                cell = f"{new_value:.2f}" if isinstance(new_value, float) else str(new_value)
+                if old_value:
+                    change = (new_value - old_value) / old_value
+                    cell += f" ({change:+.1%})"
+                    if change > threshold and new_value - old_value > floor:
+                        regressions.append(f"{name}: {metric} {old_value:.2f} -> {new_value:.2f} ({change:+.1%})")
+                        cell = f"{RED}{cell:>26}{RESET}"
+                line += f"{cell:>26}"
+            print(line)
+        return regressions
+
+    def run_benchmarks(self) -> None:
+        """build and run examples, comparing against (or saving) a baseline"""
+        start_time = time.time()
+
+        cfg_options = [
+            "-DBUILD_EXECUTABLE=ON",
+            "-DBUILD_TEST=OFF",
+            f"-DCMAKE_BUILD_TYPE={self.options.build_type}",
+        ]
+        if self.options.generator:
+            cfg_options.append(f"-G{self.options.generator}")
+        if self.options.conan:
+            cfg_options.append("-DENABLE_CONAN=ON")
+        elif self.options.spm:
+            cfg_options.append("-DENABLE_SPM=ON")
+        elif self.options.extproject:
+            cfg_options.append("-DENABLE_EXTERNAL_PROJECT=ON")
+
+        if self.build_dir.exists() and self.options.reset:
+            self.rm_build()
+        self.mkdir_build()
+        if self.options.conan:
+            dpm = ConanDependencyManager(self.source_dir)
+            dpm.generate_conanfile()
+            dpm.install()
+        elif self.options.spm:
+            spm = ShedskinDependencyManager(self.source_dir)
+            spm.install_all()
+
+        self.cmake_config(cfg_options)
+        self.cmake_build(["--target clean"])
+
+        # run examples in a scratch directory, as some write output files
+        os.makedirs(self.bench_dir, exist_ok=True)
+        testdata = self.source_dir / "testdata"
+        if testdata.is_dir() and not (self.bench_dir / "testdata").exists():
+            shutil.copytree(testdata, self.bench_dir / "testdata")
+
+        results = {}
+        failures = []
+        for name in self.get_examples():
+            compile_time = self.compile(name)
+            executable = self.get_executable(name)
+            if compile_time is None or executable is None:
+                print(f"*** {RED}BUILD FAILURE{RESET}: {name}")
+                failures.append(name)
+                continue
+
+            runs = []
+            for _ in range(self.options.repeat):
+                run = self.execute(name, executable)
+                if run is None:
+                    break
+                runs.append(run)
+            if len(runs) < self.options.repeat:
+                print(f"*** {RED}FAILURE{RESET}: {name}")
+                failures.append(name)
+                continue
+
+            wall_times = sorted(run["wall_time"] for run in runs)
+            rss = [run["max_rss"] for run in runs if run["max_rss"] is not None]
+            results[name] = {
+                "args": BENCH_ARGS.get(name, []),
+                "compile_time": compile_time,
+                "wall_time": wall_times[len(wall_times) // 2],
+                "wall_times": wall_times,
+                "max_rss": max(rss) if rss else None,
+                "gc": runs[-1]["gc"],
+            }
+            print(f"*** {GREEN}DONE{RESET}: {name} ({results[name]['wall_time']:.2f} s)")
+
+        baseline_path = pathlib.Path(self.options.baseline)
+        baseline = {}
+        if baseline_path.exists():
+            baseline = json.loads(baseline_path.read_text()).get("examples", {})
+        regressions = self.compare(results, baseline)
+
+        if self.options.update or not baseline_path.exists():
+            data = {
+                "platform": platform.platform(),
+                "repeat": self.options.repeat,
+                "build_type": self.options.build_type,
+                "examples": dict(baseline, **results) if self.options.include else results,
+            }
+            baseline_path.write_text(json.dumps(data, indent=4) + "\n")
+            print(f"\nbaseline written to {baseline_path}")
+
+        if failures:
+            print(f"==> {RED}FAILED TO BUILD OR RUN:{RESET}", " ".join(failures))
+        if regressions:
+            print(f"==> {RED}REGRESSIONS (> {self.options.threshold}%):{RESET}")
+            for regression in regressions:
+                print("   ", regression)
+        else:
+            print(f"==> {GREEN}NO REGRESSIONS{RESET}")
+
+        end_time = time.time()
+        elapsed_time = time.strftime("%H:%M:%S", time.gmtime(end_time - start_time))
+        print(f"Total time: {elapsed_time}\n")
+
+        if failures or (regressions and not self.options.update):
+            sys.exit(1)
@@ -81,16 +81,23 @@ class GlobalInfo:  # XXX add comments, split up
         self.int32: bool = False
         self.int64: bool = False
         self.int128: bool = False
+        self.bigint: bool = False
         self.float32: bool = False
         self.float64: bool = False
         self.flags: Optional[Path] = None
         self.silent: bool = False
         self.nogc: bool = False
+        self.arena: bool = False
         self.backtrace: bool = False
         self.makefile_name: str = "Makefile"
         self.debug_level: int = 0
         self.outputdir: Optional[str] = None
         self.nomakefile: bool = False
+        self.vtuples: bool = False
+        self.noescape: bool = False
+        self.intern: bool = False
+        self.nogil: bool = False
+        self.profile: bool = False
 
         # Others
         self.item_rvalue: dict[ast.AST, ast.AST] = {}
@@ -98,8 +105,11 @@ class GlobalInfo:  # XXX add comments, split up
         self.bool_test_only: set[ast.AST] = set()
         self.called: set[ast.Attribute] = set()
         self.tempcount: dict[Any, str] = {}
-        self.struct_unpack: dict[ast.Assign, Tuple[List[Tuple[str, str, str, int]], str, str]] = {}
+        self.struct_unpack: dict[Union[ast.Assign, ast.For], Tuple[List[Tuple[str, str, str, int]], str, str, Optional[ast.AST]]] = {}
         self.augment: set[ast.AST] = set()
+        self.vtuple_funcs: set['python.Function'] = set()
+        self.vtuple_assigns: set[ast.Assign] = set()
+        self.stack_allocs: dict[ast.FunctionDef, List[ast.AST]] = {}
 
         self.maxhits = 0  # XXX amaze.py termination
         self.terminal = None
@@ -118,6 +118,8 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.name = module.ident
         self.filling_consts = False
         self.with_count = 0
+        self.profile_func: Optional['python.Function'] = None
+        self.stack_vars: dict[ast.AST, Tuple[str, str]] = {}
         self.bool_wrapper: dict['ast.AST', bool] = {}
         self.namer = CPPNamer(self.gx, self)
         self.extmod = extmod.ExtensionModule(self.gx, self)
@@ -862,6 +864,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         self.output("public:")
         self.indent()
         self.class_variables(cl)
+        self.gc_layout(cl)
 
         # --- constructor
         need_init = False
@@ -961,23 +964,53 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.print()
 
         # --- instance variables
+        for var in self.instance_variables(cl):
+            self.output(
+                typestr.nodetypestr(self.gx, var, cl, mv=self.mv)
+                + self.cpp_name(var)
+                + ";"
+            )
+
+        if [v for v in cl.vars if not v.startswith("__")]:
+            self.print()
+
+    def instance_variables(self, cl: 'python.Class') -> List['python.Variable']:
+        result = []
         for var in cl.vars.values():
             if var.invisible:
                 continue  # var.name in cl.virtualvars: continue
-            # var is masked by ancestor var
+            # var is masked by (declared) ancestor var
             vars : set[str] = set()
             for ancestor in cl.ancestors():
-                vars.update(ancestor.vars)
+                vars.update(
+                    name
+                    for name, avar in ancestor.vars.items()
+                    if avar in self.gx.merged_inh and self.gx.merged_inh[avar]
+                )
             if var.name in vars:
                 continue
             if var in self.gx.merged_inh and self.gx.merged_inh[var]:
-                self.output(
-                    typestr.nodetypestr(self.gx, var, cl, mv=self.mv)
-                    + self.cpp_name(var)
-                    + ";"
-                )
+                result.append(var)
+        return result
 
-        if [v for v in cl.vars if not v.startswith("__")]:
+    def gc_layout(self, cl: 'python.Class') -> None:
+        # --- precise GC descriptor, so scalar instance variables are not scanned
+        names: List[str] = []
+        ancestor: Optional['python.Class'] = cl
+        while ancestor and not ancestor.mv.module.builtin:
+            if len(ancestor.bases) > 1:
+                return
+            for var in self.instance_variables(ancestor):
+                if typestr.unboxable(self.gx, self.gx.merged_inh[var]):
+                    names.append(self.cpp_name(var))
+            ancestor = ancestor.bases[0] if ancestor.bases else None
+
+        if names:
+            clname = self.cpp_name(cl)
+            self.output(
+                "__SS_GC_TYPED(%s, %s)"
+                % (clname, ".".join("member(&%s::%s)" % (clname, name) for name in names))
+            )
             self.print()
 
     def nothing(self, types: Types) -> str:
@@ -1038,7 +1071,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         if ts.startswith("pyseq") or ts.startswith("pyiter"):  # XXX
             argtypes = self.gx.merged_inh[node]
         ts = typestr.typestr(self.gx, argtypes, mv=self.mv)
-        self.append("(new " + ts[:-2] + "(")
+        self.append(self.new(node, ts))
         return argtypes
 
     def visit_Dict(self, node: ast.Dict, func:Optional['python.Function']=None, argtypes:Optional[Types]=None) -> None:
@@ -1319,6 +1352,13 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         return not [t for t in self.mergeinh[node] if t[0] not in classes]
 
     def visit_For(self, node: ast.For, func:Optional['python.Function']=None) -> None:
+        if node in self.gx.struct_unpack:
+            self.print()
+            if node.orelse:
+                self.output("%s = 0;" % self.mv.tempcount[node.orelse[0]])
+            self.struct_iter_unpack_cpp(node, func)
+            self.print()
+            return
         if isinstance(node.target, ast.Name):
             assname = node.target.id
         elif ast_utils.is_assign_attribute(node.target):
@@ -1509,6 +1549,21 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             )
         self.print()
 
+    def vtuple_types(self, func: 'python.Function') -> List[Types]:
+        assert func.retnode
+        rettypes = self.mergeinh[func.retnode.thing]
+        arity = len(func.returnexpr[0].elts)  # type: ignore[attr-defined]
+        if self.bin_tuple(rettypes):
+            return [self.subtypes(rettypes, "first"), self.subtypes(rettypes, "second")]
+        return arity * [self.subtypes(rettypes, "unit")]
+
+    def vtuple_typestr(self, func: 'python.Function') -> str:
+        elems = [
+            typestr.typestr(self.gx, types, mv=self.mv).strip()
+            for types in self.vtuple_types(func)
+        ]
+        return "__vtuple<%s>" % ", ".join(elems)
+
     # --- function/method header
     def func_header(self, func: 'python.Function', declare: bool, is_init: bool = False) -> None:
         method = isinstance(func.parent, python.Class)
@@ -1532,6 +1587,8 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             pass
         elif func.ident in ["__hash__"]:
             header += "long "  # XXX __ss_int leads to problem with virtual parent
+        elif func in self.gx.vtuple_funcs:
+            header += self.vtuple_typestr(func) + " "
         elif func.returnexpr:
             assert func.retnode
             header += typestr.nodetypestr(
@@ -1647,12 +1704,19 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
 
         # --- local declarations
         self.local_defs(func)
+        self.stack_defs(node)
+
+        # --- profiling frame (--profile)
+        if self.gx.profile:
+            self.output('__SS_PROFILE_FUNC("%s", "%s", %d);' % (self.profile_name(func), self.module.relative_filename.as_posix(), getattr(node, 'lineno', 0)))
+            self.profile_func = func
 
         # --- function body
         for child in node.body:
             self.visit(child, func)
         if func.fakeret:
             self.visit(func.fakeret, func)
+        self.profile_func = None
 
         # --- add Return(None) (sort of) if function doesn't already end with a Return
         if node.body:
@@ -1663,13 +1727,34 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 and not isinstance(lastnode, ast.Return)
             ):
                 assert func.retnode
-                self.output(
-                    "return %s;" % self.nothing(self.mergeinh[func.retnode.thing])
-                )
+                if func in self.gx.vtuple_funcs:
+                    self.output("return %s();" % self.vtuple_typestr(func))
+                else:
+                    self.output(
+                        "return %s;" % self.nothing(self.mergeinh[func.retnode.thing])
+                    )
 
         self.deindent()
         self.output("}\n")
 
+    def profile_name(self, func: 'python.Function') -> str:
+        if func.lambdanr is not None:
+            return '<lambda>'
+        if isinstance(func.parent, python.Class):
+            return func.parent.ident + '.' + func.ident
+        return func.ident
+
+    def visit(self, node: ast.AST, *args: Any) -> None:
+        # record current line for the profiler (--profile)
+        if (
+            self.profile_func
+            and isinstance(node, ast.stmt)
+            and args and args[0] is self.profile_func
+            and hasattr(node, 'lineno')
+        ):
+            self.output("__SS_PROFILE_LINE(%d);" % node.lineno)
+        ast_utils.BaseNodeVisitor.visit(self, node, *args)
+
     def generator_ident(self, func: 'python.Function') -> str:  # XXX merge?
         if func.parent:
             return func.parent.ident + "_" + func.ident
@@ -2428,6 +2513,15 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 warning=True,
                 mv=self.mv,
             )
+        for method in ("unpack", "unpack_from", "iter_unpack"):
+            if self.library_func(funcs, "struct", "Struct", method):
+                error.error(
+                    "unsupported use of Struct.%s: use '%s', with s a (local or global) variable assigned once from struct.Struct(<constant format>)" % (
+                        method, "for a, .. in s.iter_unpack(..)" if method == "iter_unpack" else "a, .. = s.%s(..)" % method),
+                    self.gx,
+                    node,
+                    mv=self.mv,
+                )
         if self.library_func(funcs, "array", "array", "__init__"):
             if (
                 not node.args
@@ -2445,7 +2539,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             if (
                 struct.calcsize("P") == 8
                 and struct.calcsize("i") == 4
-                and not (self.gx.int64 or self.gx.int128)
+                and not (self.gx.int64 or self.gx.int128 or self.gx.bigint)
             ):
                 error.error(
                     "return value of 'id' does not fit in 32-bit integer (try shedskin --int64)",
@@ -2455,6 +2549,9 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                     mv=self.mv,
                 )
 
+        if self.array_reduction_cpp(node, funcs, func):
+            return
+
         nrargs = len(node.args)
         if isinstance(func, python.Function) and func.largs:
             nrargs = func.largs
@@ -2481,7 +2578,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                     if ts.startswith("pyseq") or ts.startswith("pyiter"):  # XXX
                         argtypes = self.gx.merged_inh[node]
                         ts = typestr.typestr(self.gx, argtypes, mv=self.mv)
-                self.append("(new " + ts[:-2] + "(")
+                self.append(self.new(node, ts))
             if funcs and len(funcs[0].formals) == 1 and not funcs[0].mv.module.builtin:
                 self.append("1")  # don't call default constructor
 
@@ -2529,7 +2626,7 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 self.power(node.args[0], node.args[1], third, func)
                 return
             elif ident == "hash":
-                self.append("hasher(")  # XXX cleanup
+                self.append("__ss_hash(")
             elif ident == "__print":  # XXX
                 if not node.keywords:
                     self.append('print(')
@@ -2704,6 +2801,8 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             if self.library_func(funcs, "itertools", None, itertools_func):
                 castnull = True
                 break
+        if self.library_func(funcs, "collections", "deque", "__init__"):
+            castnull = True
 
         for f in funcs:
             if len(f.formals) != len(target.formals):
@@ -2897,6 +2996,16 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         assert node.value # added in graph.py
         assert func
         assert func.retnode
+        if func in self.gx.vtuple_funcs:
+            assert isinstance(node.value, ast.Tuple)
+            self.append(self.vtuple_typestr(func) + "(")
+            for i, (elt, types) in enumerate(zip(node.value.elts, self.vtuple_types(func))):
+                if i > 0:
+                    self.append(", ")
+                self.impl_visit_conv(elt, types, func)
+            self.append(")")
+            self.eol()
+            return
         self.impl_visit_conv(node.value, self.mergeinh[func.retnode.thing], func)
         self.eol()
 
@@ -2997,9 +3106,26 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
     def struct_unpack_cpp(self, node:ast.Assign, func:Optional['python.Function']) -> bool:
         struct_unpack = self.gx.struct_unpack.get(node)
         if struct_unpack:
-            sinfo, tvar, tvar_pos = struct_unpack
+            sinfo, tvar, tvar_pos, struct_obj = struct_unpack
             self.start()
             assert isinstance(node.value, ast.Call)
+            assert isinstance(node.targets[0], (ast.List, ast.Tuple))
+            if struct_obj:
+                self.mv.struct_object(struct_obj, func)  # check again, now that all assignments are known
+                assert isinstance(node.value.func, ast.Attribute)
+                args = node.value.args
+                self.visitm(tvar, " = ", args[0], func)
+                self.eol()
+                self.start()
+                if node.value.func.attr == "unpack_from":
+                    offset: Union[str, ast.AST] = args[1] if len(args) > 1 else "0"
+                    self.visitm(tvar_pos, " = ", struct_obj, "->unpack_from_start(", tvar, ", ", offset, ")", func)
+                else:
+                    self.visitm(tvar_pos, " = ", struct_obj, "->unpack_start(", tvar, ")", func)
+                self.eol()
+                self.struct_unpack_items(node.targets[0], sinfo, struct_obj, tvar, tvar_pos, func)
+                return True
+
             self.visitm(tvar, " = ", node.value.args[1], func)
             self.eol()
             if len(node.value.args) > 2: # TODO unpack_from: nicer check
@@ -3023,22 +3149,125 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 if c == "x" or (d == 0 and c != "s"):
                     self.visitm(expr, func)
                 else:
-                    assert isinstance(node.targets[0], (ast.List, ast.Tuple))
                     n = list(node.targets[0].elts)[hop]
                     hop += 1
-                    if isinstance(n, ast.Subscript):  # XXX merge
-                        self.subs_assign(n, func)
-                        self.visitm(expr, ")", func)
-                    elif isinstance(n, ast.Name):
-                        self.visitm(n, " = ", expr, func)
-                    elif ast_utils.is_assign_attribute(n):
-                        assert isinstance(n, ast.Attribute)
-                        self.visit_Attribute(n, func)
-                        self.visitm(" = ", expr, func)
+                    self.struct_unpack_item(n, expr, func)
                 self.eol()
             return True
         return False
 
+    def struct_unpack_item(self, n: ast.AST, expr: Union[str, ast.AST, List[Union[str, ast.AST]]], func: Optional['python.Function']) -> None:
+        exprs = expr if isinstance(expr, list) else [expr]
+        if isinstance(n, ast.Subscript):  # XXX merge
+            self.subs_assign(n, func)
+            self.visitm(*exprs, ")", func)
+        elif isinstance(n, ast.Name):
+            self.visitm(n, " = ", *exprs, func)
+        elif ast_utils.is_assign_attribute(n):
+            assert isinstance(n, ast.Attribute)
+            self.visit_Attribute(n, func)
+            self.visitm(" = ", *exprs, func)
+
+    def struct_unpack_items(self, target: Union[ast.List, ast.Tuple], sinfo: List[Tuple[str, str, str, int]], struct_obj: ast.AST, tvar: str, tvar_pos: str, func: Optional['python.Function']) -> None:
+        """a, b, .. = s.unpack(..): one read per value, using the item plan of s"""
+        hop = 0
+        for o, c, t, d in sinfo:
+            if c == "x" or (d == 0 and c != "s"):
+                continue
+            self.start()
+            n = list(target.elts)[hop]
+            self.struct_unpack_item(n, [struct_obj, "->unpack_%s(%d, %s, %s)" % (t, hop, tvar, tvar_pos)], func)
+            hop += 1
+            self.eol()
+
+    def struct_iter_unpack_cpp(self, node: ast.For, func: Optional['python.Function']) -> None:
+        sinfo, tvar, tvar_pos, struct_obj = self.gx.struct_unpack[node]
+        assert struct_obj and isinstance(node.iter, ast.Call)
+        self.mv.struct_object(struct_obj, func)  # check again, now that all assignments are known
+        assert isinstance(node.target, (ast.List, ast.Tuple))
+        self.start()
+        self.visitm(tvar, " = ", node.iter.args[0], func)
+        self.eol()
+        self.start("for (")
+        self.visitm(tvar_pos, " = ", struct_obj, "->iter_unpack_start(", tvar, "); ", tvar_pos, " < len(", tvar, "); ", tvar_pos, " += ", struct_obj, "->size) {", func)
+        self.print(self.line)
+        self.indent()
+        self.struct_unpack_items(node.target, sinfo, struct_obj, tvar, tvar_pos, func)
+        self.forbody(node, None, "", func, True, False)
+
+    def is_array(self, node: ast.AST) -> bool:
+        types = self.mergeinh.get(node)
+        return bool(types) and all(
+            isinstance(t[0], python.Class)
+            and t[0].mv.module.ident == "array"
+            and t[0].ident == "array"
+            for t in types
+        )
+
+    def array_reduction_cpp(self, node: ast.Call, funcs: List['python.Function'], func: Optional['python.Function']) -> bool:
+        """route sum/min/max over an array (or a generator over one), and sums
+        of products over two zipped arrays, to the array kernels"""
+        for ident in ("sum", "min", "max"):
+            if self.library_func(funcs, "builtin", None, ident):
+                break
+        else:
+            return False
+        if len(node.args) != 1 or node.keywords:
+            return False
+
+        arg = node.args[0]
+        if isinstance(arg, (ast.GeneratorExp, ast.ListComp)):
+            if len(arg.generators) != 1 or arg.generators[0].ifs:
+                return False
+            gen = arg.generators[0]
+            target, elt = gen.target, arg.elt
+
+            # sum(x for x in a)
+            if (
+                isinstance(target, ast.Name)
+                and isinstance(elt, ast.Name)
+                and elt.id == target.id
+            ):
+                arg = gen.iter
+
+            # sum(x * y for x, y in zip(a, b))
+            elif (
+                ident == "sum"
+                and isinstance(target, ast.Tuple)
+                and len(target.elts) == 2
+                and all(isinstance(e, ast.Name) for e in target.elts)
+                and isinstance(elt, ast.BinOp)
+                and isinstance(elt.op, ast.Mult)
+                and isinstance(elt.left, ast.Name)
+                and isinstance(elt.right, ast.Name)
+                and isinstance(gen.iter, ast.Call)
+                and len(gen.iter.args) == 2
+                and not gen.iter.keywords
+            ):
+                names = [e.id for e in target.elts]  # type: ignore
+                zipfuncs = infer.callfunc_targets(self.gx, gen.iter, self.gx.merged_inh)
+                a, b = gen.iter.args
+                if not (
+                    names[0] != names[1]
+                    and sorted(names) == sorted([elt.left.id, elt.right.id])
+                    and self.library_func(zipfuncs, "builtin", None, "zip")
+                    and self.is_array(a)
+                    and self.is_array(b)
+                    and typestr.nodetypestr(self.gx, a, func, mv=self.mv)
+                    == typestr.nodetypestr(self.gx, b, func, mv=self.mv)
+                ):
+                    return False
+                self.visitm("__array__::__dot(", a, ", ", b, ")", func)
+                return True
+
+            else:
+                return False
+
+        if not self.is_array(arg):
+            return False
+        self.visitm("__array__::__%s(" % ident, arg, ")", func)
+        return True
+
     def visit_Delete(self, node: ast.Delete, func:Optional['python.Function']=None) -> None:
         for child in node.targets:
             self.visit(child, func)
@@ -3053,6 +3282,19 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
         if self.struct_unpack_cpp(node, func):
             return
 
+        # a, b = f(..) with f returning an unboxed tuple
+        if node in self.gx.vtuple_assigns:
+            assert isinstance(node.targets[0], (ast.Tuple, ast.List))
+            self.start("std::tie(")
+            for i, elt in enumerate(node.targets[0].elts):
+                if i > 0:
+                    self.append(", ")
+                self.visit(elt, func)
+            self.append(") = ")
+            self.visit(node.value, func)
+            self.eol()
+            return
+
         # temp vars
         if len(node.targets) > 1 or isinstance(node.value, ast.Tuple):
             if isinstance(node.value, ast.Tuple):
@@ -3336,6 +3578,19 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.deindent()
             self.output("}\n")
 
+    def stack_defs(self, node: ast.FunctionDef) -> None:
+        """storage for objects that do not escape (see find_stack_allocs)"""
+        self.stack_vars = {}
+        for i, alloc in enumerate(self.gx.stack_allocs.get(node, [])):
+            ts = typestr.nodetypestr(self.gx, alloc, mv=self.mv)
+            self.stack_vars[alloc] = ("__stack%d" % i, ts)
+            self.output("__ss_stack<%s> __stack%d;" % (ts[:-2], i))
+
+    def new(self, node: ast.AST, ts: str) -> str:
+        if node in self.stack_vars and self.stack_vars[node][1] == ts:
+            return "(new (&%s) %s(" % (self.stack_vars[node][0], ts[:-2])
+        return "(new " + ts[:-2] + "("
+
     def local_defs(self, func: python.Function) -> None:
         pairs = []
         for name, var in func.vars.items():
@@ -3870,9 +4125,12 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             self.append("NULL")
 
         elif value.__class__.__name__ in ("int", "long"):  # isinstance(value, int):
+            if self.gx.bigint and not -(2**62) <= value < 2**62:
+                self.append('__ss_int("%d")' % value)
+                return
             self.append("__ss_int(")
             self.append(str(value))
-            if self.gx.int64 or self.gx.int128:
+            if self.gx.int64 or self.gx.int128 or self.gx.bigint:
                 self.append("LL")
             self.append(")")
 
@@ -3895,10 +4153,14 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
                 assert const
                 self.append(const)
             else:
+                if self.gx.intern:
+                    self.append("__intern(")
                 self.append('new str("%s"' % self.expand_special_chars(value))
                 if "\0" in value:
                     self.append(", %d" % len(value))
                 self.append(")")
+                if self.gx.intern:
+                    self.append(")")
 
         elif isinstance(value, bytes):  # TODO merge with str above
             self.append('new bytes("%s"' % self.expand_special_chars(value))
@@ -3910,7 +4172,473 @@ class GenerateVisitor(ast_utils.BaseNodeVisitor):
             assert False
 
 
+# --- unboxed return tuples (--vtuples)
+
+
+def vtuple_candidate(gx: 'config.GlobalInfo', func: 'python.Function') -> bool:
+    """plain function returning only tuple displays of equal arity"""
+    if (
+        not isinstance(func.node, ast.FunctionDef)
+        or func.parent is not None
+        or func.lambdanr is not None
+        or func.isGenerator
+        or func.fakeret
+        or not func.returnexpr
+        or not func.retnode
+    ):
+        return False
+
+    arity = set()
+    for expr in func.returnexpr:
+        if not isinstance(expr, ast.Tuple) or [
+            elt for elt in expr.elts if isinstance(elt, ast.Starred)
+        ]:
+            return False
+        arity.add(len(expr.elts))
+    if len(arity) != 1 or arity.pop() < 2:
+        return False
+
+    classes = {t[0] for t in gx.merged_inh.get(func.retnode.thing, set())}
+    if len(classes) != 1:
+        return False
+    cl = classes.pop()
+    if cl.ident == "tuple2":
+        return len(func.returnexpr[0].elts) == 2  # type: ignore[attr-defined]
+    return cl.ident == "tuple"
+
+
+def find_vtuple_funcs(gx: 'config.GlobalInfo') -> None:
+    """functions whose result is only ever unpacked right away ('a, b = f(..)')
+    can return a std::tuple by value instead of a heap-allocated tuple"""
+    candidates: dict[str, List['python.Function']] = {}
+    for module in gx.modules.values():
+        if not module.builtin:
+            for func in module.mv.funcs.values():
+                if vtuple_candidate(gx, func):
+                    candidates.setdefault(func.ident, []).append(func)
+    if not candidates:
+        return
+
+    unpacked: dict[ast.Assign, 'python.Function'] = {}
+    escaping: set['python.Function'] = set()
+    for module in gx.modules.values():
+        if module.builtin:
+            continue
+        calls = set()
+        for node in ast.walk(module.ast):
+            if (
+                isinstance(node, ast.Assign)
+                and len(node.targets) == 1
+                and isinstance(node.targets[0], (ast.Tuple, ast.List))
+                and isinstance(node.value, ast.Call)
+                and (node.value, 0, 0) in gx.cnode
+            ):
+                targets = infer.callfunc_targets(gx, node.value, gx.merged_inh)
+                if len(targets) != 1 or targets[0] not in candidates.get(targets[0].ident, []):
+                    continue
+                func = targets[0]
+                elts = node.targets[0].elts
+                if len(elts) == len(func.returnexpr[0].elts) and not [  # type: ignore[attr-defined]
+                    elt for elt in elts if not isinstance(elt, ast.Name)
+                ]:
+                    unpacked[node] = func
+                    calls.add(node.value.func)
+
+        # any other reference lets the tuple escape
+        for node in ast.walk(module.ast):
+            if node in calls:
+                continue
+            if isinstance(node, ast.Name) and node.id in candidates:
+                escaping.update(candidates[node.id])
+            elif isinstance(node, ast.Attribute) and node.attr in candidates:
+                escaping.update(candidates[node.attr])
+
+    gx.vtuple_funcs = {
+        func for funcs in candidates.values() for func in funcs
+    } - escaping
+    gx.vtuple_assigns = {
+        node for node, func in unpacked.items() if func in gx.vtuple_funcs
+    }
+
+
+# --- stack allocation of non-escaping objects (escape analysis)
+
+NESTED_SCOPES = (
+    ast.FunctionDef,
+    ast.Lambda,
+    ast.ClassDef,
+    ast.ListComp,
+    ast.SetComp,
+    ast.DictComp,
+    ast.GeneratorExp,
+)
+
+# builtin methods that do not let 'self' escape
+STACK_METHODS = {
+    "list": {"append", "extend", "insert", "pop", "count", "index", "remove", "reverse", "sort", "clear"},
+    "tuple": {"count", "index"},
+    "tuple2": set(),
+}
+
+# operator methods, called on an instance and passed the other operand
+STACK_OPERATORS = {
+    ast.Add: "add",
+    ast.Sub: "sub",
+    ast.Mult: "mul",
+    ast.Div: "div",
+    ast.FloorDiv: "floordiv",
+    ast.Mod: "mod",
+    ast.Pow: "pow",
+    ast.LShift: "lshift",
+    ast.RShift: "rshift",
+    ast.BitOr: "or",
+    ast.BitXor: "xor",
+    ast.BitAnd: "and",
+}
+STACK_INPLACE = {"__i%s__" % op for op in STACK_OPERATORS.values()}
+
+StackVar: TypeAlias = Tuple['python.Function', str]
+
+
+def node_parents(node: ast.AST) -> dict[ast.AST, ast.AST]:
+    parents = {}
+    for parent in ast.walk(node):
+        for child in ast.iter_child_nodes(parent):
+            parents[child] = parent
+    return parents
+
+
+def in_nested_scope(node: ast.AST, top: ast.AST, parents: dict[ast.AST, ast.AST]) -> bool:
+    node = parents[node]
+    while node is not top:
+        if isinstance(node, NESTED_SCOPES):
+            return True
+        node = parents[node]
+    return False
+
+
+def stack_method(cl: 'python.Class', ident: str) -> Optional['python.Function']:
+    todo = [cl]
+    while todo:
+        cl = todo.pop(0)
+        if ident in cl.funcs:
+            return cl.funcs[ident]
+        todo.extend(cl.bases)
+    return None
+
+
+def stack_param(func: Optional['python.Function'], index: int) -> Optional[StackVar]:
+    if (
+        func
+        and isinstance(func.node, ast.FunctionDef)
+        and index < len(func.node.args.args)
+    ):
+        return func, func.node.args.args[index].arg
+    return None
+
+
+def stack_call_param(gx: 'config.GlobalInfo', call: ast.Call, pos: int, mv: 'graph.ModuleVisitor') -> List[StackVar]:
+    """parameter(s) receiving positional argument pos of a call, or nothing if unknown"""
+    if call.keywords or [arg for arg in call.args if isinstance(arg, ast.Starred)]:
+        return []
+    if (call, 0, 0) not in gx.cnode:
+        return []
+    objexpr, ident, direct_call, method_call, constructor, parent_constr, anon_func = \
+        infer.analyze_callfunc(gx, call, merge=gx.merged_inh)
+    assert isinstance(ident, str) or not ident
+
+    targets: List[Tuple[Optional['python.Function'], int]] = []
+    if anon_func:
+        return []
+    elif constructor:
+        if not constructor.mv.module.builtin:
+            targets = [(stack_method(constructor, "__init__"), pos + 1)]
+    elif parent_constr:  # Base.method(self, ..)
+        assert isinstance(call.func, ast.Attribute)
+        base = python.lookup_class(call.func.value, mv)
+        if base:
+            targets = [(stack_method(base, call.func.attr), pos)]
+    elif direct_call:
+        if not direct_call.mv.module.builtin:
+            targets = [(direct_call, pos)]
+    elif method_call and objexpr:
+        classes = {t[0] for t in gx.merged_inh.get(objexpr, set())}
+        for cl in classes:
+            if not isinstance(cl, python.Class) or cl.mv.module.builtin or ident in cl.staticmethods:
+                return []
+            targets.append((stack_method(cl, ident), pos + 1))  # type: ignore[arg-type]
+
+    params = []
+    for func, index in targets:
+        param = stack_param(func, index)
+        if not param:
+            return []
+        params.append(param)
+    return params
+
+
+def stack_operator_param(gx: 'config.GlobalInfo', cl: 'python.Class', node: ast.Name, parent: Union[ast.BinOp, ast.AugAssign]) -> List[StackVar]:
+    """parameter(s) receiving an operand of a user-defined binary operator"""
+    if type(parent.op) not in STACK_OPERATORS:
+        return []
+    op = STACK_OPERATORS[type(parent.op)]
+    if isinstance(parent, ast.AugAssign):
+        op = "i" + op
+        other = infer.inode(gx, parent).assignhop.value.left  # type: ignore[attr-defined]
+    else:
+        other = parent.left
+    method = "__%s__" % op
+
+    if parent.value is node if isinstance(parent, ast.AugAssign) else parent.right is node:
+        classes = {t[0] for t in gx.merged_inh.get(other, set())}
+        index = 1
+    else:
+        classes = {cl}
+        index = 0
+
+    params = []
+    for ocl in classes:
+        if not isinstance(ocl, python.Class) or ocl.mv.module.builtin:
+            return []
+        param = stack_param(stack_method(ocl, method), index)
+        if not param:
+            return []
+        params.append(param)
+    return params
+
+
+def stack_seq_use(cl: 'python.Class', node: ast.Name, parent: ast.AST, parents: dict[ast.AST, ast.AST]) -> bool:
+    """reference to a tuple or list that does not let it escape"""
+    if isinstance(parent, ast.Subscript) and parent.value is node:  # l[i], t[1:]
+        return True
+    if (  # l.append(..)
+        isinstance(parent, ast.Attribute)
+        and parent.attr in STACK_METHODS[cl.ident]
+        and isinstance(parents[parent], ast.Call)
+        and parents[parent].func is parent  # type: ignore[attr-defined]
+    ):
+        return True
+    if (  # a, b = t
+        isinstance(parent, ast.Assign)
+        and parent.value is node
+        and len(parent.targets) == 1
+        and isinstance(parent.targets[0], (ast.Tuple, ast.List))
+    ):
+        return True
+    if isinstance(parent, ast.Compare) and [  # x in t
+        op for op, comp in zip(parent.ops, parent.comparators)
+        if comp is node and isinstance(op, (ast.In, ast.NotIn))
+    ]:
+        return True
+    if (  # len(t)
+        isinstance(parent, ast.Call)
+        and isinstance(parent.func, ast.Name)
+        and parent.func.id == "len"
+        and len(parent.args) == 1
+        and parent.args[0] is node
+    ):
+        return True
+    if (  # for x in t, unless t is rebound during the loop
+        isinstance(parent, ast.For)
+        and parent.iter is node
+        and not [
+            n for stmt in parent.body + parent.orelse for n in ast.walk(stmt)
+            if isinstance(n, ast.Name) and n.id == node.id and isinstance(n.ctx, ast.Store)
+        ]
+    ):
+        return True
+    return False
+
+
+def stack_var_uses(gx: 'config.GlobalInfo', cl: 'python.Class', var: StackVar, parents: dict[Any, Any]) -> Optional[List[StackVar]]:
+    """check that a local variable or parameter only refers to an instance of cl in ways that
+    do not let it escape. returns the parameters it is passed on to, or None"""
+    func, name = var
+    if (
+        not isinstance(func.node, ast.FunctionDef)
+        or func.mv.module.builtin
+        or func.isGenerator
+        or func.lambdanr is not None
+        or name in func.globals
+    ):
+        return None
+    top = func.node
+    if top not in parents:
+        parents[top] = node_parents(top)
+    up = parents[top]
+
+    passed = []
+    for node in ast.walk(top):
+        if not isinstance(node, ast.Name) or node.id != name:
+            continue
+        parent = up[node]
+        if in_nested_scope(node, top, up):
+            return None
+        if isinstance(node.ctx, ast.Del):
+            return None
+
+        if cl.mv.module.builtin:
+            if isinstance(parent, ast.AugAssign):
+                return None
+            if isinstance(node.ctx, ast.Load) and stack_seq_use(cl, node, parent, up):
+                continue
+
+        if isinstance(parent, (ast.BinOp, ast.AugAssign)):  # x * y, y += x
+            params = stack_operator_param(gx, cl, node, parent)
+            if not params:
+                return None
+            passed.extend(params)
+
+        elif isinstance(node.ctx, ast.Store):
+            continue
+
+        elif (  # 'x += y' rebinds x to the result
+            isinstance(parent, ast.Return)
+            and func.ident in STACK_INPLACE
+            and func.formals
+            and name == func.formals[0]
+        ):
+            continue
+
+        elif isinstance(parent, ast.Call) and [arg for arg in parent.args if arg is node]:
+            pos = [i for i, arg in enumerate(parent.args) if arg is node][0]
+            params = stack_call_param(gx, parent, pos, func.mv)
+            if not params:
+                return None
+            passed.extend(params)
+
+        elif isinstance(parent, ast.Attribute) and parent.value is node and not cl.mv.module.builtin:
+            if parent.attr in cl.properties:
+                return None
+            method = stack_method(cl, parent.attr)
+            if method:  # x.method(..)
+                call = up[parent]
+                if (
+                    not isinstance(call, ast.Call)
+                    or call.func is not parent
+                    or parent.attr in STACK_INPLACE
+                ):
+                    return None
+                if parent.attr in cl.staticmethods:
+                    continue
+                param = stack_param(method, 0)
+                if not param:
+                    return None
+                passed.append(param)
+
+        else:
+            return None
+    return passed
+
+
+def stack_safe(gx: 'config.GlobalInfo', cl: 'python.Class', var: StackVar, cache: dict[Any, Any], seen: Optional[set[StackVar]] = None) -> bool:
+    """an instance of cl referred to by var (and passed on from there) cannot escape. the
+    variables it may be referred to by are added to seen"""
+    todo = [var]
+    if seen is None:
+        seen = set()
+    while todo:
+        var = todo.pop()
+        if var in seen:
+            continue
+        seen.add(var)
+        if (cl, var) not in cache:
+            cache[cl, var] = stack_var_uses(gx, cl, var, cache.setdefault("parents", {}))
+        passed = cache[cl, var]
+        if passed is None:
+            return False
+        todo.extend(passed)
+    return True
+
+
+def stack_alloc_class(gx: 'config.GlobalInfo', node: ast.AST, mv: 'graph.ModuleVisitor', cache: dict[Any, Any]) -> Optional['python.Class']:
+    """class of a constructor call or tuple/list display that could use local storage"""
+    classes = {t[0] for t in gx.merged_inh.get(node, set())}
+    if len(classes) != 1:
+        return None
+    cl = classes.pop()
+    if not isinstance(cl, python.Class):
+        return None
+    if isinstance(node, (ast.Tuple, ast.List)):
+        if cl.mv.module.builtin and cl.ident in STACK_METHODS and not [
+            elt for elt in node.elts if isinstance(elt, ast.Starred)
+        ]:
+            return cl
+    elif isinstance(node, ast.Call):
+        if (
+            python.lookup_class(node.func, mv) is cl
+            and not [c for c in cl.ancestors(True) if c.mv.module.builtin or c.properties]
+        ):
+            init = stack_param(stack_method(cl, "__init__"), 0)
+            if not init or stack_safe(gx, cl, init, cache):
+                return cl
+    return None
+
+
+def find_stack_allocs(gx: 'config.GlobalInfo') -> None:
+    """objects assigned to a local variable, that are only used for attribute access, indexing and
+    unpacking, or passed to methods and functions that do the same, cannot outlive the function
+    creating them. so instead of on the heap, they can be constructed in local storage."""
+    cache: dict[Any, Any] = {}
+    funcs = []
+    for module in gx.modules.values():
+        if not module.builtin:
+            funcs.extend(module.mv.funcs.values())
+            for cl in module.mv.classes.values():
+                funcs.extend(cl.funcs.values())
+
+    for func in funcs:
+        if (
+            not isinstance(func.node, ast.FunctionDef)
+            or func.inherited
+            or func.isGenerator
+            or func.node in gx.stack_allocs
+        ):
+            continue
+        top = func.node
+        parents = node_parents(top)
+
+        # allocations assigned to a local variable
+        allocs: dict[str, List[Tuple[ast.AST, 'python.Class']]] = {}
+        for node in ast.walk(top):
+            if (
+                isinstance(node, ast.Assign)
+                and len(node.targets) == 1
+                and isinstance(node.targets[0], ast.Name)
+                and node.targets[0].id in func.vars
+                and node.targets[0].id not in func.formals
+                and not in_nested_scope(node, top, parents)
+            ):
+                cl = stack_alloc_class(gx, node.value, func.mv, cache)
+                if cl:
+                    allocs.setdefault(node.targets[0].id, []).append((node.value, cl))
+
+        # .. that does not let them escape
+        sites = []
+        for name, pairs in allocs.items():
+            seen: set[StackVar] = set()
+            if [cl for _, cl in pairs if not stack_safe(gx, cl, (func, name), cache, seen)]:
+                continue
+            # storage is reused on every execution of the allocation, so the arguments
+            # may not refer to the previous object (as in 'x = C(x)' in a loop)
+            aliases = {n for (f, n) in seen if f is func}
+            for alloc, _ in pairs:
+                if not [
+                    n for n in ast.walk(alloc)
+                    if isinstance(n, ast.Name) and n.id in aliases
+                ]:
+                    sites.append(alloc)
+        if sites:
+            gx.stack_allocs[top] = sorted(
+                sites, key=lambda n: (getattr(n, 'lineno', 0), getattr(n, 'col_offset', 0))
+            )
+
+
 def generate_code(gx: 'config.GlobalInfo', analyze:bool=False) -> None:
+    if gx.vtuples and not gx.pyextension_product and not analyze:
+        find_vtuple_funcs(gx)
+    if not gx.noescape and not analyze:
+        find_stack_allocs(gx)
     for module in gx.modules.values():
         if not module.builtin:
             gv = GenerateVisitor(gx, module, analyze)
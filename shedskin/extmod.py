@@ -271,6 +271,7 @@ class ExtensionModule:
             % clname(cl)
         )
         write("    (void)args; (void)kwargs;")
+        self.write_gc_thread()
         write("    PyObject *t = PyTuple_New(3);")
         write(
             '    PyTuple_SetItem(t, 0, PyObject_GetAttrString(__ss_mod_%s, "__newobj__"));'
@@ -294,6 +295,7 @@ class ExtensionModule:
             % clname(cl)
         )
         write("    (void)kwargs;")
+        self.write_gc_thread()
         write("    PyObject *state = PyTuple_GetItem(args, 0);")
         for i, var in enumerate(vars):
             vartype = typestr.nodetypestr(self.gx, var, var.parent, mv=self.gv.mv)
@@ -441,6 +443,14 @@ class ExtensionModule:
         # write("    {NULL}\n};\n")
         write("    {NULL, NULL, 0, NULL}\n};\n")
 
+    def write_gc_thread(self) -> None:
+        """
+        With --nogil, registers the calling (python) thread with the GC
+        for the duration of a generated entry point that may allocate.
+        """
+        if self.gx.nogil:
+            self.write("    __ss_gc_thread gc_thread;")
+
     def do_extmod_method(self, func: 'python.Function') -> None:
         """
         Does an extmod method.
@@ -464,6 +474,7 @@ class ExtensionModule:
             id = "Global_" + "_".join(self.gv.module.name_list) + "_" + func.ident
         write("PyObject *%s(PyObject *self, PyObject *args, PyObject *kwargs) {" % id)
         write("    (void)self; (void)args; (void)kwargs;")
+        self.write_gc_thread()
         write("    try {")
 
         for i, formal in enumerate(formals):
@@ -511,14 +522,16 @@ class ExtensionModule:
             where = "((%sObject *)self)->__ss_object->" % clname(func.parent)
         else:
             where = "__" + self.gv.module.ident + "__::"
-        write(
-            "        return __to_py("
-            + where
+        call = (
+            where
             + self.gv.cpp_name(func.ident)
             + "("
             + ", ".join("arg_%d" % i for i in range(len(formals)))
-            + "));\n"
+            + ")"
         )
+        if self.gx.nogil:
+            call = "__ss_nogil_call([&]() { return %s; })" % call
+        write("        return __to_py(" + call + ");\n")
 
         # convert exceptions
         write("    } catch (Exception *e) {")
@@ -700,6 +713,7 @@ class ExtensionModule:
         write(
             "    (void)args; (void)kwargs;"
         )
+        self.write_gc_thread()
         write(
             "    %sObject *self = (%sObject *)type->tp_alloc(type, 0);"
             % (clname(cl), clname(cl))
@@ -729,6 +743,7 @@ class ExtensionModule:
                 % (clname(cl), var.name, clname(cl))
             )
             write("    (void)closure;");
+            self.write_gc_thread()
             write("    return __to_py(self->__ss_object->%s);" % self.gv.cpp_name(var))
             write("}\n")
 
@@ -737,6 +752,7 @@ class ExtensionModule:
                 % (clname(cl), var.name, clname(cl))
             )
             write("    (void)closure;");
+            self.write_gc_thread()
             write("    try {")
             typ = typestr.nodetypestr(self.gx, var, var.parent, mv=self.gv.mv)
             if typ == "void *":  # XXX investigate
@@ -389,7 +389,8 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         if isinstance(parent, python.Function):
             parent.constraints.add(constraint)
 
-    def struct_unpack(self, rvalue: ast.AST, func: Optional['python.Function']) -> bool:
+    def struct_unpack(self, rvalue: ast.AST, func: Optional['python.Function']) -> Optional[Tuple[ast.AST, ast.AST, Optional[ast.AST]]]:
+        """format, buffer and struct.Struct object (if any) of a call to struct.unpack(_from)"""
         if isinstance(rvalue, ast.Call):
             struct_var = python.lookup_var("struct", func, self)
             if (
@@ -400,15 +401,67 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
                 and struct_var
                 and struct_var.imported
             ):  # XXX imported from where?
-                return True
+                return rvalue.args[0], rvalue.args[1], None
             elif (
                 isinstance(rvalue.func, ast.Name)
                 and rvalue.func.id in ("unpack", "unpack_from")
                 and rvalue.func.id in self.ext_funcs
                 and not python.lookup_var(rvalue.func.id, func, self)
             ):  # XXX imported from where?
-                return True
-        return False
+                return rvalue.args[0], rvalue.args[1], None
+            elif (
+                isinstance(rvalue.func, ast.Attribute)
+                and rvalue.func.attr in ("unpack", "unpack_from")
+                and rvalue.args
+            ):
+                fmt = self.struct_object(rvalue.func.value, func)
+                if fmt:
+                    return fmt, rvalue.args[0], rvalue.func.value
+        return None
+
+    def struct_constructor(self, node: ast.AST) -> Optional[ast.AST]:
+        """format of struct.Struct(format)"""
+        if isinstance(node, ast.Call) and len(node.args) == 1:
+            cl = python.lookup_class(node.func, self)
+            if cl and cl.ident == "Struct" and cl.mv.module.ident == "struct":
+                return node.args[0]
+        return None
+
+    def struct_object(self, node: ast.AST, func: Optional['python.Function']) -> Optional[ast.AST]:
+        """format of the struct.Struct object a name is assigned (once)"""
+        if isinstance(node, ast.Name):
+            var = python.lookup_var(node.id, func, self)
+            if var and var.struct_assign:
+                if len(var.struct_assign) > 1:
+                    error.error(
+                        "'%s' is assigned more than one struct.Struct, so its format is unknown" % node.id,
+                        self.gx, node, mv=self
+                    )
+                return var.struct_assign[0]
+        return None
+
+    def struct_iter_unpack(self, node: ast.For, func: Optional['python.Function']) -> bool:
+        """for a, b, .. in s.iter_unpack(buffer), with s a struct.Struct object"""
+        call = node.iter
+        if not (
+            isinstance(call, ast.Call)
+            and isinstance(call.func, ast.Attribute)
+            and call.func.attr == "iter_unpack"
+            and len(call.args) == 1
+            and isinstance(node.target, (ast.List, ast.Tuple))
+            and not [n for n in node.target.elts if ast_utils.is_assign_list_or_tuple(n)]
+        ):
+            return False
+        fmt = self.struct_object(call.func.value, func)
+        if not fmt:
+            return False
+        self.visit(call, func)
+        sinfo = self.struct_info(fmt, func)
+        self.visit(ast.Assign([node.target], self.struct_faketuple(sinfo)), func)
+        tvar = self.temp_var2(call.args[0], infer.inode(self.gx, call.args[0]), func)
+        tvar_pos = self.temp_var_int(call.func, func)
+        self.gx.struct_unpack[node] = (sinfo, tvar.name, tvar_pos.name, call.func.value)
+        return True
 
     def struct_info(self, node: ast.AST, func: Optional['python.Function']) -> List[Tuple[str, str, str, int]]:
         if isinstance(node, ast.Name):
@@ -995,6 +1048,7 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         lambdanr = len(self.lambdas)
         name = "__lambda%d__" % lambdanr
         fakenode = ast.FunctionDef(name, node.args, [ast.Return(node.body)], [])
+        ast.copy_location(fakenode, node)
         self.visit(fakenode, None, True)
         f = self.lambdas[name]
         f.lambdanr = lambdanr
@@ -1427,6 +1481,22 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         self.add_constraint((infer.inode(self.gx, node.value), func.yieldnode), func)
 
     def visit_For(self, node: ast.For, func:Optional['python.Function']=None) -> None:
+        if not self.struct_iter_unpack(node, func):
+            self.visit_for_target(node, func)
+
+        # --- for-else
+        if node.orelse:
+            self.temp_var_int(node.orelse[0], func)
+            for child in node.orelse:
+                self.visit(child, func)
+
+        # --- loop body
+        self.gx.loopstack.append(node)
+        for child in node.body:
+            self.visit(child, func)
+        self.gx.loopstack.pop()
+
+    def visit_for_target(self, node: ast.For, func: Optional['python.Function']) -> None:
         # --- iterable contents -> assign node
         assnode = infer.CNode(self.gx, getmv(), node.target, parent=func)
         self.gx.types[assnode] = set()
@@ -1471,18 +1541,6 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
 
         self.do_for(node, assnode, get_iter, func)
 
-        # --- for-else
-        if node.orelse:
-            self.temp_var_int(node.orelse[0], func)
-            for child in node.orelse:
-                self.visit(child, func)
-
-        # --- loop body
-        self.gx.loopstack.append(node)
-        for child in node.body:
-            self.visit(child, func)
-        self.gx.loopstack.pop()
-
     def do_for(self, node: Union[ast.For, ast.comprehension], assnode: 'infer.CNode', get_iter: ast.Call, func: Optional['python.Function']) -> None:
         # --- for i in range(..) XXX i should not be modified.. use tempcounter; two bounds
         if ast_utils.is_fastfor(node):
@@ -1666,22 +1724,24 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
         # --- rewrite for struct.unpack XXX rewrite callfunc as tuple
         if len(node.targets) == 1:
             lvalue2, rvalue2 = node.targets[0], node.value
+            unpack = self.struct_unpack(rvalue2, func)
             if (
-                self.struct_unpack(rvalue2, func)
+                unpack
                 and isinstance(rvalue2, ast.Call)  # TODO double check
                 and ast_utils.is_assign_list_or_tuple(lvalue2)
                 and isinstance(lvalue2, (ast.List, ast.Tuple))  # TODO double check
                 and not [n for n in lvalue2.elts if ast_utils.is_assign_list_or_tuple(n)]
             ):
+                fmt, buffer, struct_obj = unpack
                 self.visit(node.value, func)
-                sinfo = self.struct_info(rvalue2.args[0], func)
+                sinfo = self.struct_info(fmt, func)
                 faketuple = self.struct_faketuple(sinfo)
                 self.visit(ast.Assign(node.targets, faketuple), func)
                 tvar = self.temp_var2(
-                    rvalue2.args[1], infer.inode(self.gx, rvalue2.args[1]), func
+                    buffer, infer.inode(self.gx, buffer), func
                 )
-                tvar_pos = self.temp_var_int(rvalue2.args[0], func)
-                self.gx.struct_unpack[node] = (sinfo, tvar.name, tvar_pos.name)
+                tvar_pos = self.temp_var_int(rvalue2.args[0] if not struct_obj else rvalue2.func, func)
+                self.gx.struct_unpack[node] = (sinfo, tvar.name, tvar_pos.name, struct_obj)
                 return
 
         newnode = infer.CNode(self.gx, getmv(), node, parent=func)
@@ -1712,6 +1772,9 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
                     if ast_utils.is_constant(rvalue):
                         assert isinstance(rvalue, ast.Constant)
                         lvar.const_assign.append(rvalue)
+                    fmt = self.struct_constructor(rvalue)
+                    if fmt:
+                        lvar.struct_assign.append(fmt)
                     self.add_constraint(
                         (infer.inode(self.gx, rvalue), infer.inode(self.gx, lvar)), func
                     )
@@ -2019,6 +2082,7 @@ class ModuleVisitor(ast_utils.BaseNodeVisitor):
                     "object",
                     "Exception",
                     "tzinfo",
+                    "Thread",
                 ]:
                     if python.def_class(self.gx, "Exception") not in cl.ancestors():
                         error.error(
@@ -308,6 +308,12 @@ def analyze_args(
     if (method_call or constructor) and not (parent_constr or anon_func):  # XXX
         args.insert(0, None)
 
+    # defaults can only be skipped after the last keyword argument
+    kw_end = 0
+    for i, formal in enumerate(formal_args):
+        if formal in kwdict or (formal.startswith("__kw_") and formal[5:] in kwdict):
+            kw_end = i
+
     argnr = 0
     actuals: List[Optional[ast.AST]] = []
     formals = []
@@ -325,7 +331,7 @@ def analyze_args(
             argnr += 1
             formals.append(formal)
         elif i >= default_start:
-            if not skip_defaults:
+            if not skip_defaults or i < kw_end:
                 default = func.defaults[i - default_start]
                 if formal.startswith("__kw_"):
                     actuals.insert(0, default)
@@ -9,7 +9,7 @@ void * default_0;
 class_ *cl_array;
 str *typecodes;
 
-void *buffy;
+alignas(8) __SS_THREAD_LOCAL char buffy[8];
 
 template<> str *array<str *>::__repr__() {
     return __add_strs(5, new str("array('"), typecode, new str("', "), repr(tostring()), new str(")"));
@@ -22,6 +22,7 @@ void __throw_no_char() {
 template<> void *array<str *>::append(str *t) {
     if(t->unit.size() != 1)
         __throw_no_char();
+    resizing();
     units.push_back(t->unit[0]);
     return NULL;
 }
@@ -69,6 +70,7 @@ template<> __ss_int array<str *>::index(str *t) {
 }
 
 template<> template<> void *array<int>::extend(list<__ss_int> *l) {
+    resizing();
     size_t len = l->units.size();
     size_t pos = this->units.size();
     this->units.resize(pos+len*itemsize);
@@ -92,11 +94,110 @@ template<> template<> void *array<str *>::extend(bytes *s) {
     return NULL;
 }
 
+#ifdef __SS_BIND
+/* buffer exporter, keeping the array alive through __ss_proxy */
+
+typedef struct {
+    PyObject_HEAD
+    pyobj *owner;
+    __GC_VECTOR(char) *units;
+    int *exports;
+    char format[2];
+    Py_ssize_t shape[1];
+    Py_ssize_t strides[1];
+} __ss_bufferObject;
+
+static PyTypeObject __ss_bufferType = { PyVarObject_HEAD_INIT(NULL, 0) };
+static PyBufferProcs __ss_buffer_procs;
+static char __ss_buffer_empty[1];
+
+static int __ss_buffer_getbuffer(PyObject *exporter, Py_buffer *view, int flags) {
+    __ss_bufferObject *self = (__ss_bufferObject *)exporter;
+    Py_ssize_t len = (Py_ssize_t)self->units->size();
+    self->shape[0] = len / self->strides[0]; /* (fixed while exporting) */
+
+    view->obj = exporter;
+    Py_INCREF(exporter);
+    view->buf = len ? self->units->data() : __ss_buffer_empty;
+    view->len = len;
+    view->readonly = 0;
+    view->itemsize = self->strides[0];
+    view->format = (flags & PyBUF_FORMAT) ? self->format : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? self->shape : NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? self->strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+
+    (*self->exports)++;
+    return 0;
+}
+
+static void __ss_buffer_releasebuffer(PyObject *exporter, Py_buffer *) {
+    (*((__ss_bufferObject *)exporter)->exports)--;
+}
+
+static void __ss_buffer_dealloc(PyObject *exporter) {
+    __ss_proxy->__delitem__(((__ss_bufferObject *)exporter)->owner);
+    Py_TYPE(exporter)->tp_free(exporter);
+}
+
+PyObject *__buffer_to_py(pyobj *owner, __GC_VECTOR(char) *units, int *exports, char typechar, unsigned int itemsize) {
+    PyObject *exporter;
+    if(__ss_proxy->has_key(owner)) {
+        exporter = (PyObject *)(__ss_proxy->__getitem__(owner));
+        Py_INCREF(exporter);
+    } else {
+        __ss_bufferObject *self = PyObject_New(__ss_bufferObject, &__ss_bufferType);
+        self->owner = owner;
+        self->units = units;
+        self->exports = exports;
+        self->format[0] = typechar;
+        self->format[1] = '\0';
+        self->strides[0] = (Py_ssize_t)itemsize;
+        __ss_proxy->__setitem__(owner, self);
+        exporter = (PyObject *)self;
+    }
+    PyObject *view = PyMemoryView_FromObject(exporter);
+    Py_DECREF(exporter);
+    return view;
+}
+
+char __buffer_typechar(PyObject *p, Py_buffer *view, const char *typechars) {
+    if(PyObject_GetBuffer(p, view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) == -1) {
+        PyErr_Clear();
+        throw new TypeError(new str("error in conversion to Shed Skin (array or other buffer expected)"));
+    }
+    const char *format = view->format ? view->format : "B";
+    if(format[0] == '@')
+        format++;
+    char c = format[0];
+    if(c == 'q' && sizeof(long) == sizeof(long long))
+        c = 'l';
+    else if(c == 'Q' && sizeof(long) == sizeof(long long))
+        c = 'L';
+    if(c && !format[1] && strchr(typechars, c))
+        return c;
+    PyBuffer_Release(view);
+    throw new TypeError(new str("error in conversion to Shed Skin (incompatible buffer format)"));
+}
+#endif
+
 void __init() {
     __name__ = new str("array");
     cl_array = new class_("array");
 
-    buffy = malloc(8);
+#ifdef __SS_BIND
+    __ss_buffer_procs.bf_getbuffer = __ss_buffer_getbuffer;
+    __ss_buffer_procs.bf_releasebuffer = __ss_buffer_releasebuffer;
+    __ss_bufferType.tp_name = "array_buffer";
+    __ss_bufferType.tp_basicsize = sizeof(__ss_bufferObject);
+    __ss_bufferType.tp_flags = Py_TPFLAGS_DEFAULT;
+    __ss_bufferType.tp_dealloc = __ss_buffer_dealloc;
+    __ss_bufferType.tp_as_buffer = &__ss_buffer_procs;
+    PyType_Ready(&__ss_bufferType);
+#endif
+
     default_0 = NULL;
     typecodes = new str("bBuhHiIlLqQfd");
 }
@@ -10,11 +10,113 @@ namespace __array__ {
 
 extern str *const_0;
 extern str *__name__;
-extern void *buffy;
+extern __SS_THREAD_LOCAL char buffy[8]; /* per thread scratch space for (un)packing */
 extern str *typecodes;
 
 unsigned int get_itemsize(char typechar);
 
+#ifdef __SS_BIND
+/* buffer protocol: arrays are converted from any contiguous buffer with a compatible format
+   using a single copy, and exported to python without copying (as a memoryview) */
+
+template<class T> inline const char *__buffer_typechars();
+template<> inline const char *__buffer_typechars<__ss_int>() { return "bBhHiIlL"; }
+template<> inline const char *__buffer_typechars<__ss_float>() { return "fd"; }
+template<> inline const char *__buffer_typechars<str *>() { return "c"; }
+
+char __buffer_typechar(PyObject *p, Py_buffer *view, const char *typechars);
+PyObject *__buffer_to_py(pyobj *owner, __GC_VECTOR(char) *units, int *exports, char typechar, unsigned int itemsize);
+#endif
+
+/* numeric kernels: plain loops over the storage type S, with independent lanes
+   for the reductions (as for lists, see builtin/function.hpp), so that the compiler
+   vectorizes them for the target */
+
+template<class S> struct __array_acc { typedef unsigned long long type; }; /* (wraps) */
+template<> struct __array_acc<float> { typedef double type; };
+template<> struct __array_acc<double> { typedef double type; };
+
+template<class S> typename __array_acc<S>::type __array_dot(const S *p, const S *q, size_t n) {
+    typedef typename __array_acc<S>::type R;
+    R lane[__SS_LANES] = {};
+    size_t i = 0;
+    for(; i+__SS_LANES <= n; i += __SS_LANES)
+        for(size_t j=0; j<__SS_LANES; j++)
+            lane[j] += (R)p[i+j] * (R)q[i+j];
+    R r = 0;
+    for(size_t j=0; j<__SS_LANES; j++)
+        r += lane[j];
+    for(; i<n; i++)
+        r += (R)p[i] * (R)q[i];
+    return r;
+}
+
+template<class S> size_t __array_count(const S *p, size_t n, S s) {
+    size_t c = 0;
+    for(size_t i=0; i<n; i++)
+        c += (p[i] == s);
+    return c;
+}
+
+template<class S> size_t __array_index(const S *p, size_t n, S s) {
+    for(size_t i=0; i<n; i++)
+        if(p[i] == s)
+            return i;
+    return n;
+}
+
+inline uint16_t __array_bswap(uint16_t v) { return __builtin_bswap16(v); }
+inline uint32_t __array_bswap(uint32_t v) { return __builtin_bswap32(v); }
+inline uint64_t __array_bswap(uint64_t v) { return __builtin_bswap64(v); }
+
+template<class U> void __array_byteswap(U *p, size_t n) {
+    for(size_t i=0; i<n; i++)
+        p[i] = __array_bswap(p[i]);
+}
+
+/* call f with the storage as a typed pointer, for the typecodes that hold a T */
+template<class T, class F> inline void __array_typed(char typechar, char *data, F f) {
+    if constexpr (std::is_same_v<T, __ss_float>) {
+        if(typechar == 'f')
+            f((float *)data);
+        else
+            f((double *)data);
+    } else {
+        switch(typechar) {
+            case 'b': f((signed char *)data); break;
+            case 'B': f((unsigned char *)data); break;
+            case 'h': f((signed short *)data); break;
+            case 'H': f((unsigned short *)data); break;
+            case 'i': f((signed int *)data); break;
+            case 'I': f((unsigned int *)data); break;
+            case 'l': f((signed long *)data); break;
+            case 'L': f((unsigned long *)data); break;
+        }
+    }
+}
+
+/* does S hold t exactly (so that comparing in S is comparing in T)? */
+template<class T, class S> inline bool __array_holds(T t, S s) {
+    return (T)s == t && (std::is_signed_v<S> || !(t < 0));
+}
+
+/* can S be reduced without leaving the accumulator range? */
+template<class S> inline bool __array_exact(bool product) {
+#ifdef __SS_BIGINT
+    if(std::is_integral_v<S>)
+        return sizeof(S) <= (product ? 2 : 4);
+#endif
+    (void)product;
+    return true;
+}
+
+template<class S, class T> inline T __array_result(typename __array_acc<S>::type r) {
+    if constexpr (std::is_integral_v<S>)
+        return (T)(long long)r;
+    else
+        return (T)r;
+}
+
 extern class_ *cl_array;
 template <class T> class array : public pyseq<T> {
 public:
@@ -22,9 +124,15 @@ public:
     str *typecode;
     char typechar;
     unsigned int itemsize;
+#ifdef __SS_BIND
+    int exports; /* number of python buffer views */
+#endif
 
     array(str *typecode_) {
         this->__class__ = cl_array;
+#ifdef __SS_BIND
+        exports = 0;
+#endif
         typecode = typecode_;
         typechar = typecode_->unit[0];
         itemsize = get_itemsize(typechar);
@@ -32,9 +140,24 @@ public:
 
     template<class U> array(str *typecode_, U *iter) { /* XXX iter with type None */
         this->__class__ = cl_array;
+#ifdef __SS_BIND
+        exports = 0;
+#endif
         __init__(typecode_, iter);
     }
 
+#ifdef __SS_BIND
+    array(PyObject *p);
+    PyObject *__to_py__();
+#endif
+
+    inline void resizing() {
+#ifdef __SS_BIND
+        if(exports)
+            throw new BufferError(new str("cannot resize an array that is exporting buffers"));
+#endif
+    }
+
     template<class U> void *__init__(str *typecode_, U *iter);
 
     template<class U> void *extend(U *iter);
@@ -65,6 +188,11 @@ public:
     __ss_int count(T t);
     __ss_int index(T t);
 
+    T dot(array<T> *b);
+    void *scale(T x);
+    void *elementwise_add(array<T> *b);
+    void *elementwise_mul(array<T> *b);
+
     void *remove(T t);
     T pop(__ss_int i=-1);
 
@@ -98,6 +226,7 @@ template<class T> template<class U> void *array<T>::__init__(str *typecode_, U *
 }
 
 template<class T> template<class U> void *array<T>::extend(U *iter) {
+    resizing();
     if(iter->__class__ == cl_array) {
         array<T> *arr = (array<T> *)iter;
         size_t s1 = this->units.size();
@@ -141,6 +270,7 @@ template<class T> void *array<T>::fromstring(bytes *s) {
 }
 
 template<class T> void *array<T>::frombytes(bytes *s) {
+    resizing();
     size_t len = s->unit.size();
     if(len == 1)
         this->units.push_back(s->unit[0]);
@@ -190,6 +320,7 @@ template<class T> array<T> *array<T>::__mul__(__ss_int n) {
 }
 
 template<class T> array<T> *array<T>::__imul__(__ss_int n) {
+    resizing();
     size_t len = this->units.size();
     this->units.resize(len*n);
     for(size_t i=1; i<n; i++)
@@ -212,6 +343,7 @@ template<class T> array<T> *array<T>::__add__(array<T> *b) {
 template<class T> array<T> *array<T>::__iadd__(array<T> *b) {
     if(this->typecode != b->typecode)
         throw new TypeError(new str("bad argument type for built-in operation")); 
+    resizing();
     size_t s1 = this->units.size();
     size_t s2 = b->units.size();
     this->units.resize(s1+s2);
@@ -220,30 +352,94 @@ template<class T> array<T> *array<T>::__iadd__(array<T> *b) {
 }
 
 template<class T> __ss_int array<T>::count(T t) {
-    __ss_int result = 0;
     size_t len = this->__len__();
-    for(size_t i=0; i<len; i++)
-        if(__eq(t, this->__getitem__(i)))
-            result += 1;
-    return result;
+    size_t result = 0;
+    __array_typed<T>(typechar, units.data(), [&](auto *p) {
+        typedef std::remove_pointer_t<decltype(p)> S;
+        S s = (S)t;
+        if(__array_holds(t, s))
+            result = __array_count(p, len, s);
+    });
+    return (__ss_int)result;
 }
 template<> __ss_int array<str *>::count(str *t);
 
 template<class T> __ss_int array<T>::index(T t) {
     size_t len = this->__len__();
-    for(size_t i=0; i<len; i++)
-        if(__eq(t, this->__getitem__(i)))
-            return i;
-    throw new ValueError(new str("array.index(x): x not in list"));
+    size_t result = len;
+    __array_typed<T>(typechar, units.data(), [&](auto *p) {
+        typedef std::remove_pointer_t<decltype(p)> S;
+        S s = (S)t;
+        if(__array_holds(t, s))
+            result = __array_index(p, len, s);
+    });
+    if(result == len)
+        throw new ValueError(new str("array.index(x): x not in list"));
+    return (__ss_int)result;
 }
 template<> __ss_int array<str *>::index(str *t);
 
+template<class T> T array<T>::dot(array<T> *b) {
+    if(b->__len__() != this->__len__())
+        throw new ValueError(new str("array.dot(b): arrays of different length"));
+    return __dot(this, b);
+}
+
+template<class T> void *array<T>::scale(T x) {
+    size_t len = this->__len__();
+    __array_typed<T>(typechar, units.data(), [&](auto *p) {
+        typedef std::remove_pointer_t<decltype(p)> S;
+        if constexpr (std::is_integral_v<S>) {
+            unsigned long long k = (unsigned long long)(long long)x; /* (wraps, as C does) */
+            for(size_t i=0; i<len; i++)
+                p[i] = (S)((unsigned long long)p[i] * k);
+        } else {
+            for(size_t i=0; i<len; i++)
+                p[i] = (S)(p[i] * x);
+        }
+    });
+    return NULL;
+}
+
+template<class T> void *array<T>::elementwise_add(array<T> *b) {
+    size_t len = this->__len__();
+    if((size_t)b->__len__() != len)
+        throw new ValueError(new str("array.elementwise_add(b): arrays of different length"));
+    if(b->typechar == typechar) {
+        __array_typed<T>(typechar, units.data(), [&](auto *p) {
+            const decltype(p) q = (decltype(p))b->units.data();
+            for(size_t i=0; i<len; i++)
+                p[i] = p[i] + q[i];
+        });
+    } else
+        for(size_t i=0; i<len; i++)
+            __setitem__(i, __getfast__(i) + b->__getfast__(i));
+    return NULL;
+}
+
+template<class T> void *array<T>::elementwise_mul(array<T> *b) {
+    size_t len = this->__len__();
+    if((size_t)b->__len__() != len)
+        throw new ValueError(new str("array.elementwise_mul(b): arrays of different length"));
+    if(b->typechar == typechar) {
+        __array_typed<T>(typechar, units.data(), [&](auto *p) {
+            const decltype(p) q = (decltype(p))b->units.data();
+            for(size_t i=0; i<len; i++)
+                p[i] = p[i] * q[i];
+        });
+    } else
+        for(size_t i=0; i<len; i++)
+            __setitem__(i, __getfast__(i) * b->__getfast__(i));
+    return NULL;
+}
+
 template<class T> void *array<T>::remove(T t) {
     this->pop(this->index(t));
     return NULL;
 }
 
 template<class T> T array<T>::pop(__ss_int i) {
+    resizing();
     size_t len = this->__len__();
     if(len==0)
         throw new IndexError(new str("pop from empty list"));
@@ -302,6 +498,7 @@ template<> inline __ss_float array<__ss_float>::__getfast__(__ss_int i) {
 }
 
 template<class T> void *array<T>::append(T t) {
+    resizing();
     fillbuf(t);
     for(unsigned int i=0; i<itemsize; i++)
         units.push_back(((char *)buffy)[i]);
@@ -319,6 +516,7 @@ template<class T> void *array<T>::__setitem__(__ss_int i, T t) {
 template<> void *array<str *>::__setitem__(__ss_int i, str *t);
 
 template<class T> void *array<T>::insert(__ss_int i, T t) {
+    resizing();
     i = __wrap(this, i);
     this->units.insert(this->units.begin()+(i*itemsize), itemsize, '\0');
     this->__setitem__(i, t);
@@ -326,6 +524,7 @@ template<class T> void *array<T>::insert(__ss_int i, T t) {
 }
 
 template<class T> void *array<T>::__delitem__(__ss_int i) {
+    resizing();
     i = __wrap(this, i);
     this->units.erase(units.begin()+(i*itemsize), units.begin()+((i+1)*itemsize));
     return NULL;
@@ -352,18 +551,12 @@ template<class T> void *array<T>::reverse() { /* use fillbuf, __setitem__ or sta
     return NULL;
 }
 
-template<class T> void *array<T>::byteswap() { /* standard C function? */
+template<class T> void *array<T>::byteswap() {
     size_t len = this->__len__();
-    for(size_t i=0; i<len; i++) {
-        char *first = &units[i*itemsize];
-        char *second = &units[((i+1)*itemsize)-1];
-        for(unsigned int j=0; j<itemsize/2; j++) {
-            char tmp = *first;
-            *first = *second;
-            *second = tmp;
-            first++;
-            second--;
-        }
+    switch(itemsize) {
+        case 2: __array_byteswap((uint16_t *)units.data(), len); break;
+        case 4: __array_byteswap((uint32_t *)units.data(), len); break;
+        case 8: __array_byteswap((uint64_t *)units.data(), len); break;
     }
     return NULL;
 }
@@ -374,6 +567,7 @@ template<class T> void *array<T>::tofile(file_binary *f) {
 }
 
 template<class T> void *array<T>::fromfile(file_binary *f, __ss_int n) {
+    resizing();
     bytes *s = f->read(n*itemsize);
     size_t len = s->__len__();
     size_t bytes = (len/itemsize)*itemsize;
@@ -414,6 +608,7 @@ template<class T> array<T> *array<T>::__slice__(__ss_int x, __ss_int l, __ss_int
 /* XXX optimize XXX */
 
 template<class T> void *array<T>::__setslice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s, array<T> *b) {
+    resizing();
     list<T> *l2 = this->tolist();
     l2->__setslice__(x, l, u, s, b->tolist());
     this->units.clear();
@@ -422,6 +617,7 @@ template<class T> void *array<T>::__setslice__(__ss_int x, __ss_int l, __ss_int
 }
 
 template<class T> void *array<T>::__delete__(__ss_int i) {
+    resizing();
     i = __wrap(this, i);
     this->units.erase(units.begin()+(i*itemsize), units.begin()+((i+1)*itemsize));
     return NULL;
@@ -430,6 +626,7 @@ template<class T> void *array<T>::__delete__(__ss_int i) {
 /* XXX optimize XXX */
 
 template<class T> void *array<T>::__delete__(__ss_int x, __ss_int l, __ss_int u, __ss_int s) {
+    resizing();
     list<T> *l2 = this->tolist();
     l2->__delete__(x, l, u, s);
     this->units.clear();
@@ -437,12 +634,85 @@ template<class T> void *array<T>::__delete__(__ss_int x, __ss_int l, __ss_int u,
     return NULL;
 }
 template<class T> void *array<T>::__delslice__(__ss_int a, __ss_int b) {
+    resizing();
     if(a>this->__len__()) return NULL;
     if(b>this->__len__()) b = this->__len__();
     units.erase(units.begin()+(a*itemsize),units.begin()+(b*itemsize));
     return NULL;
 }
 
+/* reductions (sum, min, max over an array, and dot products over two zipped arrays
+   are routed here by the compiler) */
+
+template<class T> T __sum(array<T> *a) {
+    size_t len = a->__len__();
+    T result = __zero<T>();
+    __array_typed<T>(a->typechar, a->units.data(), [&](auto *p) {
+        typedef std::remove_pointer_t<decltype(p)> S;
+        if(__array_exact<S>(false))
+            result = __array_result<S, T>(__sum_lanes<S, typename __array_acc<S>::type>(p, len));
+        else
+            for(size_t i=0; i<len; i++)
+                result += (T)p[i];
+    });
+    return result;
+}
+
+template<int C, class T> T __minmax(array<T> *a, const char *name) {
+    size_t len = a->__len__();
+    if(!len)
+        throw new ValueError(__add_strs(2, new str(name), new str("() arg is an empty sequence")));
+    T result = __zero<T>();
+    __array_typed<T>(a->typechar, a->units.data(), [&](auto *p) {
+        typedef std::remove_pointer_t<decltype(p)> S;
+        result = (T)__minmax_lanes<S, C>(p, len);
+    });
+    return result;
+}
+
+template<class T> T __min(array<T> *a) {
+    return __minmax<-1>(a, "min");
+}
+
+template<class T> T __max(array<T> *a) {
+    return __minmax<1>(a, "max");
+}
+
+template<class T> T __dot(array<T> *a, array<T> *b) { /* (stops at the shorter array, as zip does) */
+    size_t len = std::min(a->__len__(), b->__len__());
+    T result = __zero<T>();
+    bool done = false;
+    if(a->typechar == b->typechar)
+        __array_typed<T>(a->typechar, a->units.data(), [&](auto *p) {
+            typedef std::remove_pointer_t<decltype(p)> S;
+            if(__array_exact<S>(true)) {
+                result = __array_result<S, T>(__array_dot(p, (const S *)b->units.data(), len));
+                done = true;
+            }
+        });
+    if(!done)
+        for(size_t i=0; i<len; i++)
+            result += a->__getfast__(i) * b->__getfast__(i);
+    return result;
+}
+
+#ifdef __SS_BIND
+template<class T> array<T>::array(PyObject *p) {
+    this->__class__ = cl_array;
+    exports = 0;
+    Py_buffer view;
+    typechar = __buffer_typechar(p, &view, __buffer_typechars<T>());
+    typecode = __char_cache[(unsigned char)typechar];
+    itemsize = get_itemsize(typechar);
+    units.assign((char *)view.buf, (char *)view.buf + view.len);
+    PyBuffer_Release(&view);
+}
+
+template<class T> PyObject *array<T>::__to_py__() {
+    return __buffer_to_py(this, &units, &exports, typechar, itemsize);
+}
+#endif
+
 extern void * default_0;
 
 void __init();
@@ -63,6 +63,15 @@ class array:
     def __contains__(self, e):
         return True
 
+    def dot(self, b):
+        return self.unit
+    def scale(self, x):
+        pass
+    def elementwise_add(self, b):
+        pass
+    def elementwise_mul(self, b):
+        pass
+
     def byteswap(self):
         pass
     def reverse(self):
@@ -9,25 +9,43 @@
 #include <stdio.h>
 #include <errno.h>
 #include <limits.h>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#if !defined(WIN32) && !defined(__linux__)
+#include <sys/resource.h>
+#endif
+#ifndef WIN32
+#include <signal.h>
+#include <sys/mman.h>
+#endif
+#ifdef __SS_ARENA
+#include "builtin/arena.cpp"
+#endif
 
 namespace __shedskin__ {
 
 
 class_ *cl_class_, *cl_none, *cl_str_, *cl_int_, *cl_bool, *cl_float_, *cl_complex, *cl_list, *cl_tuple, *cl_dict, *cl_set, *cl_object, *cl_rangeiter, *cl_xrange, *cl_bytes;
 
-class_ *cl_stopiteration, *cl_assertionerror, *cl_eoferror, *cl_floatingpointerror, *cl_keyerror, *cl_indexerror, *cl_typeerror, *cl_valueerror, *cl_zerodivisionerror, *cl_keyboardinterrupt, *cl_memoryerror, *cl_nameerror, *cl_notimplementederror, *cl_oserror, *cl_overflowerror, *cl_runtimeerror, *cl_syntaxerror, *cl_systemerror, *cl_systemexit, *cl_filenotfounderror, *cl_arithmeticerror, *cl_lookuperror, *cl_exception, *cl_baseexception;
+class_ *cl_stopiteration, *cl_assertionerror, *cl_buffererror, *cl_eoferror, *cl_floatingpointerror, *cl_keyerror, *cl_indexerror, *cl_typeerror, *cl_valueerror, *cl_zerodivisionerror, *cl_keyboardinterrupt, *cl_memoryerror, *cl_nameerror, *cl_notimplementederror, *cl_oserror, *cl_overflowerror, *cl_runtimeerror, *cl_syntaxerror, *cl_systemerror, *cl_systemexit, *cl_filenotfounderror, *cl_arithmeticerror, *cl_lookuperror, *cl_exception, *cl_baseexception;
 
 str *sp, *nl, *__fmt_s, *__fmt_H, *__fmt_d;
 bytes *bsp;
 
 __GC_STRING ws, __fmtchars;
 __GC_VECTOR(str *) __char_cache;
+set<str *> *__intern_table;
 
 __ss_bool True;
 __ss_bool False;
 
-list<str *> *__join_cache;
-list<bytes *> *__join_cache_bin;
+#ifdef __SS_THREADS
+std::mutex __intern_lock;
+#endif
+
+__SS_THREAD_LOCAL list<str *> *__join_cache;
+__SS_THREAD_LOCAL list<bytes *> *__join_cache_bin;
 str *__case_swap_cache;
 
 char __str_cache[4000];
@@ -38,14 +56,95 @@ file *__ss_stdin, *__ss_stdout, *__ss_stderr;
 dict<void *, void *> *__ss_proxy;
 #endif
 
+unsigned long __gc_pause_total, __gc_pause_max;
+
+#ifndef __SS_ARENA
 void gc_warning_handler(char *, GC_word) {}
 
+static std::chrono::steady_clock::time_point __gc_pause_start;
+
+static void __gc_event(GC_EventType event) { /* (called with the gc lock held) */
+    if(event == GC_EVENT_START)
+        __gc_pause_start = std::chrono::steady_clock::now();
+    else if(event == GC_EVENT_END) {
+        unsigned long us = (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - __gc_pause_start).count();
+        __gc_pause_total += us;
+        if(us > __gc_pause_max)
+            __gc_pause_max = us;
+    }
+}
+#endif
+
+/* process and gc statistics at exit, as json (see 'shedskin bench' and gc.get_heap_stats) */
+
+static long __max_rss() { /* KB */
+#if defined(__linux__)
+    /* (not getrusage, as that includes the parent process before exec) */
+    char line[128];
+    long kb = -1;
+    FILE *f = fopen("/proc/self/status", "r");
+    if(f) {
+        while(fgets(line, sizeof(line), f))
+            if(sscanf(line, "VmHWM: %ld", &kb) == 1)
+                break;
+        fclose(f);
+    }
+    return kb;
+#elif !defined(WIN32)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+static void __stats_dump() {
+    const char *path = getenv("SHEDSKIN_STATS");
+    FILE *out = *path ? fopen(path, "w") : NULL;
+    if(!out)
+        out = stderr;
+    long rss = __max_rss();
+    if(rss >= 0)
+        fprintf(out, "{\"max_rss\": %ld, ", rss);
+    else
+        fprintf(out, "{\"max_rss\": null, ");
+#ifdef __SS_ARENA
+    /* (arena memory is never collected: report what is mapped as the heap size) */
+    fprintf(out, "\"gc\": {\"heap_size\": %lu, \"free_bytes\": 0, \"unmapped_bytes\": 0, \"bytes_since_gc\": 0, \"total_bytes\": %lu, ",
+        (unsigned long)__ss_arena_mapped(), (unsigned long)__ss_arena_mapped());
+    fprintf(out, "\"collections\": 0, \"pause_total_us\": 0, \"pause_max_us\": 0}}\n");
+#else
+    fprintf(out, "\"gc\": {\"heap_size\": %lu, \"free_bytes\": %lu, \"unmapped_bytes\": %lu, \"bytes_since_gc\": %lu, \"total_bytes\": %lu, ",
+        (unsigned long)GC_get_heap_size(), (unsigned long)GC_get_free_bytes(), (unsigned long)GC_get_unmapped_bytes(), (unsigned long)GC_get_bytes_since_gc(), (unsigned long)GC_get_total_bytes());
+    fprintf(out, "\"collections\": %lu, \"pause_total_us\": %lu, \"pause_max_us\": %lu}}\n",
+        (unsigned long)GC_get_gc_no(), __gc_pause_total, __gc_pause_max);
+#endif
+    if(out != stderr)
+        fclose(out);
+}
+
 void __init() {
+#ifndef __SS_ARENA
     GC_INIT();
     GC_set_warn_proc(gc_warning_handler);
+    GC_set_on_collection_event(__gc_event);
+#ifdef __SS_THREADS
+    GC_allow_register_threads();
+#endif
 #ifdef __SS_NOGC
     GC_disable();
 #endif
+#endif
+#ifdef __SS_PROFILE
+    __ss_prof_start();
+#endif
+    if(getenv("SHEDSKIN_STATS"))
+        atexit(__stats_dump);
 
 #ifdef __SS_BIND
     Py_Initialize();
@@ -83,11 +182,15 @@ void __init() {
         char c = (char)i;
         str *charstr = new str(&c, 1);
         charstr->charcache = 1;
+        charstr->interned = 1;
         __char_cache.push_back(charstr);
     }
+    __intern_table = new set<str *>();
 
+#ifndef __SS_THREADS
     __join_cache = new list<str *>();
     __join_cache_bin = new list<bytes *>();
+#endif
 
     for(int i=0; i<1000; i++) {
         __str_cache[4*i] = '0' + (char)(i % 10);
@@ -115,6 +218,7 @@ void __init() {
     cl_exception = new class_("Exception");
     cl_stopiteration = new class_("StopIteration");
     cl_assertionerror = new class_("AssertionError");
+    cl_buffererror = new class_("BufferError");
     cl_eoferror = new class_("EOFError");
     cl_floatingpointerror = new class_("FloatingPointError");
     cl_keyerror = new class_("KeyError");
@@ -159,6 +263,8 @@ __ss_bool class_::__eq__(pyobj *c) {
 #include "builtin/exception.cpp"
 #include "builtin/function.cpp"
 #include "builtin/format.cpp"
+#include "builtin/profile.cpp"
+#include "builtin/bigint.cpp"
 
 
 void __add_missing_newline() {
@@ -234,6 +340,14 @@ template<> PyObject *__to_py(__int128 i) {
     return _PyLong_FromByteArray((const unsigned char *)&i, sizeof(i), little_endian, 1);
 }
 
+#endif
+#ifdef __SS_BIGINT
+template<> PyObject *__to_py(__ss_bigint i) {
+    if(i.small())
+        return PyLong_FromLongLong(i.value());
+    std::string s = (i < 0 ? "-" : "") + __bi_digits(i, 16);
+    return PyLong_FromString(s.c_str(), NULL, 16);
+}
 #endif
 #ifdef WIN32
 template<> PyObject *__to_py(long i) { return PyLong_FromLong(i); }
@@ -255,10 +369,21 @@ void throw_exception() {
 template<> __ss_int __to_ss(PyObject *p) {
     if(PyLong_Check(p)) {
         __ss_int result;
-#ifdef __SS_INT128
+#if defined(__SS_INT128)
         int num = 1;
         bool little_endian = (*(char *)&num == 1);
         _PyLong_AsByteArray((PyLongObject *)p, (unsigned char *)&result, sizeof(__ss_int), little_endian, 1);
+#elif defined(__SS_BIGINT)
+        int overflow;
+        result = PyLong_AsLongLongAndOverflow(p, &overflow);
+        if(overflow) {
+            PyObject *h = PyNumber_ToBase(p, 16); /* ('-0x..') */
+            const char *c = PyUnicode_AsUTF8(h);
+            bool neg = (c[0] == '-');
+            result = __bi_parse(c + neg + 2, strlen(c + neg + 2), 16);
+            Py_DECREF(h);
+            return neg ? -result : result;
+        }
 #else
         result = (__ss_int)PyLong_AsLongLong(p);
 #endif
@@ -7,16 +7,25 @@
 #include <Python.h>
 #endif
 
+#ifdef __SS_ARENA
+#include "builtin/arena.hpp"
+#else
 #ifdef WIN32
 #define GC_NO_INLINE_STD_NEW
 #endif
+#ifdef __SS_THREADS
+#define GC_THREADS
+#endif
 #include <gc/gc_allocator.h>
 #include <gc/gc_cpp.h>
+#include <gc/gc_typed.h>
+#endif
 
 #include <vector>
 #include <deque>
 #include <bitset>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <unordered_map>
 #include <iostream>
@@ -30,6 +39,19 @@
 #include <ctype.h>
 #include <stdint.h>
 #include <limits>
+#include <type_traits>
+
+#ifdef __SS_THREADS
+#include <mutex>
+#endif
+
+#ifdef __SS_PROFILE
+#include <atomic>
+#ifndef WIN32
+#include <signal.h>
+#include <sys/time.h>
+#endif
+#endif
 
 #ifndef WIN32
 #include <cxxabi.h>
@@ -57,6 +79,10 @@ namespace __shedskin__ {
 #elif defined(__SS_INT128)
     typedef __int128 __ss_int;
 #define __SS_LONG
+#elif defined(__SS_BIGINT)
+#include "builtin/bigint.hpp"
+    typedef __ss_bigint __ss_int;
+#define __SS_LONG
 #else
     typedef int __ss_int;
 #endif
@@ -92,6 +118,16 @@ template <class T> class __iter;
 template<class T>
 using tuple = tuple2<T, T>;
 
+/* tuple returned by value (--vtuples), unpacked at the call site with std::tie */
+template<class ... Ts>
+using __vtuple = std::tuple<Ts ...>;
+
+/* local storage for an object that does not escape the function creating it (placement new) */
+template<class T>
+struct __ss_stack {
+    alignas(T) char data[sizeof(T)];
+};
+
 /* STL types */
 
 // TODO switch to template aliases
@@ -99,6 +135,14 @@ using tuple = tuple2<T, T>;
 #define __GC_DEQUE(T) std::deque< T, gc_allocator< T > >
 #define __GC_STRING std::basic_string<char,std::char_traits<char>,gc_allocator<char> >
 
+/* pointer-free buffers that long-lived runtime objects grow as they are used. with --arena,
+   these are malloc'ed, so that they survive gc.arena_reset */
+#ifdef __SS_ARENA
+#define __GC_BUFFER(T) std::vector< T >
+#else
+#define __GC_BUFFER(T) __GC_VECTOR(T)
+#endif
+
 extern __ss_bool True;
 extern __ss_bool False;
 
@@ -106,14 +150,33 @@ extern __ss_bool False;
 
 extern class_ *cl_str_, *cl_int_, *cl_bool, *cl_float_, *cl_complex, *cl_list, *cl_tuple, *cl_dict, *cl_set, *cl_object, *cl_xrange, *cl_rangeiter, *cl_bytes;
 
+/* with threads (there is no GIL), runtime scratch state is kept per thread. as thread-local
+   storage is not scanned by the GC, such state is allocated lazily, as uncollectable */
+
+#ifdef __SS_THREADS
+#define __SS_THREAD_LOCAL thread_local
+#else
+#define __SS_THREAD_LOCAL
+#endif
+
 extern __GC_VECTOR(str *) __char_cache;
+extern set<str *> *__intern_table;
+#ifdef __SS_THREADS
+extern std::mutex __intern_lock;
+#endif
 
-extern list<str *> *__join_cache;
-extern list<bytes *> *__join_cache_bin;
+extern __SS_THREAD_LOCAL list<str *> *__join_cache;
+extern __SS_THREAD_LOCAL list<bytes *> *__join_cache_bin;
 
 extern str *nl;
 extern str *sp;
 
+/* time spent in garbage collections, in microseconds (see gc.get_heap_stats) */
+extern unsigned long __gc_pause_total, __gc_pause_max;
+
+#include "builtin/gc_typed.hpp"
+#include "builtin/profile.hpp"
+
 /* root object class */
 
 class pyobj : public gc {
@@ -196,6 +259,10 @@ public:
 #undef SS_DECL
 
 static inline __ss_bool __mbool(bool c) { __ss_bool b; b.value=c?1:0; return b; }
+#ifdef __SS_BIGINT
+template<class T, typename std::enable_if<std::is_same<T, __ss_bigint>::value, int>::type = 0>
+static inline __ss_bool __mbool(T c) { return __mbool((bool)c); }
+#endif
 
 void __throw_index_out_of_range();
 void __throw_range_step_zero();
@@ -225,12 +292,14 @@ template<class T> static inline int __wrap(T a, __ss_int i) {
 #include "builtin/hash.hpp"
 #include "builtin/str.hpp"
 #include "builtin/compare.hpp"
+#include "builtin/sort.hpp"
+#include "builtin/hashtable.hpp"
 
 template <class K, class V>
-using __GC_DICT = std::unordered_map<K, V, ss_hash<K>, ss_eq<K>, gc_allocator< std::pair<K const, V> > >;
+using __GC_DICT = __dicttable<K, V>;
 
 template <class T>
-using __GC_SET = std::unordered_set<T, ss_hash<T>, ss_eq<T>, gc_allocator< T > >;
+using __GC_SET = __settable<T>;
 
 class class_: public pyobj {
 public:
@@ -800,6 +800,7 @@ class SystemExit(BaseException): pass
 class Exception(BaseException): pass
 
 class AssertionError(Exception): pass
+class BufferError(Exception): pass
 class EOFError(Exception): pass
 class MemoryError(Exception): pass
 class NameError(Exception): pass
@@ -877,7 +878,7 @@ def input(msg=''):
     return ''
 
 class file(pyiter):
-    def __init__(self, name, flags=None):
+    def __init__(self, name, flags=None, buffering=-1):
         self.unit = ''
         self.closed = 0
         self.name = ''
@@ -931,7 +932,7 @@ class file(pyiter):
 
 # TODO share base class with file
 class file_binary(pyiter):
-    def __init__(self, name, flags=None):
+    def __init__(self, name, flags=None, buffering=-1):
         self.unit = b''
         self.closed = 0
         self.name = ''
@@ -982,11 +983,11 @@ class file_binary(pyiter):
     def __next__(self):
         return self.unit
 
-def open(name, flags=None):
-    return file(name, flags)
+def open(name, flags=None, buffering=-1):
+    return file(name, flags, buffering)
 
-def open_binary(name, flags=None):
-    return file_binary(name, flags)
+def open_binary(name, flags=None, buffering=-1):
+    return file_binary(name, flags, buffering)
 
 def ord(c):
     return 1
@@ -0,0 +1,156 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+/* region allocation (--arena) */
+
+#ifdef __SS_ARENA
+
+struct alignas(__SS_ARENA_ALIGN) __ss_chunk {
+    __ss_chunk *prev;
+    size_t size; /* of the mapping, including this header */
+    size_t offset; /* region position of the first data byte */
+    char *top; /* end of used data, once no longer the current chunk */
+
+    char *data() { return (char *)(this + 1); }
+    char *limit() { return (char *)this + size; }
+};
+
+__SS_ARENA_LOCAL __ss_region __ss_arena, __ss_arena_kept;
+
+static std::atomic<size_t> __ss_arena_mapped_bytes;
+
+size_t __ss_arena_mapped() {
+    return __ss_arena_mapped_bytes.load();
+}
+
+static __ss_chunk *__ss_arena_map(size_t size) {
+    char *p;
+#if defined(__linux__)
+    /* align to the huge page size, so the kernel can back the chunk with huge pages */
+    char *raw = (char *)mmap(NULL, size + __SS_ARENA_CHUNK, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(raw == MAP_FAILED)
+        throw std::bad_alloc();
+    p = (char *)(((size_t)raw + __SS_ARENA_CHUNK - 1) & ~(size_t)(__SS_ARENA_CHUNK - 1));
+    if(p != raw)
+        munmap(raw, p - raw);
+    if(p + size != raw + size + __SS_ARENA_CHUNK)
+        munmap(p + size, (raw + size + __SS_ARENA_CHUNK) - (p + size));
+#ifdef MADV_HUGEPAGE
+    madvise(p, size, MADV_HUGEPAGE);
+#endif
+#elif !defined(WIN32)
+    p = (char *)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(p == MAP_FAILED)
+        throw std::bad_alloc();
+#else
+    p = (char *)calloc(1, size);
+    if(!p)
+        throw std::bad_alloc();
+#endif
+    __ss_arena_mapped_bytes += size;
+    __ss_chunk *c = (__ss_chunk *)p;
+    c->size = size;
+    return c;
+}
+
+static void __ss_arena_unmap(__ss_chunk *c) {
+    __ss_arena_mapped_bytes -= c->size;
+#ifndef WIN32
+    munmap((void *)c, c->size);
+#else
+    free(c);
+#endif
+}
+
+static size_t __ss_arena_position(__ss_region *r) {
+    if(!r->chunks)
+        return 0;
+    return r->chunks->offset + (r->cur - r->base);
+}
+
+static void __ss_arena_push(__ss_region *r, __ss_chunk *c) {
+    c->offset = __ss_arena_position(r);
+    if(r->chunks)
+        r->chunks->top = r->cur;
+    c->prev = r->chunks;
+    c->top = NULL;
+    r->chunks = c;
+    r->base = r->cur = c->data();
+    r->end = c->limit();
+}
+
+void *__ss_arena_grow(size_t size) {
+    __ss_region *r = &__ss_arena;
+    if(size > __SS_ARENA_LARGE) {
+        size_t bytes = (sizeof(__ss_chunk) + size + 4095) & ~(size_t)4095;
+        __ss_arena_push(r, __ss_arena_map(bytes));
+        r->cur = r->end = r->base + size; /* full */
+        return r->base;
+    }
+    __ss_chunk *c = r->spare;
+    if(c)
+        r->spare = c->prev;
+    else
+        c = __ss_arena_map(__SS_ARENA_CHUNK);
+    __ss_arena_push(r, c);
+    void *p = r->cur;
+    r->cur += size;
+    return p;
+}
+
+size_t __ss_arena_mark() {
+    return __ss_arena_position(&__ss_arena);
+}
+
+bool __ss_arena_reset(size_t mark) {
+    __ss_region *r = &__ss_arena;
+    if(r->keep || mark > __ss_arena_position(r))
+        return false;
+
+    /* release chunks started after the mark, keeping a few for reuse */
+    int spare = 0;
+    for(__ss_chunk *c = r->spare; c; c = c->prev)
+        spare++;
+    while(r->chunks && r->chunks->offset > mark) {
+        __ss_chunk *c = r->chunks;
+        char *top = c->top ? c->top : r->cur;
+        r->chunks = c->prev;
+        if(r->chunks) {
+            r->base = r->chunks->data();
+            r->cur = r->chunks->top;
+            r->end = r->chunks->limit();
+        }
+        if(c->size == __SS_ARENA_CHUNK && spare < 4) {
+            memset(c->data(), 0, top - c->data());
+            c->prev = r->spare;
+            r->spare = c;
+            spare++;
+        } else
+            __ss_arena_unmap(c);
+    }
+
+    if(!r->chunks) {
+        r->base = r->cur = r->end = NULL;
+        return true;
+    }
+    char *p = r->base + (mark - r->chunks->offset);
+    memset(p, 0, r->cur - p);
+    r->cur = p;
+    r->chunks->top = NULL;
+    return true;
+}
+
+__ss_arena_keep::__ss_arena_keep() {
+    if(!__ss_arena.keep++) { /* outermost: switch regions, carrying the nesting count */
+        std::swap(__ss_arena, __ss_arena_kept);
+        __ss_arena.keep = __ss_arena_kept.keep;
+    }
+}
+
+__ss_arena_keep::~__ss_arena_keep() {
+    if(!--__ss_arena.keep) {
+        __ss_arena_kept.keep = 0;
+        std::swap(__ss_arena, __ss_arena_kept);
+    }
+}
+
+#endif
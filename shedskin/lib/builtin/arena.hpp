@@ -0,0 +1,140 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef SS_ARENA_HPP
+#define SS_ARENA_HPP
+
+/* region allocation (--arena)
+
+   instead of by the garbage collector, memory is handed out by bumping a pointer through large
+   per-thread chunks (backed by transparent huge pages where available), and is never collected.
+   gc.arena_mark() and gc.arena_reset(mark) release everything the calling thread allocated
+   since the mark in one go, for request/response-style loops. runtime state that must survive
+   a reset (such as the compiled pattern cache) is allocated from a second region that is never
+   reset, by holding an __ss_arena_keep. memory in that region is never reclaimed: what is
+   dropped from such state (say, a pattern evicted from the cache) stays allocated.
+
+   memory is handed out zeroed, as with the GC: fresh chunks are, and released memory is cleared.
+
+   the rest of the runtime uses the subset of the boehm API defined below. */
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef __SS_THREADS
+#define __SS_ARENA_LOCAL thread_local
+#else
+#define __SS_ARENA_LOCAL
+#endif
+
+#define __SS_ARENA_ALIGN 16
+#define __SS_ARENA_CHUNK (2 << 20) /* huge page size */
+#define __SS_ARENA_LARGE (__SS_ARENA_CHUNK / 4) /* larger allocations get their own chunk */
+
+struct __ss_chunk;
+
+struct __ss_region {
+    char *cur, *end;
+    char *base; /* start of data in the current chunk */
+    __ss_chunk *chunks; /* most recent first */
+    __ss_chunk *spare;
+    int keep; /* __ss_arena_keep nesting */
+};
+
+extern __SS_ARENA_LOCAL __ss_region __ss_arena, __ss_arena_kept;
+
+void *__ss_arena_grow(size_t size);
+size_t __ss_arena_mark();
+bool __ss_arena_reset(size_t mark);
+size_t __ss_arena_mapped();
+
+inline size_t __ss_arena_round(size_t size) {
+    return size ? (size + __SS_ARENA_ALIGN - 1) & ~(size_t)(__SS_ARENA_ALIGN - 1) : __SS_ARENA_ALIGN;
+}
+
+inline void *__ss_arena_alloc(size_t size) {
+    size = __ss_arena_round(size);
+    if((size_t)(__ss_arena.end - __ss_arena.cur) < size)
+        return __ss_arena_grow(size);
+    void *p = __ss_arena.cur;
+    __ss_arena.cur += size;
+    return p;
+}
+
+/* the last allocation can be given back (so growing a container wastes less) */
+inline void __ss_arena_free(void *p, size_t size) {
+    size = __ss_arena_round(size);
+    if((char *)p >= __ss_arena.base && (char *)p + size == __ss_arena.cur) {
+        memset(p, 0, size);
+        __ss_arena.cur = (char *)p;
+    }
+}
+
+/* allocate from the region that is never reset, while in scope */
+struct __ss_arena_keep {
+    __ss_arena_keep();
+    ~__ss_arena_keep();
+};
+
+/* boehm API subset */
+
+typedef unsigned long GC_word;
+
+enum GCPlacement { UseGC, NoGC, PointerFreeGC };
+
+class gc {
+public:
+    inline void *operator new(size_t size) { return __ss_arena_alloc(size); }
+    inline void *operator new(size_t size, GCPlacement gcp) { return gcp == NoGC ? calloc(1, size) : __ss_arena_alloc(size); }
+    inline void *operator new(size_t, void *p) { return p; }
+    inline void operator delete(void *) {}
+    inline void operator delete(void *, GCPlacement) {}
+    inline void operator delete(void *, void *) {}
+    inline void *operator new[](size_t size) { return __ss_arena_alloc(size); }
+    inline void *operator new[](size_t size, GCPlacement gcp) { return gcp == NoGC ? calloc(1, size) : __ss_arena_alloc(size); }
+    inline void *operator new[](size_t, void *p) { return p; }
+    inline void operator delete[](void *) {}
+    inline void operator delete[](void *, GCPlacement) {}
+    inline void operator delete[](void *, void *) {}
+};
+
+template<class T> class gc_allocator {
+public:
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T value_type;
+
+    template<class U> struct rebind {
+        typedef gc_allocator<U> other;
+    };
+
+    gc_allocator() noexcept {}
+    gc_allocator(const gc_allocator &) noexcept {}
+    template<class U> gc_allocator(const gc_allocator<U> &) noexcept {}
+
+    T *allocate(size_t n, const void * = 0) { return (T *)__ss_arena_alloc(n * sizeof(T)); }
+    void deallocate(T *p, size_t n) { __ss_arena_free(p, n * sizeof(T)); }
+    size_t max_size() const noexcept { return size_t(-1) / sizeof(T); }
+};
+
+template<class T, class U> inline bool operator==(const gc_allocator<T> &, const gc_allocator<U> &) { return true; }
+template<class T, class U> inline bool operator!=(const gc_allocator<T> &, const gc_allocator<U> &) { return false; }
+
+struct GC_true_type {};
+struct GC_false_type {};
+template<class T> struct GC_type_traits { GC_false_type GC_is_ptr_free; };
+
+typedef void (*GC_finalization_proc)(void *, void *);
+inline void GC_register_finalizer_no_order(void *, GC_finalization_proc, void *, GC_finalization_proc *, void **) {}
+
+#define GC_MALLOC(n) __ss_arena_alloc(n)
+#define GC_MALLOC_ATOMIC(n) __ss_arena_alloc(n)
+#define GC_malloc(n) __ss_arena_alloc(n)
+#define GC_FREE(p) ((void)(p))
+
+#endif
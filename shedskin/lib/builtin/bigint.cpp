@@ -0,0 +1,550 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+/* arbitrary-precision integers (--bigint): bignum slow paths
+
+   operands are unpacked into a sign and a magnitude (little-endian 32-bit limbs), and results
+   packed again, as a small value when they fit */
+
+#ifdef __SS_BIGINT
+
+typedef std::vector<uint32_t> __bi_mag;
+
+static void __bi_unpack(__ss_bigint a, int &sign, __bi_mag &m) {
+    m.clear();
+    if(a.small()) {
+        intptr_t v = a.value();
+        sign = v < 0 ? -1 : (v > 0);
+        unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        while(u) {
+            m.push_back((uint32_t)u);
+            u >>= 32;
+        }
+    } else {
+        __ss_bignum *b = a.big();
+        sign = b->size < 0 ? -1 : 1;
+        m.assign(b->limbs, b->limbs + (b->size < 0 ? -b->size : b->size));
+    }
+}
+
+static void __bi_trim(__bi_mag &m) {
+    while(!m.empty() && m.back() == 0)
+        m.pop_back();
+}
+
+static __ss_bigint __bi_pack(int sign, __bi_mag &m) {
+    __bi_trim(m);
+    if(m.empty())
+        return __ss_bigint();
+    if(m.size() <= 2) {
+        unsigned long long u = m[0] | (m.size() == 2 ? (unsigned long long)m[1] << 32 : 0);
+        if(sign > 0 && u < (1ULL << 62))
+            return __ss_bigint::fits((intptr_t)u);
+        if(sign < 0 && u <= (1ULL << 62))
+            return __ss_bigint::fits(-(intptr_t)u);
+    }
+    __ss_bignum *b = (__ss_bignum *)GC_MALLOC_ATOMIC(sizeof(__ss_bignum) + (m.size() - 1) * sizeof(uint32_t));
+    b->size = sign < 0 ? -(int)m.size() : (int)m.size();
+    memcpy(b->limbs, m.data(), m.size() * sizeof(uint32_t));
+    return __ss_bigint::raw((intptr_t)b);
+}
+
+/* magnitudes */
+
+static int __bi_mag_cmp(const __bi_mag &a, const __bi_mag &b) {
+    if(a.size() != b.size())
+        return a.size() < b.size() ? -1 : 1;
+    for(size_t i = a.size(); i-- > 0;)
+        if(a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+    return 0;
+}
+
+static void __bi_mag_add(const __bi_mag &a, const __bi_mag &b, __bi_mag &r) {
+    const __bi_mag &x = a.size() >= b.size() ? a : b;
+    const __bi_mag &y = a.size() >= b.size() ? b : a;
+    r.resize(x.size() + 1);
+    unsigned long long carry = 0;
+    for(size_t i = 0; i < x.size(); i++) {
+        carry += (unsigned long long)x[i] + (i < y.size() ? y[i] : 0);
+        r[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    r[x.size()] = (uint32_t)carry;
+}
+
+static void __bi_mag_sub(const __bi_mag &a, const __bi_mag &b, __bi_mag &r) { /* (a >= b) */
+    r.resize(a.size());
+    long long borrow = 0;
+    for(size_t i = 0; i < a.size(); i++) {
+        long long d = (long long)a[i] - (i < b.size() ? b[i] : 0) - borrow;
+        borrow = d < 0;
+        r[i] = (uint32_t)(d + (borrow << 32));
+    }
+}
+
+static void __bi_mag_mul(const __bi_mag &a, const __bi_mag &b, __bi_mag &r) {
+    r.assign(a.size() + b.size(), 0);
+    for(size_t i = 0; i < a.size(); i++) {
+        unsigned long long carry = 0;
+        for(size_t j = 0; j < b.size(); j++) {
+            carry += (unsigned long long)a[i] * b[j] + r[i + j];
+            r[i + j] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        r[i + b.size()] = (uint32_t)carry;
+    }
+}
+
+static uint32_t __bi_mag_divmod1(__bi_mag &a, uint32_t d) { /* (in place, returns remainder) */
+    unsigned long long rem = 0;
+    for(size_t i = a.size(); i-- > 0;) {
+        rem = (rem << 32) | a[i];
+        a[i] = (uint32_t)(rem / d);
+        rem %= d;
+    }
+    __bi_trim(a);
+    return (uint32_t)rem;
+}
+
+/* long division (Knuth, TAOCP vol. 2, algorithm D) */
+static void __bi_mag_divmod(const __bi_mag &a, const __bi_mag &b, __bi_mag &q, __bi_mag &r) {
+    if(__bi_mag_cmp(a, b) < 0) {
+        q.clear();
+        r = a;
+        return;
+    }
+    if(b.size() == 1) {
+        q = a;
+        r.assign(1, __bi_mag_divmod1(q, b[0]));
+        __bi_trim(r);
+        return;
+    }
+
+    /* normalize, so that the top limb of the divisor has its high bit set */
+    int s = __builtin_clz(b.back());
+    size_t n = b.size(), m = a.size() - n;
+    __bi_mag u(a.size() + 1), v(n);
+    for(size_t i = n; i-- > 0;)
+        v[i] = (b[i] << s) | (s && i ? (uint32_t)((unsigned long long)b[i - 1] >> (32 - s)) : 0);
+    u[a.size()] = s ? (uint32_t)((unsigned long long)a.back() >> (32 - s)) : 0;
+    for(size_t i = a.size(); i-- > 0;)
+        u[i] = (a[i] << s) | (s && i ? (uint32_t)((unsigned long long)a[i - 1] >> (32 - s)) : 0);
+
+    q.assign(m + 1, 0);
+    for(size_t j = m + 1; j-- > 0;) {
+        unsigned long long num = ((unsigned long long)u[j + n] << 32) | u[j + n - 1];
+        unsigned long long qhat = num / v[n - 1], rhat = num % v[n - 1];
+        while(qhat >> 32 || qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2])) {
+            qhat--;
+            rhat += v[n - 1];
+            if(rhat >> 32)
+                break;
+        }
+
+        /* multiply and subtract */
+        long long borrow = 0;
+        unsigned long long carry = 0;
+        for(size_t i = 0; i < n; i++) {
+            unsigned long long p = qhat * v[i] + carry;
+            carry = p >> 32;
+            long long t = (long long)u[i + j] - borrow - (long long)(uint32_t)p;
+            borrow = t < 0;
+            u[i + j] = (uint32_t)(t + (borrow << 32));
+        }
+        long long t = (long long)u[j + n] - borrow - (long long)carry;
+        borrow = t < 0;
+        u[j + n] = (uint32_t)t;
+
+        /* add back (rare) */
+        if(borrow) {
+            qhat--;
+            unsigned long long c = 0;
+            for(size_t i = 0; i < n; i++) {
+                c += (unsigned long long)u[i + j] + v[i];
+                u[i + j] = (uint32_t)c;
+                c >>= 32;
+            }
+            u[j + n] += (uint32_t)c;
+        }
+        q[j] = (uint32_t)qhat;
+    }
+    __bi_trim(q);
+
+    /* unnormalize the remainder */
+    r.resize(n);
+    for(size_t i = 0; i < n; i++)
+        r[i] = (u[i] >> s) | (s ? (uint32_t)((unsigned long long)u[i + 1] << (32 - s)) : 0);
+    __bi_trim(r);
+}
+
+/* construction and conversion */
+
+__ss_bigint __bi_from_ull(unsigned long long u) {
+    __bi_mag m;
+    m.push_back((uint32_t)u);
+    m.push_back((uint32_t)(u >> 32));
+    return __bi_pack(1, m);
+}
+
+__ss_bigint __bi_from_ll(long long v) {
+    __ss_bigint a = __bi_from_ull(v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v);
+    return v < 0 ? -a : a;
+}
+
+__ss_bigint __bi_from_double(double d) {
+    if(std::isnan(d))
+        throw new ValueError(new str("cannot convert float NaN to integer"));
+    if(std::isinf(d))
+        throw new OverflowError(new str("cannot convert float infinity to integer"));
+    d = std::trunc(d);
+    if(d > -4.6e18 && d < 4.6e18)
+        return __ss_bigint((long long)d);
+    int exp;
+    double f = std::frexp(std::fabs(d), &exp); /* (d = f * 2**exp, 0.5 <= f < 1) */
+    __ss_bigint a = __bi_from_ull((unsigned long long)std::ldexp(f, 53)) << (exp - 53);
+    return d < 0 ? -a : a;
+}
+
+double __bi_to_double(__ss_bigint a) {
+    if(a.small())
+        return (double)a.value();
+    int sign;
+    __bi_mag m;
+    __bi_unpack(a, sign, m);
+    /* the top 64 bits, with any lower bits folded into the lowest (so rounding to 53 bits is
+       still correct) */
+    int s = __builtin_clz(m.back());
+    size_t n = m.size();
+    unsigned long long hi = ((unsigned long long)m[n - 1] << 32) | m[n - 2];
+    uint32_t rest = n > 2 ? m[n - 3] : 0;
+    hi = s ? (hi << s) | (rest >> (32 - s)) : hi;
+    bool sticky = (uint32_t)(rest << s) != 0;
+    for(size_t i = 0; i + 3 < n && !sticky; i++)
+        sticky = m[i] != 0;
+    double d = std::ldexp((double)(hi | sticky), (int)(n * 32) - s - 64);
+    if(std::isinf(d))
+        throw new OverflowError(new str("int too large to convert to float"));
+    return sign < 0 ? -d : d;
+}
+
+unsigned long long __bi_to_ull(__ss_bigint a) { /* (modulo 2**64, as a fixed-size conversion) */
+    if(a.small())
+        return (unsigned long long)(long long)a.value();
+    __ss_bignum *b = a.big();
+    int n = b->size < 0 ? -b->size : b->size;
+    unsigned long long u = b->limbs[0] | (n > 1 ? (unsigned long long)b->limbs[1] << 32 : 0);
+    return b->size < 0 ? 0ULL - u : u;
+}
+
+bool __bi_fits_ll(__ss_bigint a) {
+    if(a.small())
+        return true;
+    __ss_bignum *b = a.big();
+    if(b->size > 2 || b->size < -2)
+        return false;
+    unsigned long long u = __bi_to_ull(b->size < 0 ? -a : a);
+    return b->size < 0 ? u <= (1ULL << 63) : u < (1ULL << 63);
+}
+
+__ss_bigint __bi_parse(const char *s, size_t len, int base) { /* (digits only, with optional sign) */
+    size_t i = 0;
+    int sign = 1;
+    if(i < len && (s[i] == '-' || s[i] == '+'))
+        sign = s[i++] == '-' ? -1 : 1;
+    __bi_mag m;
+    uint32_t chunk = 0, scale = 1;
+    for(; i < len; i++) {
+        if(s[i] == '_')
+            continue;
+        int c = ::tolower((unsigned char)s[i]);
+        int d = ::isdigit(c) ? c - '0' : c - 'a' + 10;
+        chunk = chunk * (uint32_t)base + (uint32_t)d;
+        scale *= (uint32_t)base;
+        if(scale > 0xffffffffu / (uint32_t)base || i == len - 1) {
+            unsigned long long carry = chunk;
+            for(size_t k = 0; k < m.size(); k++) {
+                carry += (unsigned long long)m[k] * scale;
+                m[k] = (uint32_t)carry;
+                carry >>= 32;
+            }
+            if(carry)
+                m.push_back((uint32_t)carry);
+            chunk = 0;
+            scale = 1;
+        }
+    }
+    if(scale > 1) { /* (trailing underscores) */
+        unsigned long long carry = chunk;
+        for(size_t k = 0; k < m.size(); k++) {
+            carry += (unsigned long long)m[k] * scale;
+            m[k] = (uint32_t)carry;
+            carry >>= 32;
+        }
+        if(carry)
+            m.push_back((uint32_t)carry);
+    }
+    return __bi_pack(sign, m);
+}
+
+std::string __bi_digits(__ss_bigint a, int base) {
+    int sign;
+    __bi_mag m;
+    __bi_unpack(a, sign, m);
+    if(m.empty())
+        return "0";
+    /* divide by the largest power of base that fits in a limb */
+    uint32_t chunk = (uint32_t)base;
+    int per = 1;
+    while((unsigned long long)chunk * (uint32_t)base <= 0xffffffffULL) {
+        chunk *= (uint32_t)base;
+        per++;
+    }
+    std::string r;
+    while(!m.empty()) {
+        uint32_t rem = __bi_mag_divmod1(m, chunk);
+        for(int k = 0; k < per && (rem || !m.empty()); k++) {
+            r += "0123456789abcdefghijklmnopqrstuvwxyz"[rem % (uint32_t)base];
+            rem /= (uint32_t)base;
+        }
+    }
+    std::reverse(r.begin(), r.end());
+    return r;
+}
+
+/* arithmetic */
+
+void __bi_zero_division() {
+    throw new ZeroDivisionError(new str("integer division or modulo by zero"));
+}
+
+__ss_bigint __bi_add(__ss_bigint a, __ss_bigint b) {
+    int sa, sb;
+    __bi_mag x, y, r;
+    __bi_unpack(a, sa, x);
+    __bi_unpack(b, sb, y);
+    if(sa == 0)
+        return b;
+    if(sb == 0)
+        return a;
+    if(sa == sb) {
+        __bi_mag_add(x, y, r);
+        return __bi_pack(sa, r);
+    }
+    int c = __bi_mag_cmp(x, y);
+    if(c == 0)
+        return __ss_bigint();
+    if(c > 0) {
+        __bi_mag_sub(x, y, r);
+        return __bi_pack(sa, r);
+    }
+    __bi_mag_sub(y, x, r);
+    return __bi_pack(sb, r);
+}
+
+__ss_bigint __bi_neg(__ss_bigint a) {
+    int sign;
+    __bi_mag m;
+    __bi_unpack(a, sign, m);
+    return __bi_pack(-sign, m);
+}
+
+__ss_bigint __bi_sub(__ss_bigint a, __ss_bigint b) {
+    return __bi_add(a, __bi_neg(b));
+}
+
+__ss_bigint __bi_mul(__ss_bigint a, __ss_bigint b) {
+    int sa, sb;
+    __bi_mag x, y, r;
+    __bi_unpack(a, sa, x);
+    __bi_unpack(b, sb, y);
+    if(sa == 0 || sb == 0)
+        return __ss_bigint();
+    __bi_mag_mul(x, y, r);
+    return __bi_pack(sa * sb, r);
+}
+
+static void __bi_divmod(__ss_bigint a, __ss_bigint b, __ss_bigint &q, __ss_bigint &r) { /* (truncating) */
+    int sa, sb;
+    __bi_mag x, y, mq, mr;
+    __bi_unpack(a, sa, x);
+    __bi_unpack(b, sb, y);
+    if(sb == 0)
+        __bi_zero_division();
+    __bi_mag_divmod(x, y, mq, mr);
+    q = __bi_pack(sa * sb, mq);
+    r = __bi_pack(sa, mr);
+}
+
+__ss_bigint __bi_div(__ss_bigint a, __ss_bigint b) {
+    __ss_bigint q, r;
+    __bi_divmod(a, b, q, r);
+    return q;
+}
+
+__ss_bigint __bi_mod(__ss_bigint a, __ss_bigint b) {
+    __ss_bigint q, r;
+    __bi_divmod(a, b, q, r);
+    return r;
+}
+
+__ss_bigint __bi_floordiv(__ss_bigint a, __ss_bigint b) {
+    __ss_bigint q, r;
+    __bi_divmod(a, b, q, r);
+    if(r != 0 && ((r < 0) != (b < 0)))
+        q = q - 1;
+    return q;
+}
+
+__ss_bigint __bi_floormod(__ss_bigint a, __ss_bigint b) {
+    __ss_bigint q, r;
+    __bi_divmod(a, b, q, r);
+    if(r != 0 && ((r < 0) != (b < 0)))
+        r = r + b;
+    return r;
+}
+
+int __bi_cmp(__ss_bigint a, __ss_bigint b) {
+    int sa, sb;
+    __bi_mag x, y;
+    __bi_unpack(a, sa, x);
+    __bi_unpack(b, sb, y);
+    if(sa != sb)
+        return sa < sb ? -1 : 1;
+    int c = __bi_mag_cmp(x, y);
+    return sa < 0 ? -c : c;
+}
+
+/* shifts and bitwise operations */
+
+static size_t __bi_shift_count(__ss_bigint b) {
+    if(b < 0)
+        throw new ValueError(new str("negative shift count"));
+    if(!b.small() || b.value() > (1L << 30))
+        throw new OverflowError(new str("too many digits in integer"));
+    return (size_t)b.value();
+}
+
+__ss_bigint __bi_shl(__ss_bigint a, __ss_bigint b) {
+    size_t n = __bi_shift_count(b);
+    int sign;
+    __bi_mag m, r;
+    __bi_unpack(a, sign, m);
+    if(sign == 0)
+        return a;
+    size_t limbs = n / 32, bits = n % 32;
+    r.assign(limbs + m.size() + 1, 0);
+    for(size_t i = 0; i < m.size(); i++) {
+        unsigned long long v = (unsigned long long)m[i] << bits;
+        r[i + limbs] |= (uint32_t)v;
+        r[i + limbs + 1] |= (uint32_t)(v >> 32);
+    }
+    return __bi_pack(sign, r);
+}
+
+__ss_bigint __bi_shr(__ss_bigint a, __ss_bigint b) {
+    size_t n = __bi_shift_count(b);
+    if(a < 0) /* (rounds towards minus infinity) */
+        return -__bi_shr(-a - 1, b) - 1;
+    int sign;
+    __bi_mag m, r;
+    __bi_unpack(a, sign, m);
+    size_t limbs = n / 32, bits = n % 32;
+    if(limbs >= m.size())
+        return __ss_bigint();
+    r.assign(m.size() - limbs, 0);
+    for(size_t i = 0; i < r.size(); i++) {
+        unsigned long long v = m[i + limbs] | (i + limbs + 1 < m.size() ? (unsigned long long)m[i + limbs + 1] << 32 : 0);
+        r[i] = (uint32_t)(v >> bits);
+    }
+    return __bi_pack(sign, r);
+}
+
+/* two's complement over n limbs (negative values sign-extend with ones) */
+static void __bi_twos(__ss_bigint a, size_t n, __bi_mag &t) {
+    int sign;
+    __bi_unpack(a, sign, t);
+    t.resize(n, 0);
+    if(sign < 0) {
+        unsigned long long carry = 1;
+        for(size_t i = 0; i < n; i++) {
+            carry += (uint32_t)~t[i];
+            t[i] = (uint32_t)carry;
+            carry >>= 32;
+        }
+    }
+}
+
+static __ss_bigint __bi_from_twos(__bi_mag &t) {
+    if(!(t.back() >> 31))
+        return __bi_pack(1, t);
+    unsigned long long carry = 1;
+    for(size_t i = 0; i < t.size(); i++) {
+        carry += (uint32_t)~t[i];
+        t[i] = (uint32_t)carry;
+        carry >>= 32;
+    }
+    return __bi_pack(-1, t);
+}
+
+static __ss_bigint __bi_bitwise(__ss_bigint a, __ss_bigint b, char op) {
+    int sign;
+    __bi_mag x, y;
+    __bi_unpack(a, sign, x);
+    size_t n = x.size();
+    __bi_unpack(b, sign, y);
+    n = std::max(n, y.size()) + 1;
+    __bi_twos(a, n, x);
+    __bi_twos(b, n, y);
+    for(size_t i = 0; i < n; i++)
+        x[i] = op == '&' ? x[i] & y[i] : op == '|' ? x[i] | y[i] : x[i] ^ y[i];
+    return __bi_from_twos(x);
+}
+
+__ss_bigint __bi_and(__ss_bigint a, __ss_bigint b) { return __bi_bitwise(a, b, '&'); }
+__ss_bigint __bi_or(__ss_bigint a, __ss_bigint b) { return __bi_bitwise(a, b, '|'); }
+__ss_bigint __bi_xor(__ss_bigint a, __ss_bigint b) { return __bi_bitwise(a, b, '^'); }
+
+/* misc */
+
+long __bi_hash(__ss_bigint a) { /* (modulo 2**61-1, as in CPython) */
+    const unsigned long long P = (1ULL << 61) - 1;
+    if(a.small()) {
+        long long v = a.value();
+        unsigned long long m = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+        long r = (long)(m % P);
+        r = v < 0 ? -r : r;
+        return r == -1 ? -2 : r;
+    }
+    __ss_bignum *b = a.big();
+    int n = b->size < 0 ? -b->size : b->size;
+    unsigned long long h = 0;
+    for(int i = n; i-- > 0;) {
+        h = ((h << 32) & P) | (h >> 29);
+        h += b->limbs[i];
+        if(h >= P)
+            h -= P;
+    }
+    long r = b->size < 0 ? -(long)h : (long)h;
+    return r == -1 ? -2 : r;
+}
+
+__ss_bigint __bi_bit_length(__ss_bigint a) {
+    int sign;
+    __bi_mag m;
+    __bi_unpack(a, sign, m);
+    if(m.empty())
+        return 0;
+    return (long long)(m.size() * 32 - (size_t)__builtin_clz(m.back()));
+}
+
+__ss_bigint __bi_bit_count(__ss_bigint a) {
+    int sign;
+    __bi_mag m;
+    __bi_unpack(a, sign, m);
+    long long n = 0;
+    for(size_t i = 0; i < m.size(); i++)
+        n += __builtin_popcount(m[i]);
+    return n;
+}
+
+#endif
@@ -0,0 +1,338 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef SS_BIGINT_HPP
+#define SS_BIGINT_HPP
+
+/* arbitrary-precision integers (--bigint)
+
+   values that fit in 63 bits are stored inline, shifted left by one with the lowest bit set.
+   arithmetic on such values checks for overflow, and only when it occurs (or an operand is
+   already large) falls back to a heap-allocated bignum: an immutable sign-magnitude array of
+   32-bit limbs. results are always normalized (each value has a single representation), so
+   two values are equal exactly when their words are, unless both are bignums.
+
+   the type converts implicitly to any arithmetic type, so that runtime code using ints as
+   sizes and indices keeps working (bignums then wrap, as fixed-size ints would). */
+
+struct __ss_bignum {
+    int size; /* number of limbs, negative for negative values (as in CPython) */
+    uint32_t limbs[1];
+};
+
+class __ss_bigint;
+class __ss_bool;
+
+__ss_bigint __bi_from_ll(long long v);
+__ss_bigint __bi_from_ull(unsigned long long v);
+__ss_bigint __bi_from_double(double d);
+__ss_bigint __bi_parse(const char *s, size_t len, int base);
+double __bi_to_double(__ss_bigint a);
+unsigned long long __bi_to_ull(__ss_bigint a);
+
+class __ss_bigint {
+public:
+    intptr_t w; /* (value << 1) | 1, or an __ss_bignum pointer */
+
+    inline __ss_bigint() : w(1) {}
+
+    template<class T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    inline __ss_bigint(T v) {
+        if(__builtin_add_overflow(v, v, &w))
+            *this = std::is_signed<T>::value ? __bi_from_ll((long long)v) : __bi_from_ull((unsigned long long)v);
+        else
+            w |= 1;
+    }
+
+    template<class T, typename std::enable_if<std::is_same<T, bool>::value || std::is_same<T, __ss_bool>::value, int>::type = 0>
+    inline __ss_bigint(T b) : w(((intptr_t)(bool)b << 1) | 1) {}
+
+    template<class T, typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+    inline __ss_bigint(T v) : __ss_bigint((long long)v) {}
+
+    explicit __ss_bigint(double d) { *this = __bi_from_double(d); }
+    template<class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0>
+    inline __ss_bigint &operator=(T d) { return *this = __bi_from_double(d); } /* (truncates, as for builtin ints) */
+    explicit __ss_bigint(const char *s) { *this = __bi_parse(s, strlen(s), 10); }
+
+    static inline __ss_bigint raw(intptr_t w) { __ss_bigint a; a.w = w; return a; }
+    static inline __ss_bigint fits(intptr_t v) { return raw((intptr_t)((uintptr_t)v << 1) | 1); } /* (v must fit) */
+
+    inline bool small() const { return w & 1; }
+    inline intptr_t value() const { return w >> 1; } /* (small values only) */
+    inline __ss_bignum *big() const { return (__ss_bignum *)w; }
+
+    template<class T, typename std::enable_if<std::is_arithmetic<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+    inline operator T() const {
+        if(w & 1)
+            return (T)(w >> 1);
+        if(std::is_floating_point<T>::value)
+            return (T)__bi_to_double(*this);
+        return (T)__bi_to_ull(*this);
+    }
+
+    /* (explicit, so that mixing with bool converts the bool) */
+    inline explicit operator bool() const { return w != 1; }
+    template<class T> inline explicit operator T *() const { return (T *)(intptr_t)*this; } /* (None) */
+
+    inline __ss_bigint &operator+=(__ss_bigint b);
+    inline __ss_bigint &operator-=(__ss_bigint b);
+    inline __ss_bigint &operator*=(__ss_bigint b);
+    inline __ss_bigint &operator/=(__ss_bigint b);
+    inline __ss_bigint &operator%=(__ss_bigint b);
+    inline __ss_bigint &operator<<=(__ss_bigint b);
+    inline __ss_bigint &operator>>=(__ss_bigint b);
+    inline __ss_bigint &operator&=(__ss_bigint b);
+    inline __ss_bigint &operator|=(__ss_bigint b);
+    inline __ss_bigint &operator^=(__ss_bigint b);
+    inline __ss_bigint &operator++() { return *this += 1; }
+    inline __ss_bigint &operator--() { return *this -= 1; }
+    inline __ss_bigint operator++(int) { __ss_bigint a = *this; *this += 1; return a; }
+    inline __ss_bigint operator--(int) { __ss_bigint a = *this; *this -= 1; return a; }
+};
+
+/* slow paths (bigint.cpp) */
+
+__ss_bigint __bi_add(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_sub(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_mul(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_div(__ss_bigint a, __ss_bigint b); /* (truncating, as in C) */
+__ss_bigint __bi_mod(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_floordiv(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_floormod(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_neg(__ss_bigint a);
+__ss_bigint __bi_shl(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_shr(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_and(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_or(__ss_bigint a, __ss_bigint b);
+__ss_bigint __bi_xor(__ss_bigint a, __ss_bigint b);
+int __bi_cmp(__ss_bigint a, __ss_bigint b);
+long __bi_hash(__ss_bigint a);
+__ss_bigint __bi_bit_length(__ss_bigint a);
+__ss_bigint __bi_bit_count(__ss_bigint a);
+bool __bi_fits_ll(__ss_bigint a);
+void __bi_zero_division();
+std::string __bi_digits(__ss_bigint a, int base); /* (without sign or prefix) */
+
+/* arithmetic */
+
+inline __ss_bigint operator+(__ss_bigint a, __ss_bigint b) {
+    intptr_t r;
+    if((a.w & b.w & 1) && !__builtin_add_overflow(a.w, b.w - 1, &r))
+        return __ss_bigint::raw(r);
+    return __bi_add(a, b);
+}
+
+inline __ss_bigint operator-(__ss_bigint a, __ss_bigint b) {
+    intptr_t r;
+    if((a.w & b.w & 1) && !__builtin_sub_overflow(a.w, b.w - 1, &r))
+        return __ss_bigint::raw(r);
+    return __bi_sub(a, b);
+}
+
+inline __ss_bigint operator*(__ss_bigint a, __ss_bigint b) {
+    intptr_t r;
+    if((a.w & b.w & 1) && !__builtin_mul_overflow(a.w >> 1, b.w - 1, &r))
+        return __ss_bigint::raw(r | 1);
+    return __bi_mul(a, b);
+}
+
+inline __ss_bigint operator/(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1) {
+        if(b.w == 1)
+            __bi_zero_division();
+        return __ss_bigint((long long)(a.value() / b.value())); /* (-2**62 / -1 does not fit) */
+    }
+    return __bi_div(a, b);
+}
+
+inline __ss_bigint operator%(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1) {
+        if(b.w == 1)
+            __bi_zero_division();
+        return __ss_bigint::fits(a.value() % b.value());
+    }
+    return __bi_mod(a, b);
+}
+
+inline __ss_bigint operator-(__ss_bigint a) {
+    intptr_t r;
+    if((a.w & 1) && !__builtin_sub_overflow((intptr_t)2, a.w, &r))
+        return __ss_bigint::raw(r);
+    return __bi_neg(a);
+}
+
+inline __ss_bigint operator+(__ss_bigint a) { return a; }
+
+inline __ss_bigint operator<<(__ss_bigint a, __ss_bigint b) {
+    if((a.w & b.w & 1) && b.w >= 1 && b.value() < 62) {
+        intptr_t v = a.value(), s = b.value();
+        intptr_t r = (intptr_t)((uintptr_t)v << s);
+        if((r >> s) == v)
+            return __ss_bigint(r);
+    }
+    return __bi_shl(a, b);
+}
+
+inline __ss_bigint operator>>(__ss_bigint a, __ss_bigint b) {
+    if((a.w & b.w & 1) && b.w >= 1)
+        return __ss_bigint::fits(a.value() >> (b.value() < 63 ? b.value() : 63));
+    return __bi_shr(a, b);
+}
+
+inline __ss_bigint operator&(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1)
+        return __ss_bigint::raw(a.w & b.w);
+    return __bi_and(a, b);
+}
+
+inline __ss_bigint operator|(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1)
+        return __ss_bigint::raw(a.w | b.w);
+    return __bi_or(a, b);
+}
+
+inline __ss_bigint operator^(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1)
+        return __ss_bigint::raw((a.w ^ b.w) | 1);
+    return __bi_xor(a, b);
+}
+
+inline __ss_bigint operator~(__ss_bigint a) {
+    if(a.w & 1)
+        return __ss_bigint::raw(~a.w | 1);
+    return __bi_sub(__bi_neg(a), 1);
+}
+
+/* comparison */
+
+inline bool operator==(__ss_bigint a, __ss_bigint b) {
+    if(a.w == b.w)
+        return true;
+    if((a.w | b.w) & 1) /* (a small value never equals a bignum) */
+        return false;
+    return __bi_cmp(a, b) == 0;
+}
+
+inline bool operator!=(__ss_bigint a, __ss_bigint b) { return !(a == b); }
+
+inline bool operator<(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1)
+        return a.w < b.w;
+    return __bi_cmp(a, b) < 0;
+}
+
+inline bool operator>(__ss_bigint a, __ss_bigint b) { return b < a; }
+inline bool operator<=(__ss_bigint a, __ss_bigint b) { return !(b < a); }
+inline bool operator>=(__ss_bigint a, __ss_bigint b) { return !(a < b); }
+
+/* mixed with builtin types: integers are converted to __ss_bigint, and floating-point
+   operations are done in floating point (as the builtin candidates would be ambiguous) */
+
+#define __SS_BIGINT_MIXED(op, intresult) \
+    template<class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0> \
+    inline intresult operator op(__ss_bigint a, T b) { return a op __ss_bigint(b); } \
+    template<class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0> \
+    inline intresult operator op(T a, __ss_bigint b) { return __ss_bigint(a) op b; }
+
+#define __SS_BIGINT_MIXED_FLOAT(op, floatresult) \
+    template<class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0> \
+    inline floatresult operator op(__ss_bigint a, T b) { return (T)a op b; } \
+    template<class T, typename std::enable_if<std::is_floating_point<T>::value, int>::type = 0> \
+    inline floatresult operator op(T a, __ss_bigint b) { return a op (T)b; }
+
+__SS_BIGINT_MIXED(+, __ss_bigint)
+__SS_BIGINT_MIXED(-, __ss_bigint)
+__SS_BIGINT_MIXED(*, __ss_bigint)
+__SS_BIGINT_MIXED(/, __ss_bigint)
+__SS_BIGINT_MIXED(%, __ss_bigint)
+__SS_BIGINT_MIXED(<<, __ss_bigint)
+__SS_BIGINT_MIXED(>>, __ss_bigint)
+__SS_BIGINT_MIXED(&, __ss_bigint)
+__SS_BIGINT_MIXED(|, __ss_bigint)
+__SS_BIGINT_MIXED(^, __ss_bigint)
+__SS_BIGINT_MIXED(==, bool)
+__SS_BIGINT_MIXED(!=, bool)
+__SS_BIGINT_MIXED(<, bool)
+__SS_BIGINT_MIXED(>, bool)
+__SS_BIGINT_MIXED(<=, bool)
+__SS_BIGINT_MIXED(>=, bool)
+
+__SS_BIGINT_MIXED_FLOAT(+, T)
+__SS_BIGINT_MIXED_FLOAT(-, T)
+__SS_BIGINT_MIXED_FLOAT(*, T)
+__SS_BIGINT_MIXED_FLOAT(/, T)
+__SS_BIGINT_MIXED_FLOAT(==, bool)
+__SS_BIGINT_MIXED_FLOAT(!=, bool)
+__SS_BIGINT_MIXED_FLOAT(<, bool)
+__SS_BIGINT_MIXED_FLOAT(>, bool)
+__SS_BIGINT_MIXED_FLOAT(<=, bool)
+__SS_BIGINT_MIXED_FLOAT(>=, bool)
+
+#undef __SS_BIGINT_MIXED
+#undef __SS_BIGINT_MIXED_FLOAT
+
+inline __ss_bigint &__ss_bigint::operator+=(__ss_bigint b) { return *this = *this + b; }
+inline __ss_bigint &__ss_bigint::operator-=(__ss_bigint b) { return *this = *this - b; }
+inline __ss_bigint &__ss_bigint::operator*=(__ss_bigint b) { return *this = *this * b; }
+inline __ss_bigint &__ss_bigint::operator/=(__ss_bigint b) { return *this = *this / b; }
+inline __ss_bigint &__ss_bigint::operator%=(__ss_bigint b) { return *this = *this % b; }
+inline __ss_bigint &__ss_bigint::operator<<=(__ss_bigint b) { return *this = *this << b; }
+inline __ss_bigint &__ss_bigint::operator>>=(__ss_bigint b) { return *this = *this >> b; }
+inline __ss_bigint &__ss_bigint::operator&=(__ss_bigint b) { return *this = *this & b; }
+inline __ss_bigint &__ss_bigint::operator|=(__ss_bigint b) { return *this = *this | b; }
+inline __ss_bigint &__ss_bigint::operator^=(__ss_bigint b) { return *this = *this ^ b; }
+
+/* pointer offsets */
+
+template<class T> inline T *operator+(T *p, __ss_bigint b) { return p + (ptrdiff_t)b; }
+template<class T> inline T *operator+(__ss_bigint b, T *p) { return p + (ptrdiff_t)b; }
+template<class T> inline T *operator-(T *p, __ss_bigint b) { return p - (ptrdiff_t)b; }
+
+/* compound assignment to builtin types (as when an int index is advanced by a step) */
+
+#define __SS_BIGINT_ASSIGN(op, trait) \
+    template<class T, typename std::enable_if<std::trait<T>::value, int>::type = 0> \
+    inline T &operator op##=(T &a, __ss_bigint b) { return a = (T)(a op b); }
+
+__SS_BIGINT_ASSIGN(+, is_arithmetic)
+__SS_BIGINT_ASSIGN(-, is_arithmetic)
+__SS_BIGINT_ASSIGN(*, is_arithmetic)
+__SS_BIGINT_ASSIGN(/, is_arithmetic)
+__SS_BIGINT_ASSIGN(%, is_integral)
+__SS_BIGINT_ASSIGN(<<, is_integral)
+__SS_BIGINT_ASSIGN(>>, is_integral)
+__SS_BIGINT_ASSIGN(&, is_integral)
+__SS_BIGINT_ASSIGN(|, is_integral)
+__SS_BIGINT_ASSIGN(^, is_integral)
+
+#undef __SS_BIGINT_ASSIGN
+
+/* python semantics */
+
+inline __ss_bigint __bi_floordiv_fast(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1) {
+        intptr_t x = a.value(), y = b.value();
+        if(y == 0)
+            __bi_zero_division();
+        intptr_t q = x / y;
+        if((x % y != 0) && ((x < 0) != (y < 0)))
+            q--;
+        return __ss_bigint((long long)q);
+    }
+    return __bi_floordiv(a, b);
+}
+
+inline __ss_bigint __bi_floormod_fast(__ss_bigint a, __ss_bigint b) {
+    if(a.w & b.w & 1) {
+        intptr_t x = a.value(), y = b.value();
+        if(y == 0)
+            __bi_zero_division();
+        intptr_t m = x % y;
+        if(m != 0 && ((m < 0) != (y < 0)))
+            m += y;
+        return __ss_bigint::fits(m);
+    }
+    return __bi_floormod(a, b);
+}
+
+#endif
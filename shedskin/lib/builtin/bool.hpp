@@ -36,6 +36,9 @@ template<> inline __ss_bool ___bool(int64_t x) { return __mbool(x!=0); }
 #ifdef __SS_INT128
 template<> inline __ss_bool ___bool(__int128 x) { return __mbool(x!=0); }
 #endif
+#ifdef __SS_BIGINT
+template<> inline __ss_bool ___bool(__ss_bigint x) { return __mbool(x.w != 1); }
+#endif
 #ifdef __APPLE__
 template<> inline __ss_bool ___bool(long x) { return __mbool(x!=0); }
 #endif
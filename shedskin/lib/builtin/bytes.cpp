@@ -681,6 +681,15 @@ bytes::bytes(PyObject *p) : hash(-1) {
     } else if (PyByteArray_Check(p)) {
         unit = __GC_STRING(PyByteArray_AS_STRING(p), (size_t)PyByteArray_Size(p));
 	frozen = 0;
+    } else if (PyObject_CheckBuffer(p)) { /* memoryview, array.array, numpy array.. */
+        Py_buffer view;
+        if(PyObject_GetBuffer(p, &view, PyBUF_C_CONTIGUOUS) == -1) {
+            PyErr_Clear();
+            throw new TypeError(new str("error in conversion to Shed Skin (contiguous buffer expected)"));
+        }
+        unit = __GC_STRING((const char *)view.buf, (size_t)view.len);
+        frozen = 1;
+        PyBuffer_Release(&view);
     } else
         throw new TypeError(new str("error in conversion to Shed Skin (bytes/bytearray expected)"));
 }
@@ -10,6 +10,8 @@ public:
     long hash;
     int frozen;
 
+    __SS_GC_TYPED(bytes, member(&bytes::unit).member(&bytes::hash).member(&bytes::frozen))
+
     bytes(int frozen=1);
     bytes(const char *s);
     bytes(bytes *b, int frozen=1);
@@ -171,6 +173,10 @@ template <class U> bytes *bytes::join(U *iter) {
     typename U::for_in_unit e;
     typename U::for_in_loop __3;
     U *__1;
+#ifdef __SS_THREADS
+    if(!__join_cache_bin)
+        __join_cache_bin = new (NoGC) list<bytes *>();
+#endif
     __join_cache_bin->units.resize(0);
     total = 0;
     FOR_IN(e,iter,1,2,3)
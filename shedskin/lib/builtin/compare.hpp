@@ -8,7 +8,7 @@ template<> inline __ss_bool __eq(__ss_int a, __ss_int b) { return __mbool(a == b
 #endif
 template<> inline __ss_bool __eq(str *a, str *b) {
     if(a&&b) {
-        if (a->charcache && b->charcache) 
+        if (a->interned && b->interned)
             return __mbool(a==b);
         else
             return __mbool(a->__eq__(b));
@@ -133,12 +133,6 @@ template<> inline __ss_int __cmp(void *a, void *b) {
     return 0;
 }
 
-template<class T> __ss_int cpp_cmp(T a, T b) {
-    return __cmp(a, b) == -1;
-}
-template<class T> __ss_int cpp_cmp_rev(T a, T b) {
-    return __cmp(a, b) == 1;
-}
 template<class T> class cpp_cmp_custom {
     typedef __ss_int (*hork)(T, T);
     hork cmp;
@@ -153,19 +147,32 @@ public:
     cpp_cmp_custom_rev(hork a) { cmp = a; }
     __ss_int operator()(T a, T b) const { return cmp(a,b) == 1; }
 };
-template<class T, class V> class cpp_cmp_key {
-    typedef V (*hork)(T);
-    hork key;
-public:
-    cpp_cmp_key(hork a) { key = a; }
-    __ss_int operator()(T a, T b) const { return __cmp(key(a), key(b)) == -1; }
+
+/* less-than for sorting (specialized for common key types) */
+
+template<class T> struct __sort_less {
+    inline bool operator()(const T &a, const T &b) const { return __cmp(a, b) == -1; }
 };
-template<class T, class V> class cpp_cmp_key_rev {
-    typedef V (*hork)(T);
-    hork key;
-public:
-    cpp_cmp_key_rev(hork a) { key = a; }
-    __ss_int operator()(T a, T b) const { return __cmp(key(a), key(b)) == 1; }
+template<> struct __sort_less<__ss_int> {
+    inline bool operator()(__ss_int a, __ss_int b) const { return a < b; }
+};
+template<> struct __sort_less<__ss_float> {
+    inline bool operator()(__ss_float a, __ss_float b) const { return a < b; }
+};
+template<> struct __sort_less<str *> {
+    inline bool operator()(str *a, str *b) const {
+        if(!a || !b)
+            return __cmp(a, b) == -1;
+        size_t la = a->unit.size(), lb = b->unit.size();
+        int r = memcmp(a->unit.data(), b->unit.data(), la < lb ? la : lb);
+        return r < 0 || (r == 0 && la < lb);
+    }
+};
+
+template<class L> struct __sort_rev {
+    L lt;
+    __sort_rev(L lt) : lt(lt) {}
+    template<class T> inline bool operator()(const T &a, const T &b) const { return lt(b, a); }
 };
 
 template<class T> class ss_eq {
@@ -102,7 +102,8 @@ public:
     }
 
     inline bool for_in_has_next(dict_looper<K,V> &l) {
-        return l.it != gcd.end();
+        l.it.skip(); /* entries may have been deleted since */
+        return l.it < gcd.end();
     }
 
     inline K for_in_next(dict_looper<K,V> &l) {
@@ -174,9 +175,9 @@ template<class K, class V> dict<K, V>::dict(PyObject *p) {
 template<class K, class V> PyObject *dict<K, V>::__to_py__() {
    PyObject *p = PyDict_New();
 
-   for (const auto& [key, value] : gcd) {
-       PyObject *pkey = __to_py(key);
-       PyObject *pvalue = __to_py(value);
+   for (auto &e : gcd) {
+       PyObject *pkey = __to_py(e.first);
+       PyObject *pvalue = __to_py(e.second);
        PyDict_SetItem(p, pkey, pvalue);
        Py_DECREF(pkey);
        Py_DECREF(pvalue);
@@ -192,14 +193,13 @@ template<class K, class V> __ss_bool dict<K,V>::__eq__(pyobj *p) {
     if(b->__len__() != this->__len__())
         return False;
 
-    // TODO why can't we just use unordered_map operator==
     typename __GC_DICT<K, V>::iterator it;
 
-    for (const auto& [key, value] : gcd) {
-        it = b->gcd.find(key);
+    for (auto &e : gcd) {
+        it = b->gcd.find(e.first);
         if(it == b->gcd.end())
             return False;
-        else if(__ne((*it).second, value))
+        else if(__ne((*it).second, e.second))
             return False;
     }
 
@@ -274,13 +274,8 @@ template <class K, class V> V dict<K,V>::get(K key, V d) {
 
 template <class K, class V> V dict<K,V>::setdefault(K key, V value)
 {
-    typename __GC_DICT<K, V>::iterator it = gcd.find(key);
-    if (it == gcd.end()) {
-        gcd[key] = value;
-        return value;
-    } else {
-        return (*it).second;
-    }
+    bool inserted;
+    return gcd.insert(key, value, inserted).second;
 }
 
 template <class K, class V> void *dict<K,V>::__delitem__(K key) {
@@ -316,10 +311,10 @@ template<class K, class V> V dict<K,V>::pop(K key, V value) {
 }
 
 template<class K, class V> tuple2<K,V> *dict<K,V>::popitem() {
-    typename __GC_DICT<K, V>::iterator it = gcd.begin();
-    if(it == gcd.end())
+    if(gcd.empty())
         throw new KeyError(new str("popitem(): dictionary is empty"));
     else {
+        typename __GC_DICT<K, V>::iterator it = gcd.last();
         tuple2<K,V> *t = new tuple2<K,V>(2, (*it).first, (*it).second);
         gcd.erase(it);
         return t;
@@ -330,10 +325,10 @@ template<class K, class V> str *dict<K,V>::__repr__() {
     str *r = new str("{");
     int i = __len__();
 
-    for (const auto& [key, value] : gcd) {
-        *r += repr(key)->c_str();
+    for (auto &e : gcd) {
+        *r += repr(e.first)->c_str();
         *r += ": ";
-        *r += repr(value)->c_str();
+        *r += repr(e.second)->c_str();
         if(--i > 0)
             *r += ", ";
     }
@@ -348,7 +343,7 @@ template<class K, class V> __ss_int dict<K,V>::__len__() {
 }
 
 template <class K, class V> __ss_bool dict<K,V>::__contains__(K key) {
-    return __mbool(gcd.find(key) != gcd.end());
+    return __mbool(gcd.contains(key));
 }
 
 
@@ -364,8 +359,9 @@ template <class K, class V> void *dict<K,V>::clear()
 
 template <class K, class V> void *dict<K,V>::update(dict<K,V>* other)
 {
-   for (const auto& [key, value] : other->gcd)
-       gcd[key] = value;
+    gcd.reserve(gcd.size() + other->gcd.size());
+    for (auto &e : other->gcd)
+        gcd[e.first] = e.second;
 
     return NULL;
 }
@@ -396,7 +392,8 @@ template<class K, class V> __dictiterkeys<K, V>::__dictiterkeys(dict<K,V> *d) {
 }
 
 template<class K, class V> K __dictiterkeys<K, V>::__next__() {
-    if(it == p->gcd.end())
+    it.skip();
+    if(!(it < p->gcd.end()))
         __throw_stop_iteration();
 
     return (*it++).first;
@@ -408,7 +405,8 @@ template<class K, class V> __dictitervalues<K, V>::__dictitervalues(dict<K,V> *d
 }
 
 template<class K, class V> V __dictitervalues<K, V>::__next__() {
-    if(it == p->gcd.end())
+    it.skip();
+    if(!(it < p->gcd.end()))
         __throw_stop_iteration();
 
     return (*it++).second;
@@ -420,7 +418,8 @@ template<class K, class V> __dictiteritems<K, V>::__dictiteritems(dict<K,V> *d)
 }
 
 template<class K, class V> tuple2<K, V> *__dictiteritems<K, V>::__next__() {
-    if(it == p->gcd.end())
+    it.skip();
+    if(!(it < p->gcd.end()))
         __throw_stop_iteration();
 
     tuple2<K, V> *t = new tuple2<K, V>(2, (*it).first, (*it).second);
@@ -42,6 +42,9 @@ void __throw_set_changed() {
 void __throw_dict_changed() {
     throw new RuntimeError(new str("dict changed size during iteration"));
 }
+void __throw_table_overflow() {
+    throw new MemoryError();
+}
 void __throw_slice_step_zero() {
     throw new ValueError(new str("slice step cannot be zero"));
 }
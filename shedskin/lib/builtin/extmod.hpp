@@ -26,6 +26,9 @@ template<> PyObject *__to_py(int64_t i);
 #ifdef __SS_INT128
 template<> PyObject *__to_py(__int128 i);
 #endif
+#ifdef __SS_BIGINT
+template<> PyObject *__to_py(__ss_bigint i);
+#endif
 #ifdef WIN32
 template<> PyObject *__to_py(long i);
 #endif
@@ -44,9 +47,8 @@ extern dict<void *, void *> *__ss_proxy;
 #ifdef __SS_BIND
 template<class T> T __ss_arg(const char *name, int pos, int has_default, T default_value, PyObject *args, PyObject *kwargs) {
     PyObject *kwarg;
-    Py_ssize_t nrofargs = PyTuple_Size(args);
-    if (pos < (int)nrofargs)
-        return __to_ss<T>(PyTuple_GetItem(args, pos));
+    if (pos < (int)PyTuple_GET_SIZE(args))
+        return __to_ss<T>(PyTuple_GET_ITEM(args, pos));
     else if (kwargs && (kwarg = PyDict_GetItemString(kwargs, name)))
         return __to_ss<T>(kwarg);
     else if (has_default)
@@ -56,6 +58,44 @@ template<class T> T __ss_arg(const char *name, int pos, int has_default, T defau
 }
 #endif
 
+/* releasing the GIL (--nogil): arguments and results are converted with the GIL held, and only
+   the compiled call itself runs without it. as the calling (python) thread may be unknown to the
+   GC, it is registered for the duration of the call */
+
+#if defined(__SS_BIND) && defined(__SS_THREADS)
+class __ss_gc_thread {
+    bool registered;
+public:
+    __ss_gc_thread() : registered(false) {
+#ifndef __SS_ARENA
+        if(!GC_thread_is_registered()) {
+            struct GC_stack_base sb;
+            GC_get_stack_base(&sb);
+            registered = (GC_register_my_thread(&sb) == GC_SUCCESS);
+        }
+#endif
+    }
+    ~__ss_gc_thread() {
+#ifndef __SS_ARENA
+        if(registered)
+            GC_unregister_my_thread();
+#endif
+    }
+};
+
+class __ss_nogil {
+    PyThreadState *state;
+public:
+    __ss_nogil() { state = PyEval_SaveThread(); }
+    ~__ss_nogil() { PyEval_RestoreThread(state); } /* also when unwinding */
+};
+
+template<class F> inline auto __ss_nogil_call(F f) -> decltype(f()) {
+    __ss_nogil nogil;
+    return f();
+}
+#endif
+
 #ifdef __SS_BIND
 PyObject *__ss__newobj__(PyObject *, PyObject *args, PyObject *kwargs);
 #endif
@@ -6,8 +6,15 @@
 
 #ifndef WIN32
 #include <unistd.h>
+#include <sys/mman.h>
+#include <signal.h>
 #endif
 
+#include <atomic>
+#include <mutex>
+
+#include <sys/stat.h>
+
 #if (_POSIX_C_SOURCE >= 1 or _XOPEN_SOURCE or _POSIX_SOURCE or _BSD_SOURCE or _SVID_SOURCE) and (_BSD_SOURCE or _SVID_SOURCE)
 #define HAVE_STDIO_UNLOCKED
 #endif
@@ -26,7 +33,258 @@
 #define FEOF   feof_unlocked
 #endif // HAVE_STDIO_UNLOCKED
 
-file::file(str *file_name, str *flags) {
+/* block buffering (regular files only) */
+
+#ifndef WIN32
+/* a mapped file that is truncated by someone else raises SIGBUS on access beyond its new end.
+   while any file is mapped, a SIGBUS handler patches the faulting page with zeros (so the scan
+   can finish) and counts the fault; readline/read then notice the count, find the file shorter
+   than its mapping and throw OSError. the size is otherwise fixed at open: data appended later
+   is not seen.
+
+   the handler only looks up the fault address in a fixed table and maps over one page (mmap is
+   not on the POSIX list of async-signal-safe functions, but it is a plain system call on the
+   systems we map files on). files that do not fit in the table are read through the block
+   buffer instead, so they are never mapped. faults elsewhere go to the previous handler, which
+   is restored when the last map is closed */
+
+#define __SS_FILE_MAPS 64
+
+static std::atomic<char *> __file_map_begin[__SS_FILE_MAPS];
+static std::atomic<size_t> __file_map_size[__SS_FILE_MAPS];
+static std::atomic<unsigned> __file_map_faults;
+static uintptr_t __file_map_page; /* sysconf is not async-signal-safe */
+static int __file_map_count;
+static struct sigaction __file_map_oldbus;
+static std::mutex __file_map_lock;
+
+static void __file_map_sigbus(int sig, siginfo_t *info, void *context) {
+    char *addr = (char *)info->si_addr;
+    for(int i = 0; i < __SS_FILE_MAPS; i++) {
+        char *begin = __file_map_begin[i].load(std::memory_order_acquire);
+        if(begin and addr >= begin and addr < begin + __file_map_size[i].load(std::memory_order_relaxed)) {
+            void *start = (void *)((uintptr_t)addr & ~(__file_map_page - 1));
+            if(::mmap(start, __file_map_page, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED)
+                break;
+            __file_map_faults.fetch_add(1, std::memory_order_release);
+            return;
+        }
+    }
+    /* not ours: hand over, or restore the default action and fault again */
+    if(__file_map_oldbus.sa_flags & SA_SIGINFO)
+        __file_map_oldbus.sa_sigaction(sig, info, context);
+    else if(__file_map_oldbus.sa_handler != SIG_DFL and __file_map_oldbus.sa_handler != SIG_IGN)
+        __file_map_oldbus.sa_handler(sig);
+    else
+        signal(SIGBUS, SIG_DFL);
+}
+
+/* returns false if the table is full (or the handler cannot be installed): read the file instead */
+static bool __register_file_map(char *m, size_t size) {
+    std::lock_guard<std::mutex> lock(__file_map_lock);
+    if(__file_map_count == __SS_FILE_MAPS)
+        return false;
+    if(__file_map_count == 0) {
+        __file_map_page = (uintptr_t)sysconf(_SC_PAGESIZE);
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_sigaction = __file_map_sigbus;
+        sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+        sigemptyset(&sa.sa_mask);
+        if(sigaction(SIGBUS, &sa, &__file_map_oldbus) != 0)
+            return false;
+    }
+    for(int i = 0; i < __SS_FILE_MAPS; i++) {
+        if(!__file_map_begin[i].load(std::memory_order_relaxed)) {
+            __file_map_size[i].store(size, std::memory_order_relaxed);
+            __file_map_begin[i].store(m, std::memory_order_release);
+            break;
+        }
+    }
+    __file_map_count++;
+    return true;
+}
+
+static void __unregister_file_map(char *m) {
+    std::lock_guard<std::mutex> lock(__file_map_lock);
+    for(int i = 0; i < __SS_FILE_MAPS; i++) {
+        if(__file_map_begin[i].load(std::memory_order_relaxed) == m) {
+            __file_map_begin[i].store(0, std::memory_order_release);
+            if(--__file_map_count == 0)
+                sigaction(SIGBUS, &__file_map_oldbus, NULL);
+            return;
+        }
+    }
+}
+#endif
+
+/* throw if a page of the map faulted since the last check and the file has shrunk */
+static inline void __check_file_map(__file_buffer &b, FILE *f, str *name) {
+#ifndef WIN32
+    if(b.map) {
+        unsigned faults = __file_map_faults.load(std::memory_order_acquire);
+        if(faults != b.faults) {
+            b.faults = faults;
+            struct stat st;
+            if(fstat(fileno(f), &st) != 0 or (uintmax_t)st.st_size < b.end) {
+                errno = EIO;
+                throw new OSError(name);
+            }
+        }
+    }
+#endif
+}
+
+static void __init_file_buffer(__file_buffer &b, FILE *f, str *flags, __ss_int buffering) {
+    if(buffering == 0 or buffering == 1) /* unbuffered/line buffered: read per character */
+        return;
+    if(flags->unit.find_first_of("r+") == std::string::npos)
+        return;
+    struct stat st;
+    if(fstat(fileno(f), &st) != 0 or !S_ISREG(st.st_mode))
+        return;
+#ifndef WIN32
+    /* read-only: map the whole file, lines are then copied straight from the page cache */
+    if(buffering == -1 and flags->unit.find_first_of("+wax") == std::string::npos and st.st_size > 0 and (uintmax_t)st.st_size <= SIZE_MAX) {
+        void *m = ::mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+        if(m != MAP_FAILED) {
+            if(__register_file_map((char *)m, (size_t)st.st_size)) {
+#ifdef MADV_SEQUENTIAL
+                madvise(m, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+                b.map = (char *)m;
+                b.end = (size_t)st.st_size;
+                b.faults = __file_map_faults.load(std::memory_order_acquire);
+                return;
+            }
+            munmap(m, (size_t)st.st_size);
+        }
+    }
+#endif
+    b.data.resize(buffering > 1 ? (size_t)buffering : __SS_FILE_BUFSIZE);
+}
+
+static void __close_file_buffer(__file_buffer &b) {
+#ifndef WIN32
+    if(b.map) {
+        __unregister_file_map(b.map);
+        munmap(b.map, b.end);
+    }
+#endif
+    b.map = 0;
+    b.reset();
+}
+
+static inline bool __fill_file_buffer(__file_buffer &b, FILE *f) {
+    if(b.map) /* whole file */
+        return false;
+    b.pos = 0;
+    b.end = fread(b.data.data(), 1, b.data.size(), f);
+    return b.end != 0;
+}
+
+/* next line of at most n bytes: points into the buffer when the line lies within one block
+   (and needs no newline translation), else into cache */
+static void __buffered_readline(__file_buffer &b, FILE *f, __file_options &options, __GC_BUFFER(char) &cache, size_t n, const char *&data, size_t &size) {
+    cache.clear();
+    while(n) {
+        if(b.pos == b.end and !__fill_file_buffer(b, f))
+            break;
+        char *start = b.begin() + b.pos;
+        if(options.cr) { /* skip '\n' of '\r\n' */
+            options.cr = false;
+            if(*start == '\n' and ++b.pos == b.end)
+                continue;
+            start = b.begin() + b.pos;
+        }
+
+        size_t len = std::min(b.avail(), n);
+        char *nl = (char *)memchr(start, '\n', len);
+        size_t chunk = nl ? (size_t)(nl - start) + 1 : len;
+        if(options.universal_mode) {
+            char *cr = (char *)memchr(start, '\r', chunk);
+            if(cr) {
+                b.pos += (size_t)(cr - start) + 1;
+                options.cr = true;
+                cache.insert(cache.end(), start, cr);
+                cache.push_back('\n');
+                break;
+            }
+        }
+        b.pos += chunk;
+        n -= chunk;
+
+        if(cache.empty() and (nl or !n)) {
+            data = start;
+            size = chunk;
+            return;
+        }
+        cache.insert(cache.end(), start, start + chunk);
+        if(nl)
+            break;
+    }
+    data = cache.data();
+    size = cache.size();
+}
+
+static void __buffered_read(__file_buffer &b, FILE *f, __GC_BUFFER(char) &cache, size_t n) {
+    size_t take = std::min(b.avail(), n);
+    cache.assign(b.begin() + b.pos, b.begin() + b.pos + take);
+    b.pos += take;
+    n -= take;
+    while(n and !b.map) {
+        size_t old = cache.size();
+        size_t chunk = std::min(n, std::max(b.data.size(), old));
+        cache.resize(old + chunk);
+        size_t got = fread(cache.data() + old, 1, chunk, f);
+        cache.resize(old + got);
+        if(got < chunk)
+            break;
+        n -= got;
+    }
+}
+
+/* logical position is behind the stream by the unread part of the buffer */
+static void __sync_file_buffer(__file_buffer &b, FILE *f) {
+    if(b.map)
+        return;
+    if(b.avail())
+        fseek(f, -(long)b.avail(), SEEK_CUR);
+    b.reset();
+}
+
+static int __seek_file(__file_buffer &b, FILE *f, long i, int w) {
+    if(b.map) {
+        long base = w == SEEK_SET ? 0 : (long)(w == SEEK_CUR ? b.pos : b.end);
+        if(base + i < 0)
+            return -1;
+        b.pos = std::min((size_t)(base + i), b.end);
+        return 0;
+    }
+    if(b.enabled()) {
+        if(w == SEEK_CUR)
+            i -= (long)b.avail();
+        b.reset();
+    }
+    return fseek(f, i, w);
+}
+
+static long __tell_file(__file_buffer &b, FILE *f) {
+    if(b.map)
+        return (long)b.pos;
+    long status = ftell(f);
+    if(status == -1)
+        return -1;
+    return status - (long)b.avail();
+}
+
+static inline bool __eof_file(__file_buffer &b, FILE *f) {
+    if(b.map)
+        return !b.avail();
+    return (FEOF(f) != 0) and !b.avail();
+}
+
+file::file(str *file_name, str *flags, __ss_int buffering) {
     options.universal_mode = true;
 
     if (flags) {
@@ -44,21 +302,24 @@ file::file(str *file_name, str *flags) {
         throw new FileNotFoundError(file_name);
     name = file_name;
     mode = flags;
+    __init_file_buffer(rbuf, f, flags, buffering);
 
     buffer = new file_binary(f);
 }
 
-file *open(str *name, str *flags) {
-    return new file(name, flags);
+file *open(str *name, str *flags, __ss_int buffering) {
+    return new file(name, flags, buffering);
 }
 
-file *open(bytes *name, str *flags) {
-    return new file(new str(name->unit), flags);
+file *open(bytes *name, str *flags, __ss_int buffering) {
+    return new file(new str(name->unit), flags, buffering);
 }
 
 void *file::write(str *s) {
     __check_closed();
     if(f) {
+        if(rbuf.enabled())
+            __sync_file_buffer(rbuf, f);
         size_t size = s->unit.size();
         if(FWRITE(s->unit.data(), 1, size, f) != size and __error())
             throw new OSError();
@@ -81,7 +342,7 @@ void *file::writelines(pyiter<str *> *iter) {
 void *file::seek(__ss_int i, __ss_int w) {
     __check_closed();
     if(f) {
-        if(fseek(f, i, w) == -1)
+        if(__seek_file(rbuf, f, i, w) == -1)
             throw new OSError();
     }
     return NULL;
@@ -90,7 +351,7 @@ void *file::seek(__ss_int i, __ss_int w) {
 __ss_int file::tell() {
     __check_closed();
     if(f) {
-        long status = ftell(f);
+        long status = __tell_file(rbuf, f);
         if(status == -1)
             throw new OSError();
         return __ss_int(status);
@@ -100,6 +361,15 @@ __ss_int file::tell() {
 
 str *file::readline(int n) {
     __check_closed();
+    if(rbuf.enabled()) {
+        const char *data;
+        size_t size;
+        __buffered_readline(rbuf, f, options, __read_cache, size_t(n), data, size);
+        __check_file_map(rbuf, f, name);
+        if(__error())
+            throw new OSError();
+        return new str(data, size);
+    }
     __read_cache.clear();
     if (options.universal_mode) {
         for(size_t i = 0; i < size_t(n); ++i) {
@@ -144,6 +414,15 @@ static void __throw_io_error() {
 
 str *file::read(int n) {
     __check_closed();
+    if(rbuf.enabled()) {
+        __buffered_read(rbuf, f, __read_cache, size_t(n));
+        __check_file_map(rbuf, f, name);
+        if(__error())
+            __throw_io_error();
+        if(__read_cache.size() == 1)
+            return __char_cache[static_cast<unsigned char>(__read_cache[0])];
+        return new str(__read_cache.data(), __read_cache.size());
+    }
     if(n == 1) {
         const int c = GETC(f);
         if(FERROR(f) != 0) /* avoid virtual call */
@@ -184,6 +463,8 @@ __iter<str *> *file::xreadlines() {
 void *file::close() {
     if(f and not closed) {
         flush();
+        __close_file_buffer(rbuf);
+        __GC_BUFFER(char)().swap(__read_cache);
         if(fclose(f))
             throw new OSError();
         closed = 1;
@@ -242,7 +523,7 @@ bool file::__error() {
 }
 
 bool file::__eof() {
-    return (FEOF(f) != 0);
+    return __eof_file(rbuf, f);
 }
 
 __iter<str *> *file::__iter__() {
@@ -258,9 +539,29 @@ str *file::__next__() {
     return line;
 }
 
+/* as __next__, without allocating a str: the line stays valid until the next read, and points
+   into the read buffer where possible (for parsers such as csv). false at the end of the file */
+bool file::__next_line(const char *&data, size_t &size) {
+    if(__eof())
+        return false;
+    if(rbuf.enabled()) {
+        __check_closed();
+        __buffered_readline(rbuf, f, options, __read_cache, size_t(-1), data, size);
+        __check_file_map(rbuf, f, name);
+        if(__error())
+            throw new OSError();
+    } else {
+        str *line = readline();
+        __read_cache.assign(line->unit.begin(), line->unit.end());
+        data = __read_cache.data();
+        size = __read_cache.size();
+    }
+    return size or !__eof();
+}
+
 /* file_binary TODO merge with file */
 
-file_binary::file_binary(str *file_name, str *flags) {
+file_binary::file_binary(str *file_name, str *flags, __ss_int buffering) {
     if (flags) {
         size_t universal = flags->unit.find_first_of("Uu");
         if(universal != std::string::npos) {
@@ -276,19 +577,22 @@ file_binary::file_binary(str *file_name, str *flags) {
         throw new FileNotFoundError(file_name);
     name = file_name;
     mode = flags;
+    __init_file_buffer(rbuf, f, flags, buffering);
 }
 
-file_binary *open_binary(str *name, str *flags) {
-    return new file_binary(name, flags);
+file_binary *open_binary(str *name, str *flags, __ss_int buffering) {
+    return new file_binary(name, flags, buffering);
 }
 
-file_binary *open_binary(bytes *name, str *flags) {
-    return new file_binary(new str(name->unit), flags);
+file_binary *open_binary(bytes *name, str *flags, __ss_int buffering) {
+    return new file_binary(new str(name->unit), flags, buffering);
 }
 
 void *file_binary::write(bytes *s) {
     __check_closed();
     if(f) {
+        if(rbuf.enabled())
+            __sync_file_buffer(rbuf, f);
         size_t size = s->unit.size();
         if(FWRITE(s->unit.data(), 1, size, f) != size and __error())
             throw new OSError();
@@ -311,7 +615,7 @@ void *file_binary::writelines(pyiter<bytes *> *iter) {
 void *file_binary::seek(__ss_int i, __ss_int w) {
     __check_closed();
     if(f) {
-        if(fseek(f, i, w) == -1)
+        if(__seek_file(rbuf, f, i, w) == -1)
             throw new OSError();
     }
     return NULL;
@@ -320,7 +624,7 @@ void *file_binary::seek(__ss_int i, __ss_int w) {
 __ss_int file_binary::tell() {
     __check_closed();
     if(f) {
-        long status = ftell(f);
+        long status = __tell_file(rbuf, f);
         if(status == -1)
             throw new OSError();
         return __ss_int(status);
@@ -330,6 +634,17 @@ __ss_int file_binary::tell() {
 
 bytes *file_binary::readline(int n) {
     __check_closed();
+    if(rbuf.enabled()) {
+        const char *data;
+        size_t size;
+        __buffered_readline(rbuf, f, options, __read_cache, size_t(n), data, size);
+        __check_file_map(rbuf, f, name);
+        if(__error())
+            throw new OSError();
+        bytes *b = new bytes(data, (__ss_int)size);
+        b->frozen = 1;
+        return b;
+    }
     __read_cache.clear();
     if (options.universal_mode) {
         for(size_t i = 0; i < size_t(n); ++i) {
@@ -372,6 +687,15 @@ bytes *file_binary::readline(int n) {
 
 bytes *file_binary::read(int n) {
     __check_closed();
+    if(rbuf.enabled()) {
+        __buffered_read(rbuf, f, __read_cache, size_t(n));
+        __check_file_map(rbuf, f, name);
+        if(__error())
+            __throw_io_error();
+        bytes *b = new bytes(__read_cache.data(), (__ss_int)__read_cache.size());
+        b->frozen = 1;
+        return b;
+    }
     if(n == 1) {
         const int c = GETC(f);
         if(FERROR(f) != 0) /* avoid virtual call */
@@ -414,6 +738,8 @@ __iter<bytes *> *file_binary::xreadlines() {
 void *file_binary::close() {
     if(f and not closed) {
         flush();
+        __close_file_buffer(rbuf);
+        __GC_BUFFER(char)().swap(__read_cache);
         if(fclose(f))
             throw new OSError();
         closed = 1;
@@ -472,7 +798,7 @@ bool file_binary::__error() {
 }
 
 bool file_binary::__eof() {
-    return (FEOF(f) != 0);
+    return __eof_file(rbuf, f);
 }
 
 __iter<bytes *> *file_binary::__iter__() {
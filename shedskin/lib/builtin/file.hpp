@@ -11,6 +11,27 @@ struct __file_options {
     __file_options() : lastchar('\n'), space(0), universal_mode(false), cr(false) {}
 };
 
+#ifndef __SS_FILE_BUFSIZE
+#define __SS_FILE_BUFSIZE 65536
+#endif
+
+/* read-ahead for regular files, so readline/read scan blocks instead of calling getc per byte
+   (empty for ttys, pipes and unbuffered files, which keep the getc path). read-only files
+   are mapped as a whole instead, and then the 'block' is the entire file (faults tracks
+   truncation of the mapped file, see file.cpp) */
+struct __file_buffer {
+    __GC_VECTOR(char) data;
+    char *map;
+    size_t pos, end;
+    unsigned faults;
+
+    __file_buffer() : map(0), pos(0), end(0), faults(0) {}
+    inline bool enabled() const { return map or !data.empty(); }
+    inline char *begin() { return map ? map : data.data(); }
+    inline size_t avail() const { return end - pos; }
+    inline void reset() { pos = end = 0; }
+};
+
 class file_binary;
 
 class file : public __iter<str *> {
@@ -23,10 +44,11 @@ public:
 
     __ss_int closed;
     __file_options options;
-    __GC_VECTOR(char) __read_cache;
+    __file_buffer rbuf;
+    __GC_BUFFER(char) __read_cache;
 
     file(FILE *g=0) : f(g) {}
-    file(str *name, str *mode=0);
+    file(str *name, str *mode=0, __ss_int buffering=-1);
 
     virtual void * close();
     virtual void * flush();
@@ -52,6 +74,8 @@ public:
     virtual bool __eof();
     virtual bool __error();
 
+    bool __next_line(const char *&data, size_t &size);
+
     inline void __check_closed() {
         if(closed)
             throw new ValueError(new str("I/O operation on closed file"));
@@ -68,10 +92,11 @@ public:
     FILE *f;
     __ss_int closed;
     __file_options options;
-    __GC_VECTOR(char) __read_cache;
+    __file_buffer rbuf;
+    __GC_BUFFER(char) __read_cache;
 
     file_binary(FILE *g=0) : f(g) {}
-    file_binary(str *name, str *mode=0);
+    file_binary(str *name, str *mode=0, __ss_int buffering=-1);
 
     virtual void * close();
     virtual void * flush();
@@ -102,10 +127,10 @@ public:
     }
 };
 
-file *open(str *name, str *flags = 0);
-file *open(bytes *name, str *flags = 0);
-file_binary *open_binary(str *name, str *flags = 0);
-file_binary *open_binary(bytes *name, str *flags = 0); /* ugly duplication.. use str/byte template? */
+file *open(str *name, str *flags = 0, __ss_int buffering = -1);
+file *open(bytes *name, str *flags = 0, __ss_int buffering = -1);
+file_binary *open_binary(str *name, str *flags = 0, __ss_int buffering = -1);
+file_binary *open_binary(bytes *name, str *flags = 0, __ss_int buffering = -1); /* ugly duplication.. use str/byte template? */
 
 extern file *__ss_stdin, *__ss_stdout, *__ss_stderr;
 
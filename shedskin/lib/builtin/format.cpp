@@ -80,3 +80,42 @@ str *__escape_bytes(pyobj *p) {
 
     return new str(ss.str().c_str());
 }
+
+#ifdef __SS_BIGINT
+/* %d/%x of a bignum (asprintf cannot take one): flags, width and precision applied by hand */
+void __mod_bigint(str *result, const char *fstr, __ss_int arg, int base, bool upper) {
+    bool left = false, zero = false, alt = false;
+    char sign = arg < 0 ? '-' : 0;
+    const char *p = fstr + 1;
+    for(; *p && strchr("-+ 0#", *p); p++) {
+        if(*p == '-') left = true;
+        else if(*p == '0') zero = true;
+        else if(*p == '#') alt = true;
+        else if(!sign) sign = *p;
+    }
+    size_t width = strtoul(p, (char **)&p, 10), precision = 0;
+    if(*p == '.')
+        precision = strtoul(p + 1, (char **)&p, 10);
+
+    std::string digits = __bi_digits(arg, base);
+    if(upper)
+        std::transform(digits.begin(), digits.end(), digits.begin(), ::toupper);
+    if(digits.size() < precision)
+        digits.insert(0, precision - digits.size(), '0');
+    std::string prefix;
+    if(sign)
+        prefix += sign;
+    if(alt && base == 16)
+        prefix += upper ? "0X" : "0x";
+
+    size_t len = prefix.size() + digits.size();
+    if(len >= width)
+        result->unit += prefix + digits;
+    else if(left)
+        result->unit += prefix + digits + std::string(width - len, ' ');
+    else if(zero)
+        result->unit += prefix + std::string(width - len, '0') + digits;
+    else
+        result->unit += std::string(width - len, ' ') + prefix + digits;
+}
+#endif
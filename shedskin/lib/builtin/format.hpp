@@ -11,6 +11,10 @@ int asprintf(char **ret, const char *format, ...);
 
 str *__escape_bytes(bytes *t);
 
+#ifdef __SS_BIGINT
+void __mod_bigint(str *result, const char *fstr, __ss_int arg, int base, bool upper);
+#endif
+
 template <class T> void *__mod_dict_arg(T, str *) { return NULL; }
 template <class V> V __mod_dict_arg(dict<str *, V> *d, str *name) {
     return d->__getitem__(name);
@@ -25,7 +29,13 @@ template <class T> void __mod_int(str *, size_t &, const char *, T) {}
 template<> inline void __mod_int(str *result, size_t &, const char *fstr, __ss_int arg) {
     char *d;
     int x;
+#ifdef __SS_BIGINT
+    if(!arg.small())
+        return __mod_bigint(result, fstr, arg, 10, false);
+    x = asprintf(&d, fstr, (long)arg.value());
+#else
     x = asprintf(&d, fstr, arg); // TODO modern C++ replacement for asprintf?
+#endif
     if(x == -1)
         throw new ValueError(new str("error in string formatting"));
     result->unit += d;
@@ -41,10 +51,16 @@ template<> inline void __mod_oct(str *result, size_t &, __ss_int arg) { // TODO
 }
 
 template <class T> void __mod_hex(str *, size_t &, char, const char *, T) {}
-template<> inline void __mod_hex(str *result, size_t &, char, const char *fstr, __ss_int arg) {
+template<> inline void __mod_hex(str *result, size_t &, char c, const char *fstr, __ss_int arg) {
     char *d;
     int x;
+#ifdef __SS_BIGINT
+    if(!arg.small())
+        return __mod_bigint(result, fstr, arg, 16, c == 'X');
+    x = asprintf(&d, fstr, (long)arg.value());
+#else
     x = asprintf(&d, fstr, arg); // TODO modern C++ replacement for asprintf?
+#endif
     if(x == -1)
         throw new ValueError(new str("error in string formatting"));
     result->unit += d;
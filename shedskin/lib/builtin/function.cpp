@@ -17,17 +17,52 @@ str *input(str *msg) {
 
 /* int */
 
+#ifdef __SS_BIGINT
+/* strtoll, continuing as a bignum when the value does not fit */
+static __ss_int __strtoi(const char *s, char **cp, int base) {
+    errno = 0;
+    long long i = strtoll(s, cp, base);
+    if(errno != ERANGE)
+        return i;
+    const char *p = s;
+    while(::isspace((unsigned char)*p))
+        p++;
+    bool neg = (*p == '-');
+    if(*p == '-' || *p == '+')
+        p++;
+    if((base == 16 || base == 0) && p[0] == '0' && ::tolower((unsigned char)p[1]) == 'x') {
+        p += 2;
+        base = 16;
+    } else if(base == 0)
+        base = (p[0] == '0') ? 8 : 10;
+    const char *q = p;
+    for(; *q; q++) {
+        int c = ::tolower((unsigned char)*q);
+        int d = ::isdigit(c) ? c - '0' : (c >= 'a' && c <= 'z') ? c - 'a' + 10 : base;
+        if(d >= base)
+            break;
+    }
+    *cp = (char *)q;
+    __ss_int r = __bi_parse(p, (size_t)(q - p), base);
+    return neg ? -r : r;
+}
+#endif
+
 __ss_int __int(str *s, __ss_int base) {
     char *cp;
     __ss_int i;
-#ifdef __SS_LONG
+#if defined(__SS_BIGINT)
+    i = __strtoi(s->c_str(), &cp, base);
+#elif defined(__SS_LONG)
     i = (__ss_int)strtoll(s->c_str(), &cp, base);
 #else
     i = (__ss_int)strtol(s->c_str(), &cp, base);
 #endif
     if(*cp != '\0') {
         s = s->rstrip();
-        #ifdef __SS_LONG
+        #if defined(__SS_BIGINT)
+            i = __strtoi(s->c_str(), &cp, base);
+        #elif defined(__SS_LONG)
             i = (__ss_int)strtoll(s->c_str(), &cp, base);
         #else
             i = (__ss_int)strtol(s->c_str(), &cp, base);
@@ -41,14 +76,18 @@ __ss_int __int(str *s, __ss_int base) {
 __ss_int __int(bytes *s, __ss_int base) {
     char *cp;
     __ss_int i;
-#ifdef __SS_LONG
+#if defined(__SS_BIGINT)
+    i = __strtoi(s->c_str(), &cp, base);
+#elif defined(__SS_LONG)
     i = (__ss_int)strtoll(s->c_str(), &cp, base);
 #else
     i = (__ss_int)strtol(s->c_str(), &cp, base);
 #endif
     if(*cp != '\0') {
         s = s->rstrip();
-        #ifdef __SS_LONG
+        #if defined(__SS_BIGINT)
+            i = __strtoi(s->c_str(), &cp, base);
+        #elif defined(__SS_LONG)
             i = (__ss_int)strtoll(s->c_str(), &cp, base);
         #else
             i = (__ss_int)strtol(s->c_str(), &cp, base);
@@ -100,6 +139,8 @@ class __rangeiter : public __iter<__ss_int> {
 public:
     __ss_int i, a, b, s;
 
+    __SS_GC_TYPED(__rangeiter, member(&__rangeiter::i).member(&__rangeiter::a).member(&__rangeiter::b).member(&__rangeiter::s))
+
     __rangeiter(__ss_int a_, __ss_int b_, __ss_int s_) {
         this->__class__ = cl_rangeiter;
 
@@ -46,6 +46,8 @@ str *__str(__ss_bool b);
 str *__str(void *);
 str *__str();
 
+str *__intern(str *s);
+
 /* abs */
 
 template<class T> inline T __abs(T t) { return t->__abs__(); }
@@ -95,6 +97,59 @@ template<> inline complex __zero<complex>() { return mcomplex(0,0); }
 
 /* sum */
 
+/* list<__ss_int> and list<__ss_float> (and array) fast paths work directly on contiguous
+   storage, in loops with independent lanes that the compiler can vectorize (so float sums
+   may differ from a sequential sum in the last bits) */
+
+#define __SS_LANES 8
+
+template<class S, class R = S> inline R __sum_lanes(const S *p, size_t n) { /* (accumulating in R) */
+    R lane[__SS_LANES] = {};
+    size_t i = 0;
+    for(; i+__SS_LANES <= n; i += __SS_LANES)
+        for(size_t j=0; j<__SS_LANES; j++)
+            lane[j] += (R)p[i+j];
+    R r = lane[0];
+    for(size_t j=1; j<__SS_LANES; j++)
+        r += lane[j];
+    for(; i<n; i++)
+        r += (R)p[i];
+    return r;
+}
+
+template<class T, int C> inline T __minmax_lanes(const T *p, size_t n) { /* (n > 0; first of equal values, as __cmp) */
+    T lane[__SS_LANES];
+    for(size_t j=0; j<__SS_LANES; j++)
+        lane[j] = p[0];
+    size_t i = 0;
+    for(; i+__SS_LANES <= n; i += __SS_LANES)
+        for(size_t j=0; j<__SS_LANES; j++)
+            lane[j] = (C == 1 ? p[i+j] > lane[j] : p[i+j] < lane[j]) ? p[i+j] : lane[j];
+    T r = lane[0];
+    for(size_t j=1; j<__SS_LANES; j++)
+        r = (C == 1 ? lane[j] > r : lane[j] < r) ? lane[j] : r;
+    for(; i<n; i++)
+        r = (C == 1 ? p[i] > r : p[i] < r) ? p[i] : r;
+    if constexpr (std::is_floating_point_v<T>) /* equal need not be identical (0.0 and -0.0). r is NaN only if p[0] is */
+        return r == r ? *std::find(p, p+n, r) : p[0];
+    return r;
+}
+
+template<class T> inline bool __any_lanes(const T *p, size_t n, bool zero) { /* (any element (non)zero?) */
+    size_t i = 0;
+    for(; i+__SS_LANES <= n; i += __SS_LANES) {
+        bool b = false;
+        for(size_t j=0; j<__SS_LANES; j++)
+            b |= ((p[i+j] == 0) == zero);
+        if(b)
+            return true;
+    }
+    for(; i<n; i++)
+        if((p[i] == 0) == zero)
+            return true;
+    return false;
+}
+
 template<class A> struct __sumtype1 { typedef A type; };
 template<> struct __sumtype1<__ss_bool> { typedef int type; };
 
@@ -128,6 +183,16 @@ template <class U, class B> typename __sumtype2<typename U::for_in_unit,B>::type
     return __add((typename __sumtype2<typename U::for_in_unit,B>::type)b, (typename __sumtype2<typename U::for_in_unit,B>::type)result1);
 }
 
+#ifndef __SS_BIGINT
+inline __ss_int __sum(list<__ss_int> *l) {
+    return __sum_lanes(l->units.data(), l->units.size());
+}
+#endif
+
+inline __ss_float __sum(list<__ss_float> *l) {
+    return __sum_lanes(l->units.data(), l->units.size());
+}
+
 /* max */
 
 template<class A, class B> typename A::for_in_unit ___max(int, B (*key)(typename A::for_in_unit), A *iter) {
@@ -185,6 +250,16 @@ template<class A, class B> typename A::for_in_unit ___max(int, pycall1<B, typena
 }
 template<class A> typename A::for_in_unit ___max(int nn, int, A *iter) { return ___max(nn, (int (*)(typename A::for_in_unit))0, iter); }
 
+template<class T> inline T __max_list(list<T> *l) {
+    if(l->units.empty())
+        throw new ValueError(new str("max() arg is an empty sequence"));
+    return __minmax_lanes<T, 1>(l->units.data(), l->units.size());
+}
+#ifndef __SS_BIGINT
+inline __ss_int ___max(int, int, list<__ss_int> *l) { return __max_list(l); }
+#endif
+inline __ss_float ___max(int, int, list<__ss_float> *l) { return __max_list(l); }
+
 template<class T, class B> inline T ___max(int, B (*key)(T), T a, T b) { return (__cmp(key(a), key(b))==1)?a:b; }
 template<class T> inline  T ___max(int, int, T a, T b) { return (__cmp(a, b)==1)?a:b; }
 
@@ -245,6 +320,16 @@ template<class A, class B> typename A::for_in_unit ___min(int, B (*key)(typename
 }
 template<class A> typename A::for_in_unit ___min(int nn, int, A *iter) { return ___min(nn, (int (*)(typename A::for_in_unit))0, iter); }
 
+template<class T> inline T __min_list(list<T> *l) {
+    if(l->units.empty())
+        throw new ValueError(new str("min() arg is an empty sequence"));
+    return __minmax_lanes<T, -1>(l->units.data(), l->units.size());
+}
+#ifndef __SS_BIGINT
+inline __ss_int ___min(int, int, list<__ss_int> *l) { return __min_list(l); }
+#endif
+inline __ss_float ___min(int, int, list<__ss_float> *l) { return __min_list(l); }
+
 template<class T, class B> inline T ___min(int, B (*key)(T), T a, T b) { return (__cmp(key(a), key(b))==-1)?a:b; }
 template<class T> inline  T ___min(int, int, T a, T b) { return (__cmp(a, b)==-1)?a:b; }
 
@@ -316,6 +401,8 @@ public:
     __ss_int a, b, s; // TODO remove
     __ss_int start, stop, step;
 
+    __SS_GC_TYPED(__xrange, member(&__xrange::a).member(&__xrange::b).member(&__xrange::s).member(&__xrange::start).member(&__xrange::stop).member(&__xrange::step))
+
     __xrange(__ss_int a, __ss_int b, __ss_int s);
 
     __ss_int count(__ss_int value);
@@ -671,6 +758,9 @@ template<class A> __ss_bool any(A *iter) {
     return False;
 }
 
+inline __ss_bool any(list<__ss_int> *l) { return __mbool(__any_lanes(l->units.data(), l->units.size(), false)); }
+inline __ss_bool any(list<__ss_float> *l) { return __mbool(__any_lanes(l->units.data(), l->units.size(), false)); }
+
 /* all */
 
 template<class A> __ss_bool all(A *iter) {
@@ -685,6 +775,9 @@ template<class A> __ss_bool all(A *iter) {
     return True;
 }
 
+inline __ss_bool all(list<__ss_int> *l) { return __mbool(!__any_lanes(l->units.data(), l->units.size(), true)); }
+inline __ss_bool all(list<__ss_float> *l) { return __mbool(!__any_lanes(l->units.data(), l->units.size(), true)); }
+
 /* ord */
 
 static void __throw_ord_exc(size_t s) { /* improve inlining */
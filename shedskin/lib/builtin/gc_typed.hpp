@@ -0,0 +1,99 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef SS_GC_TYPED_HPP
+#define SS_GC_TYPED_HPP
+
+/* precise (typed) allocation
+
+   by default, objects are scanned conservatively: every word is considered a possible
+   pointer, including integers, floats and cached hashes. classes with scalar members can
+   instead allocate through a descriptor (a bitmap of words that may hold pointers), so the
+   collector skips those members. as pointers are word-aligned, any word overlapping a scalar
+   member cannot hold one; all other words (including base class members) are still scanned.
+
+   typed objects carry their descriptor in an extra word, so only classes with scalar
+   members should use this. */
+
+template<class T> struct __gc_ptrfree : std::is_arithmetic<T> {};
+template<> struct __gc_ptrfree<__ss_bool> : std::true_type {};
+template<> struct __gc_ptrfree<complex> : std::true_type {};
+
+/* element arrays of STL containers are allocated atomically (unscanned) when pointer-free */
+
+} // namespace __shedskin__
+
+template<> struct GC_type_traits<__shedskin__::__ss_bool> { GC_true_type GC_is_ptr_free; };
+template<> struct GC_type_traits<__shedskin__::complex> { GC_true_type GC_is_ptr_free; };
+
+namespace __shedskin__ {
+
+#ifndef __SS_ARENA
+template<class T> class __gc_layout {
+    GC_word bitmap[GC_BITMAP_SIZE(T)];
+    GC_descr descr;
+    bool precise;
+
+    void scalar(size_t offset, size_t size) {
+        for(size_t i = offset / sizeof(GC_word); i < (offset + size + sizeof(GC_word) - 1) / sizeof(GC_word); i++) {
+            bitmap[i / GC_WORDSZ] &= ~((GC_word)1 << (i % GC_WORDSZ));
+            precise = true;
+        }
+    }
+
+public:
+    __gc_layout() : descr(0), precise(false) {
+        for(size_t i = 0; i < GC_BITMAP_SIZE(T); i++)
+            bitmap[i] = 0;
+        for(size_t i = 0; i < GC_WORD_LEN(T); i++)
+            bitmap[i / GC_WORDSZ] |= (GC_word)1 << (i % GC_WORDSZ);
+    }
+
+    template<class M, class C> static size_t offset(M C::*m) {
+        alignas(T) char probe[sizeof(T)];
+        return (size_t)((char *)&(reinterpret_cast<T *>(probe)->*m) - probe);
+    }
+
+    /* declare member: pointer-free members are skipped by the collector */
+    template<class M, class C> __gc_layout &member(M C::*m) {
+        if(__gc_ptrfree<M>::value)
+            scalar(offset(m), sizeof(M));
+        return *this;
+    }
+
+#if defined(__GLIBCXX__) && _GLIBCXX_USE_CXX11_ABI
+    /* only the data pointer of a libstdc++ string can point into the heap: its length and
+       in-situ buffer are scalar */
+    __gc_layout &member(__GC_STRING T::*m) {
+        scalar(offset(m) + sizeof(char *), sizeof(__GC_STRING) - sizeof(char *));
+        return *this;
+    }
+#endif
+
+    __gc_layout &done() {
+        if(precise)
+            descr = GC_make_descriptor(bitmap, GC_WORD_LEN(T));
+        return *this;
+    }
+
+    inline void *alloc(size_t size) const {
+        if(!precise || size != sizeof(T)) /* (subclass without its own layout) */
+            return GC_MALLOC(size);
+        return GC_malloc_explicitly_typed(size, descr);
+    }
+};
+
+/* inside a class body: __SS_GC_TYPED(T, member(&T::a).member(&T::b)) */
+
+#define __SS_GC_TYPED(T, members) \
+    using gc::operator new; \
+    static void *operator new(size_t size) { \
+        static __gc_layout<T> layout = __gc_layout<T>().members.done(); \
+        return layout.alloc(size); \
+    }
+
+#else
+/* (nothing is scanned with --arena) */
+#define __SS_GC_TYPED(T, members)
+#endif
+
+#endif
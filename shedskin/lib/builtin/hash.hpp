@@ -15,6 +15,16 @@ template<class T> inline long hasher(T t) {
     template<> inline long hasher(__ss_int a) { return (long)std::hash<__ss_int>{}(a); }
 #elif defined(__SS_INT128)
     template<> inline long hasher(__ss_int a) { return hash_combine(std::hash<int64_t>{}((int64_t)a), std::hash<int64_t>{}((int64_t)(a>>64))); }
+#elif defined(__SS_BIGINT)
+    /* (modulo 2**61-1, as in CPython) */
+    template<> inline long hasher(__ss_int a) {
+        if(a.small()) {
+            long long v = a.value();
+            if(v > -(1LL << 61) + 1 && v < (1LL << 61) - 1 && v != -1)
+                return (long)v;
+        }
+        return __bi_hash(a);
+    }
 #endif
 
 template<> inline long hasher(int a) { return (long)std::hash<int>{}(a); } // TODO avoid by updating lib code with __ss_int
@@ -22,6 +32,11 @@ template<> inline long hasher(__ss_float a) { return (long)std::hash<__ss_float>
 template<> inline long hasher(__ss_bool a) { return (long)std::hash<uint8_t>{}(a.value); }
 template<> inline long hasher(void *v) { return (long)std::hash<void *>{}(v); }
 
+/* the hash() builtin, which returns an int (not a long, which would print as None) */
+template<class T> inline __ss_int __ss_hash(T t) {
+    return (__ss_int)hasher<T>(t);
+}
+
 template<class T> class ss_hash {
     public:
         long operator()(const T t) const {
@@ -0,0 +1,495 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef SS_HASHTABLE_HPP
+#define SS_HASHTABLE_HPP
+
+/* open-addressing hash tables for dict and set, with cached hashes
+
+   __dicttable is a compact, insertion-ordered table (modeled after CPython's dictobject.c):
+   entries are stored densely, in insertion order, together with their cached hash.
+   a separate power-of-two index array maps hash slots to entry positions, and is
+   probed using open addressing with perturbation. deleted entries are left in place
+   (with a special hash value) until the next resize compacts the entries array.
+
+   __settable is a flat table of (hash, key) entries (modeled after CPython's setobject.c),
+   probed linearly for a few entries (so mostly within a cache line) before perturbing. */
+
+#define __SS_TABLE_MINSIZE 8
+#define __SS_TABLE_PERTURB_SHIFT 5
+#define __SS_TABLE_LINEAR_PROBES 9
+
+#define __SS_IX_EMPTY (-1)
+#define __SS_IX_DUMMY (-2)
+
+#define __SS_HASH_DELETED ((size_t)-1)
+#define __SS_HASH_EMPTY ((size_t)-1)
+#define __SS_HASH_DUMMY ((size_t)-2)
+
+void __throw_table_overflow();
+
+/* hash, avoiding the values reserved for table bookkeeping */
+
+template<class T> inline size_t __table_hash(const T &key) {
+    size_t hash = (size_t)hasher<T>(key);
+    if(hash >= __SS_HASH_DUMMY)
+        hash -= 2;
+    return hash;
+}
+
+/* key equality, once cached hashes are known to be equal */
+
+template<class T> inline bool __table_eq(T a, T b) {
+    return a == b || __eq<T>(a, b);
+}
+template<> inline bool __table_eq(__ss_int a, __ss_int b) {
+    return a == b;
+}
+template<> inline bool __table_eq(str *a, str *b) {
+    if(a == b)
+        return true;
+    if(!a || !b || (a->interned && b->interned))
+        return false;
+    size_t len = a->unit.size();
+    return len == b->unit.size() && memcmp(a->unit.data(), b->unit.data(), len) == 0;
+}
+
+template<class K, class V> struct __dictentry {
+    size_t hash;
+    K first;
+    V second;
+};
+
+template<class K, class V> class __dicttable {
+public:
+    typedef __dictentry<K, V> entry;
+
+    __GC_VECTOR(entry) entries;  /* dense, in insertion order */
+    __GC_VECTOR(int32_t) indices; /* sparse, empty until first insertion */
+    size_t used;   /* number of live entries */
+    size_t usable; /* number of insertions left before resize */
+
+    __dicttable() : used(0), usable(0) {}
+
+    /* iteration (positional, so it survives reallocation of the entries array) */
+
+    class iterator {
+    public:
+        __dicttable<K, V> *t;
+        size_t pos;
+
+        iterator() : t(NULL), pos(0) {}
+        iterator(__dicttable<K, V> *t, size_t pos) : t(t), pos(pos) { skip(); }
+
+        inline void skip() {
+            size_t n = t->entries.size();
+            while(pos < n && t->entries[pos].hash == __SS_HASH_DELETED)
+                pos++;
+        }
+
+        inline entry &operator*() const { return t->entries[pos]; }
+        inline entry *operator->() const { return &t->entries[pos]; }
+
+        inline iterator &operator++() { pos++; skip(); return *this; }
+        inline iterator operator++(int) { iterator r = *this; pos++; skip(); return r; }
+
+        inline bool operator==(const iterator &b) const { return pos == b.pos; }
+        inline bool operator!=(const iterator &b) const { return pos != b.pos; }
+
+        /* loops use this, as popitem() or clear() may shrink the entries array
+           below the current position */
+        inline bool operator<(const iterator &b) const { return pos < b.pos; }
+    };
+
+    inline iterator begin() { return iterator(this, 0); }
+    inline iterator end() { iterator it; it.t = this; it.pos = entries.size(); return it; }
+
+    inline size_t size() const { return used; }
+    inline bool empty() const { return used == 0; }
+
+    static inline size_t hashof(const K &key) {
+        return __table_hash<K>(key);
+    }
+
+    /* locate key: returns entry position or -1, and sets slot to the index slot
+       holding it (or, if not found, the first free slot) */
+    inline int32_t lookup(const K &key, size_t hash, size_t &slot) {
+        size_t mask = indices.size() - 1;
+        size_t perturb = hash;
+        size_t i = hash & mask;
+        size_t freeslot = (size_t)-1;
+
+        while(1) {
+            int32_t ix = indices[i];
+            if(ix == __SS_IX_EMPTY) {
+                slot = (freeslot == (size_t)-1) ? i : freeslot;
+                return -1;
+            }
+            if(ix == __SS_IX_DUMMY) {
+                if(freeslot == (size_t)-1)
+                    freeslot = i;
+            } else {
+                entry &e = entries[ix];
+                if(e.hash == hash && __table_eq<K>(e.first, key)) {
+                    slot = i;
+                    return ix;
+                }
+            }
+            perturb >>= __SS_TABLE_PERTURB_SHIFT;
+            i = (i*5 + perturb + 1) & mask;
+        }
+    }
+
+    /* find index slot pointing to entry position ix */
+    inline size_t lookup_index(size_t hash, int32_t ix) const {
+        size_t mask = indices.size() - 1;
+        size_t perturb = hash;
+        size_t i = hash & mask;
+
+        while(indices[i] != ix) {
+            perturb >>= __SS_TABLE_PERTURB_SHIFT;
+            i = (i*5 + perturb + 1) & mask;
+        }
+        return i;
+    }
+
+    /* find first empty slot for hash (no dummies present after resize) */
+    inline size_t find_empty_slot(size_t hash) const {
+        size_t mask = indices.size() - 1;
+        size_t perturb = hash;
+        size_t i = hash & mask;
+
+        while(indices[i] != __SS_IX_EMPTY) {
+            perturb >>= __SS_TABLE_PERTURB_SHIFT;
+            i = (i*5 + perturb + 1) & mask;
+        }
+        return i;
+    }
+
+    /* rebuild index array with room for at least minused entries, compacting entries */
+    void resize(size_t minused) {
+        size_t newsize = __SS_TABLE_MINSIZE;
+        while(newsize*2/3 < minused)
+            newsize <<= 1;
+        if(newsize > (size_t)INT32_MAX)
+            __throw_table_overflow();
+
+        if(used != entries.size()) {
+            size_t j = 0;
+            for(size_t i = 0; i < entries.size(); i++)
+                if(entries[i].hash != __SS_HASH_DELETED)
+                    entries[j++] = entries[i];
+            entries.resize(j);
+        }
+
+        indices.assign(newsize, __SS_IX_EMPTY);
+        for(size_t i = 0; i < used; i++)
+            indices[find_empty_slot(entries[i].hash)] = (int32_t)i;
+
+        usable = newsize*2/3 - used;
+        entries.reserve(newsize*2/3);
+    }
+
+    inline void reserve(size_t n) {
+        if(n > used + usable)
+            resize(n);
+    }
+
+    inline iterator find(const K &key) {
+        if(used == 0)
+            return end();
+        size_t slot;
+        int32_t ix = lookup(key, hashof(key), slot);
+        if(ix == -1)
+            return end();
+        iterator it;
+        it.t = this;
+        it.pos = (size_t)ix;
+        return it;
+    }
+
+    inline bool contains(const K &key) {
+        if(used == 0)
+            return false;
+        size_t slot;
+        return lookup(key, hashof(key), slot) != -1;
+    }
+
+    /* returns entry for key, inserting a new one with value v if not yet present */
+    inline entry &insert(const K &key, const V &v, bool &inserted) {
+        size_t hash = hashof(key);
+        size_t slot;
+        if(!indices.empty()) {
+            int32_t ix = lookup(key, hash, slot);
+            if(ix != -1) {
+                inserted = false;
+                return entries[ix];
+            }
+        }
+        if(usable == 0) {
+            resize(used*3);
+            slot = find_empty_slot(hash);
+        }
+        indices[slot] = (int32_t)entries.size();
+        entries.push_back(entry{hash, key, v});
+        used++;
+        usable--;
+        inserted = true;
+        return entries.back();
+    }
+
+    inline V &operator[](const K &key) {
+        bool inserted;
+        return insert(key, V(), inserted).second;
+    }
+
+    void erase(iterator it) {
+        entry &e = entries[it.pos];
+        indices[lookup_index(e.hash, (int32_t)it.pos)] = __SS_IX_DUMMY;
+        e = entry{__SS_HASH_DELETED, K(), V()}; /* release references */
+        used--;
+        if(it.pos == entries.size()-1) /* popitem: keep removing from the end */
+            while(!entries.empty() && entries.back().hash == __SS_HASH_DELETED)
+                entries.pop_back();
+    }
+
+    /* last live entry (for LIFO popitem) */
+    inline iterator last() {
+        iterator it;
+        it.t = this;
+        it.pos = entries.size()-1;
+        return it;
+    }
+
+    void clear() {
+        entries.clear();
+        indices.clear();
+        used = usable = 0;
+    }
+};
+
+template<class T> struct __setentry {
+    size_t hash; /* __SS_HASH_EMPTY, __SS_HASH_DUMMY or cached key hash */
+    T key;
+};
+
+template<class T> class __settable {
+public:
+    typedef __setentry<T> entry;
+
+    __GC_VECTOR(entry) table; /* power-of-two size, empty until first insertion */
+    size_t used;   /* number of live entries */
+    size_t fill;   /* number of live and dummy entries */
+    size_t finger; /* search start for pop() */
+
+    __settable() : used(0), fill(0), finger(0) {}
+
+    static inline bool live(const entry &e) { return e.hash < __SS_HASH_DUMMY; }
+
+    /* iteration (positional, so it survives reallocation of the table) */
+
+    class iterator {
+    public:
+        __settable<T> *t;
+        size_t pos;
+
+        iterator() : t(NULL), pos(0) {}
+        iterator(__settable<T> *t, size_t pos) : t(t), pos(pos) { skip(); }
+
+        inline void skip() {
+            size_t n = t->table.size();
+            while(pos < n && !live(t->table[pos]))
+                pos++;
+        }
+
+        inline T &operator*() const { return t->table[pos].key; }
+        inline T *operator->() const { return &t->table[pos].key; }
+        inline size_t hash() const { return t->table[pos].hash; }
+
+        inline iterator &operator++() { pos++; skip(); return *this; }
+        inline iterator operator++(int) { iterator r = *this; pos++; skip(); return r; }
+
+        inline bool operator==(const iterator &b) const { return pos == b.pos; }
+        inline bool operator!=(const iterator &b) const { return pos != b.pos; }
+    };
+
+    inline iterator begin() { return iterator(this, 0); }
+    inline iterator end() { iterator it; it.t = this; it.pos = table.size(); return it; }
+
+    inline size_t size() const { return used; }
+    inline bool empty() const { return used == 0; }
+
+    static inline size_t hashof(const T &key) {
+        return __table_hash<T>(key);
+    }
+
+    /* locate key: if found, sets slot to its table position, otherwise to the
+       first free (empty or dummy) position on its probe sequence */
+    inline bool lookup(const T &key, size_t hash, size_t &slot) {
+        size_t mask = table.size() - 1;
+        size_t perturb = hash;
+        size_t i = hash & mask;
+        size_t freeslot = (size_t)-1;
+
+        while(1) {
+            size_t probes = (i + __SS_TABLE_LINEAR_PROBES <= mask) ? __SS_TABLE_LINEAR_PROBES : 0;
+            for(size_t j = i; j <= i + probes; j++) {
+                entry &e = table[j];
+                if(e.hash == __SS_HASH_EMPTY) {
+                    slot = (freeslot == (size_t)-1) ? j : freeslot;
+                    return false;
+                }
+                if(e.hash == hash) {
+                    if(__table_eq<T>(e.key, key)) {
+                        slot = j;
+                        return true;
+                    }
+                } else if(e.hash == __SS_HASH_DUMMY && freeslot == (size_t)-1)
+                    freeslot = j;
+            }
+            perturb >>= __SS_TABLE_PERTURB_SHIFT;
+            i = (i*5 + 1 + perturb) & mask;
+        }
+    }
+
+    /* insert entry known not to be present, into a table without dummies */
+    inline void insert_clean(const T &key, size_t hash) {
+        size_t mask = table.size() - 1;
+        size_t perturb = hash;
+        size_t i = hash & mask;
+
+        while(1) {
+            size_t probes = (i + __SS_TABLE_LINEAR_PROBES <= mask) ? __SS_TABLE_LINEAR_PROBES : 0;
+            for(size_t j = i; j <= i + probes; j++) {
+                entry &e = table[j];
+                if(e.hash == __SS_HASH_EMPTY) {
+                    e.hash = hash;
+                    e.key = key;
+                    return;
+                }
+            }
+            perturb >>= __SS_TABLE_PERTURB_SHIFT;
+            i = (i*5 + 1 + perturb) & mask;
+        }
+    }
+
+    /* rebuild table with more than minused slots, dropping dummies */
+    void resize(size_t minused) {
+        size_t newsize = __SS_TABLE_MINSIZE;
+        while(newsize <= minused)
+            newsize <<= 1;
+
+        __GC_VECTOR(entry) old;
+        old.swap(table);
+        table.assign(newsize, entry{__SS_HASH_EMPTY, T()});
+        for(size_t i = 0; i < old.size(); i++)
+            if(live(old[i]))
+                insert_clean(old[i].key, old[i].hash);
+        fill = used;
+        finger = 0;
+    }
+
+    /* make room for n live entries without resizing (used by bulk operations) */
+    inline void reserve(size_t n) {
+        if(table.empty() || (n*5 >= (table.size()-1)*3))
+            resize(n*2);
+    }
+
+    inline bool contains(const T &key, size_t hash) {
+        if(used == 0)
+            return false;
+        size_t slot;
+        return lookup(key, hash, slot);
+    }
+
+    inline bool contains(const T &key) {
+        if(used == 0)
+            return false;
+        return contains(key, hashof(key));
+    }
+
+    inline iterator find(const T &key) {
+        if(used == 0)
+            return end();
+        size_t slot;
+        if(!lookup(key, hashof(key), slot))
+            return end();
+        iterator it;
+        it.t = this;
+        it.pos = slot;
+        return it;
+    }
+
+    /* returns true if key was not yet present */
+    inline bool insert(const T &key, size_t hash) {
+        size_t slot;
+        if(table.empty())
+            resize(0);
+        if(lookup(key, hash, slot))
+            return false;
+        entry &e = table[slot];
+        if(e.hash == __SS_HASH_EMPTY)
+            fill++;
+        e.hash = hash;
+        e.key = key;
+        used++;
+        if(fill*5 >= (table.size()-1)*3)
+            resize(used > 50000 ? used*2 : used*4);
+        return true;
+    }
+
+    inline bool insert(const T &key) {
+        return insert(key, hashof(key));
+    }
+
+    inline void erase(iterator it) {
+        entry &e = table[it.pos];
+        e.hash = __SS_HASH_DUMMY;
+        e.key = T(); /* release reference */
+        used--;
+    }
+
+    /* returns true if key was present */
+    inline bool erase(const T &key) {
+        iterator it = find(key);
+        if(it == end())
+            return false;
+        erase(it);
+        return true;
+    }
+
+    /* remove and return an arbitrary entry (assumes non-empty) */
+    T pop() {
+        size_t mask = table.size() - 1;
+        size_t i = finger & mask;
+        while(!live(table[i]))
+            i = (i+1) & mask;
+        T key = table[i].key;
+        iterator it;
+        it.t = this;
+        it.pos = i;
+        erase(it);
+        finger = i+1;
+        return key;
+    }
+
+    void clear() {
+        table.clear();
+        used = fill = finger = 0;
+    }
+};
+
+/* entry arrays of tables with pointer-free keys and values (for example, dict[int, float])
+   are not scanned by the GC at all */
+
+} // namespace __shedskin__
+
+template<class K, class V> struct GC_type_traits<__shedskin__::__dictentry<K, V> > {
+    typename std::conditional<__shedskin__::__gc_ptrfree<K>::value && __shedskin__::__gc_ptrfree<V>::value, GC_true_type, GC_false_type>::type GC_is_ptr_free;
+};
+template<class T> struct GC_type_traits<__shedskin__::__setentry<T> > {
+    typename std::conditional<__shedskin__::__gc_ptrfree<T>::value, GC_true_type, GC_false_type>::type GC_is_ptr_free;
+};
+
+namespace __shedskin__ {
+
+#endif
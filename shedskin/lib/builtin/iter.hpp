@@ -43,7 +43,7 @@
 #define FOR_IN_DICT(m, temp, iter, pos) \
     __ ## temp = m; \
     __ ## iter = m->gcd.begin(); \
-	while (__ ## iter != m->gcd.end() ) { \
+	while ((__ ## iter).skip(), __ ## iter < m->gcd.end() ) { \
 
 #define END_FOR }
 
@@ -435,22 +435,32 @@ template<class T> void *list<T>::reverse() {
 }
 
 template<class T> template <class U> void *list<T>::sort(__ss_int (*cmp)(T, T), U (*key)(T), __ss_int reverse) {
+    size_t n = units.size();
     if(key) {
+        typedef __sortentry<U, T> entry;
+        __GC_VECTOR(entry) entries(n);
+        for(size_t i = 0; i < n; i++) {
+            entries[i].key = key(units[i]);
+            entries[i].value = units[i];
+        }
+        typedef __sortentry_less<U, T, __sort_less<U> > entry_less;
         if(reverse)
-            std::sort(units.begin(), units.end(), cpp_cmp_key_rev<T, U>(key));
+            __ss_sort(entries.data(), n, __sort_rev<entry_less>(entry_less(__sort_less<U>())));
         else
-            std::sort(units.begin(), units.end(), cpp_cmp_key<T, U>(key));
+            __ss_sort(entries.data(), n, entry_less(__sort_less<U>()));
+        for(size_t i = 0; i < n; i++)
+            units[i] = entries[i].value;
     }
     else if(cmp) {
         if(reverse)
-            std::sort(units.begin(), units.end(), cpp_cmp_custom_rev<T>(cmp));
+            __ss_sort(units.data(), n, cpp_cmp_custom_rev<T>(cmp));
         else
-            std::sort(units.begin(), units.end(), cpp_cmp_custom<T>(cmp));
+            __ss_sort(units.data(), n, cpp_cmp_custom<T>(cmp));
     } else {
         if(reverse)
-            std::sort(units.begin(), units.end(), cpp_cmp_rev<T>);
+            __ss_sort(units.data(), n, __sort_rev<__sort_less<T> >(__sort_less<T>()));
         else
-            std::sort(units.begin(), units.end(), cpp_cmp<T>);
+            __ss_sort(units.data(), n, __sort_less<T>());
     }
 
     return NULL;
@@ -18,6 +18,7 @@ template<class A> A __power(A a, A b);
 template<> inline __ss_float __power(__ss_float a, __ss_float b) { return pow(a,b); }
 
 template<> inline __ss_int __power(__ss_int a, __ss_int b) {
+#ifndef __SS_BIGINT
     switch(b) {
         case 2: return a*a;
         case 3: return a*a*a;
@@ -29,6 +30,7 @@ template<> inline __ss_int __power(__ss_int a, __ss_int b) {
         case 9: return a*a*a*a*a*a*a*a*a;
         case 10: return a*a*a*a*a*a*a*a*a*a;
     }
+#endif
     __ss_int res, tmp;
 
     res = 1;
@@ -99,7 +101,9 @@ inline __ss_float __divs(__ss_int a, __ss_int b) { return a/((__ss_float)b); }
 template<class A> inline A __floordiv(A a, A b) { return a->__floordiv__(b); }
 template<> inline __ss_float __floordiv(__ss_float a, __ss_float b) { return floor(a/b); }
 
-#ifdef __SS_LONG /* XXX */
+#if defined(__SS_BIGINT)
+template<> inline __ss_int __floordiv(__ss_int a, __ss_int b) { return __bi_floordiv_fast(a, b); }
+#elif defined(__SS_LONG) /* XXX */
 template<> inline __ss_int __floordiv(__ss_int a, __ss_int b) { return (__ss_int)floor((__ss_float)a/b); } /* XXX */
 #endif
 template<> inline int __floordiv(int a, int b) { return (int)floor((__ss_float)a/b); } /* XXX */
@@ -110,7 +114,9 @@ inline __ss_float __floordiv(__ss_float a, __ss_int b) { return floor(a/((__ss_f
 /* modulo */
 
 template<class A> A __mods(A a, A b);
-#ifdef __SS_LONG /* XXX */
+#if defined(__SS_BIGINT)
+template<> inline __ss_int __mods(__ss_int a, __ss_int b) { return __bi_floormod_fast(a, b); }
+#elif defined(__SS_LONG) /* XXX */
 template<> inline __ss_int __mods(__ss_int a, __ss_int b) {
     int m = a%b;
     if((m<0 && b>0)||(m>0 && b<0)) m+=b;
@@ -181,7 +187,9 @@ inline __ss_bool __ss_is_integer(__ss_float d) {
 
 namespace __int___ {
     inline __ss_int bit_count(__ss_int i) {
-#ifdef __SS_LONG
+#if defined(__SS_BIGINT)
+        return __bi_bit_count(i);
+#elif defined(__SS_LONG)
         return (__ss_int)std::bitset<std::numeric_limits<unsigned long long>::digits>((unsigned long long)i).count(); // TODO hard-coded types
 #else
         return (__ss_int)std::bitset<std::numeric_limits<unsigned int>::digits>((unsigned int)i).count();
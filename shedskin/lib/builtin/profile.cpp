@@ -0,0 +1,211 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+/* sampling profiler (--profile) */
+
+#ifdef __SS_PROFILE
+
+#define __SS_PROF_INTERVAL 1000 /* usec */
+#define __SS_PROF_TABLE 8192
+#define __SS_PROF_DEPTH 256
+
+__SS_THREAD_LOCAL __ss_prof_frame *__ss_prof_top;
+
+static std::atomic<__ss_prof_func *> __ss_prof_funcs;
+static unsigned long __ss_prof_samples, __ss_prof_idle, __ss_prof_dropped;
+
+void __ss_prof_register(__ss_prof_func *f) {
+    if(__atomic_exchange_n(&f->registered, true, __ATOMIC_ACQ_REL))
+        return;
+    f->next = __ss_prof_funcs.load();
+    while(!__ss_prof_funcs.compare_exchange_weak(f->next, f));
+}
+
+/* (function, line) and (caller, callee) sample counts, in fixed-size open-addressing tables
+   that can be updated from within the signal handler */
+
+struct __ss_prof_entry {
+    const void *a;
+    const void *b;
+    unsigned long count;
+};
+
+static __ss_prof_entry __ss_prof_lines[__SS_PROF_TABLE];
+static __ss_prof_entry __ss_prof_edges[__SS_PROF_TABLE];
+
+static void __ss_prof_add(__ss_prof_entry *table, const void *a, const void *b) {
+    size_t h = (((size_t)a >> 4) * 31 + (size_t)b) * 2654435761u;
+    for(size_t i = 0; i < __SS_PROF_TABLE; i++) {
+        __ss_prof_entry *e = &table[(h + i) & (__SS_PROF_TABLE - 1)];
+        const void *cur = __atomic_load_n(&e->a, __ATOMIC_ACQUIRE);
+        if(!cur) {
+            const void *expected = 0;
+            if(__atomic_compare_exchange_n(&e->a, &expected, a, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                e->b = b;
+                __atomic_fetch_add(&e->count, 1, __ATOMIC_RELAXED);
+                return;
+            }
+            cur = expected;
+        }
+        if(cur == a && e->b == b) {
+            __atomic_fetch_add(&e->count, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
+    __atomic_fetch_add(&__ss_prof_dropped, 1, __ATOMIC_RELAXED);
+}
+
+#ifndef WIN32
+static void __ss_prof_handler(int) {
+    __ss_prof_frame *top = __ss_prof_top;
+    if(!top) {
+        __atomic_fetch_add(&__ss_prof_idle, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    unsigned long stamp = __atomic_add_fetch(&__ss_prof_samples, 1, __ATOMIC_RELAXED);
+
+    /* (with threads, other handlers may be counting the same functions) */
+    __atomic_fetch_add(&top->func->self, 1, __ATOMIC_RELAXED);
+    __ss_prof_add(__ss_prof_lines, top->func, (const void *)(size_t)top->line);
+
+    int depth = 0;
+    for(__ss_prof_frame *f = top; f && depth < __SS_PROF_DEPTH; f = f->parent, depth++) {
+        if(__atomic_exchange_n(&f->func->stamp, stamp, __ATOMIC_RELAXED) != stamp)
+            __atomic_fetch_add(&f->func->total, 1, __ATOMIC_RELAXED);
+        if(f->parent && f->parent->func != f->func)
+            __ss_prof_add(__ss_prof_edges, f->parent->func, f->func);
+    }
+}
+#endif
+
+/* report */
+
+static FILE *__ss_prof_out;
+
+static void __ss_prof_row(double pct, unsigned long samples) {
+    fprintf(__ss_prof_out, " %6.2f%% %9.3f", pct, samples * (__SS_PROF_INTERVAL / 1e6));
+}
+
+static void __ss_prof_where(__ss_prof_func *f) {
+    fprintf(__ss_prof_out, "%s (%s:%d)", f->name, f->file, f->line);
+}
+
+static bool __ss_prof_by_self(__ss_prof_func *a, __ss_prof_func *b) {
+    return a->self > b->self || (a->self == b->self && a->total > b->total);
+}
+
+static std::vector<__ss_prof_entry> __ss_prof_collect(__ss_prof_entry *table) {
+    /* merge duplicates (from racing inserts), most samples first */
+    std::vector<__ss_prof_entry> v;
+    for(size_t i = 0; i < __SS_PROF_TABLE; i++)
+        if(table[i].a && table[i].count)
+            v.push_back(table[i]);
+    std::sort(v.begin(), v.end(), [](const __ss_prof_entry &x, const __ss_prof_entry &y) {
+        return x.a < y.a || (x.a == y.a && x.b < y.b);
+    });
+    std::vector<__ss_prof_entry> r;
+    for(size_t i = 0; i < v.size(); i++) {
+        if(!r.empty() && r.back().a == v[i].a && r.back().b == v[i].b)
+            r.back().count += v[i].count;
+        else
+            r.push_back(v[i]);
+    }
+    std::stable_sort(r.begin(), r.end(), [](const __ss_prof_entry &x, const __ss_prof_entry &y) {
+        return x.count > y.count;
+    });
+    return r;
+}
+
+static void __ss_prof_report() {
+    fflush(stdout);
+#ifndef WIN32
+    struct itimerval it = {{0, 0}, {0, 0}};
+    setitimer(ITIMER_PROF, &it, NULL);
+#endif
+
+    const char *path = getenv("SHEDSKIN_PROFILE");
+    __ss_prof_out = path ? fopen(path, "w") : NULL;
+    if(!__ss_prof_out)
+        __ss_prof_out = stderr;
+
+    std::vector<__ss_prof_func *> funcs;
+    for(__ss_prof_func *f = __ss_prof_funcs.load(); f; f = f->next)
+        funcs.push_back(f);
+    std::sort(funcs.begin(), funcs.end(), __ss_prof_by_self);
+
+    unsigned long n = __ss_prof_samples;
+    double scale = n ? 100.0 / n : 0.0;
+
+    fprintf(__ss_prof_out, "\nshedskin profile: %lu samples of %d usec", n, __SS_PROF_INTERVAL);
+    if(__ss_prof_idle)
+        fprintf(__ss_prof_out, " (%lu outside of compiled functions)", __ss_prof_idle);
+    if(__ss_prof_dropped)
+        fprintf(__ss_prof_out, " (%lu not attributed to lines/callers: table full)", __ss_prof_dropped);
+    fprintf(__ss_prof_out, "\n\nflat profile:\n\n   %%self    self s  %%total   total s       calls  function\n");
+    for(size_t i = 0; i < funcs.size(); i++) {
+        __ss_prof_func *f = funcs[i];
+        __ss_prof_row(f->self * scale, f->self);
+        __ss_prof_row(f->total * scale, f->total);
+        fprintf(__ss_prof_out, " %11lu  ", f->calls);
+        __ss_prof_where(f);
+        fprintf(__ss_prof_out, "\n");
+    }
+
+    std::vector<__ss_prof_entry> lines = __ss_prof_collect(__ss_prof_lines);
+    fprintf(__ss_prof_out, "\nhot lines:\n\n   %%self    self s  line\n");
+    for(size_t i = 0; i < lines.size() && i < 20; i++) {
+        __ss_prof_func *f = (__ss_prof_func *)lines[i].a;
+        __ss_prof_row(lines[i].count * scale, lines[i].count);
+        fprintf(__ss_prof_out, "  %s:%d (%s)\n", f->file, (int)(size_t)lines[i].b, f->name);
+    }
+
+    /* for each function: callers and callees, with the time spent in the callee on their behalf */
+    std::vector<__ss_prof_entry> edges = __ss_prof_collect(__ss_prof_edges);
+    fprintf(__ss_prof_out, "\ncall graph:\n");
+    std::stable_sort(funcs.begin(), funcs.end(), [](__ss_prof_func *a, __ss_prof_func *b) {
+        return a->total > b->total;
+    });
+    for(size_t i = 0; i < funcs.size(); i++) {
+        __ss_prof_func *f = funcs[i];
+        if(!f->total)
+            continue;
+        fprintf(__ss_prof_out, "\n");
+        __ss_prof_row(f->total * scale, f->total);
+        fprintf(__ss_prof_out, "  ");
+        __ss_prof_where(f);
+        fprintf(__ss_prof_out, "\n");
+        for(size_t j = 0; j < edges.size(); j++)
+            if(edges[j].b == f) {
+                fprintf(__ss_prof_out, "        called from ");
+                __ss_prof_where((__ss_prof_func *)edges[j].a);
+                fprintf(__ss_prof_out, ": %.2f%%\n", edges[j].count * scale);
+            }
+        for(size_t j = 0; j < edges.size(); j++)
+            if(edges[j].a == f) {
+                fprintf(__ss_prof_out, "        calls ");
+                __ss_prof_where((__ss_prof_func *)edges[j].b);
+                fprintf(__ss_prof_out, ": %.2f%%\n", edges[j].count * scale);
+            }
+    }
+
+    if(__ss_prof_out != stderr)
+        fclose(__ss_prof_out);
+    else
+        fflush(stderr);
+}
+
+void __ss_prof_start() {
+    atexit(__ss_prof_report);
+#ifndef WIN32
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = __ss_prof_handler;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+
+    struct itimerval it = {{0, __SS_PROF_INTERVAL}, {0, __SS_PROF_INTERVAL}};
+    setitimer(ITIMER_PROF, &it, NULL);
+#endif
+}
+
+#endif
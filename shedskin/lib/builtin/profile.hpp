@@ -0,0 +1,64 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef SS_PROFILE_HPP
+#define SS_PROFILE_HPP
+
+/* sampling profiler (--profile)
+
+   every generated function pushes a frame on a (per-thread) shadow stack, and updates the
+   current source line as it executes. a SIGPROF interval timer samples the top of this stack, so
+   that at exit a flat profile, the hottest lines and a call graph can be reported in terms of the
+   original python functions and line numbers. */
+
+#ifdef __SS_PROFILE
+
+struct __ss_prof_func {
+    const char *name;
+    const char *file;
+    int line;
+    unsigned long calls;
+    unsigned long self, total; /* samples */
+    unsigned long stamp; /* last sample counted in total, for recursive functions */
+    __ss_prof_func *next;
+    bool registered;
+
+    /* constant-initialized, so a function-local static needs no guard */
+    constexpr __ss_prof_func(const char *name, const char *file, int line) : name(name), file(file), line(line), calls(0), self(0), total(0), stamp(0), next(0), registered(false) {}
+};
+
+void __ss_prof_register(__ss_prof_func *f);
+
+struct __ss_prof_frame;
+extern __SS_THREAD_LOCAL __ss_prof_frame *__ss_prof_top;
+
+struct __ss_prof_frame {
+    __ss_prof_func *func;
+    int line;
+    __ss_prof_frame *parent;
+
+    inline __ss_prof_frame(__ss_prof_func *f) : func(f), line(f->line), parent(__ss_prof_top) {
+#ifdef __SS_THREADS
+        if(!__atomic_fetch_add(&f->calls, 1, __ATOMIC_RELAXED))
+#else
+        if(!f->calls++)
+#endif
+            __ss_prof_register(f);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+        __ss_prof_top = this;
+    }
+    inline ~__ss_prof_frame() {
+        __ss_prof_top = parent;
+    }
+};
+
+void __ss_prof_start();
+
+#define __SS_PROFILE_FUNC(name, file, line) \
+    static __ss_prof_func __ss_prof_info(name, file, line); \
+    __ss_prof_frame __ss_prof(&__ss_prof_info)
+
+#define __SS_PROFILE_LINE(n) (__ss_prof.line = (n))
+
+#endif
+
+#endif
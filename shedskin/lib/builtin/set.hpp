@@ -199,39 +199,31 @@ template<class T> template<class ... Args> set<T>::set(int, Args ... args)  {
 template<class T> __ss_bool set<T>::__eq__(pyobj *p) { /* XXX check hash */
     set<T> *b = (set<T> *)p;
 
-    // TODO why can't we just use unordered_map operator==
-    typename __GC_SET<T>::iterator it;
+    if(b->gcs.size() != gcs.size())
+        return False;
 
-    for (const auto& key : gcs)
-        if (b->gcs.find(key) == b->gcs.end())
+    for(typename __GC_SET<T>::iterator it = gcs.begin(); it != gcs.end(); ++it)
+        if(!b->gcs.contains(*it, it.hash()))
             return False;
 
     return True;
 }
 
 template <class T> void *set<T>::discard(T key) {
-    typename __GC_SET<T>::iterator it = gcs.find(key);
-    if(it != gcs.end())
-        gcs.erase(it);
+    gcs.erase(key);
     return NULL;
 }
 
 template <class T> void *set<T>::remove(T key) {
-    typename __GC_SET<T>::iterator it = gcs.find(key);
-    if(it == gcs.end())
+    if(!gcs.erase(key))
         throw new KeyError(repr(key));
-    else
-        gcs.erase(it);
     return NULL;
 }
 
 template<class T> T set<T>::pop() {
-    typename __GC_SET<T>::iterator it = gcs.begin();
-    if(it == gcs.end())
+    if(gcs.empty())
         throw new KeyError(new str("pop from an empty set"));
-    T t = *it;
-    gcs.erase(it);
-    return t;
+    return gcs.pop();
 }
 
 template<class T> __ss_bool set<T>::__ge__(set<T> *s) {
@@ -263,8 +255,8 @@ template<class T> long set<T>::__hash__() {
 
     hash_ *= __len__() + 1;
 
-    for (const auto& key : gcs) {
-        long h = hasher<T>(key);
+    for(typename __GC_SET<T>::iterator it = gcs.begin(); it != gcs.end(); ++it) {
+        long h = hasher<T>(*it);
         hash_ ^= (h ^ (h << 16) ^ 89869747L)  * 3644798167u;
     }
     hash_ = hash_ * 69069L + 907133923L;
@@ -317,7 +309,7 @@ template<class T> __ss_int set<T>::__len__() {
 }
 
 template <class T> __ss_bool set<T>::__contains__(T key) {
-    return __mbool(gcs.find(key) != gcs.end());
+    return __mbool(gcs.contains(key));
 }
 
 template <class T> void *set<T>::clear()
@@ -327,8 +319,9 @@ template <class T> void *set<T>::clear()
 }
 
 template<class T> void *set<T>::update(int, set<T> *s) {
-   for (const auto& key : s->gcs)
-       gcs.insert(key);
+    gcs.reserve(gcs.size() + s->gcs.size());
+    for(typename __GC_SET<T>::iterator it = s->gcs.begin(); it != s->gcs.end(); ++it)
+        gcs.insert(*it, it.hash());
     return NULL;
 }
 
@@ -394,17 +387,15 @@ template<class T> template<class U, class V, class W> set<T> *set<T>::__ss_union
 
 template<class T> set<T> *set<T>::symmetric_difference(set<T> *s) {
     set<T> *c = new set<T>(this->frozen);
+    typename __GC_SET<T>::iterator it;
 
-    // TODO optimize based on size difference?
-
-    for (const auto& key : gcs) {
-        if (!s->__contains__(key))
-            c->add(key);
-    }
-    for (const auto& key : s->gcs) {
-        if (!__contains__(key))
-            c->add(key);
-    }
+    c->gcs.reserve(gcs.size() + s->gcs.size());
+    for(it = gcs.begin(); it != gcs.end(); ++it)
+        if(!s->gcs.contains(*it, it.hash()))
+            c->gcs.insert(*it, it.hash());
+    for(it = s->gcs.begin(); it != s->gcs.end(); ++it)
+        if(!gcs.contains(*it, it.hash()))
+            c->gcs.insert(*it, it.hash());
 
     return c;
 }
@@ -427,12 +418,14 @@ template<class T> template <class U> set<T> *set<T>::intersection(int, U *iter)
 
 template<class T> set<T> *set<T>::intersection(int, set<T> *s) {
     set<T> *c = new set<T>(this->frozen);
+    set<T> *a = this, *b = s;
 
-    // TODO optimize based on size difference?
+    if(b->gcs.size() < a->gcs.size()) { a = s; b = this; } /* probe larger set */
 
-    for (const auto& key : gcs)
-        if (s->__contains__(key))
-            c->add(key);
+    c->gcs.reserve(a->gcs.size());
+    for(typename __GC_SET<T>::iterator it = a->gcs.begin(); it != a->gcs.end(); ++it)
+        if(b->gcs.contains(*it, it.hash()))
+            c->gcs.insert(*it, it.hash());
 
     return c;
 }
@@ -464,9 +457,10 @@ template<class T> template<class U, class V, class W> set<T>* set<T>::difference
 template <class T> set<T>* set<T>::difference(int, set<T> *other)
 {
     set<T>* result = new set<T>();
-    for (const auto& key : gcs)
-        if (!other->__contains__(key))
-            result->gcs.insert(key);
+    result->gcs.reserve(gcs.size());
+    for(typename __GC_SET<T>::iterator it = gcs.begin(); it != gcs.end(); ++it)
+        if(!other->gcs.contains(*it, it.hash()))
+            result->gcs.insert(*it, it.hash());
     return result;
 }
 
@@ -562,34 +556,21 @@ template<class T> set<T> *set<T>::copy() {
 
 template<class T> __ss_bool set<T>::issubset(set<T> *s) {
     if(__len__() > s->__len__()) { return False; }
-    typename set<T>::for_in_unit e;
-    typename set<T>::for_in_loop __3;
-    int __2;
-    set<T> *__1;
-    FOR_IN(e,this,1,2,3)
-        if(!s->__contains__(e))
+    for(typename __GC_SET<T>::iterator it = gcs.begin(); it != gcs.end(); ++it)
+        if(!s->gcs.contains(*it, it.hash()))
             return False;
-    END_FOR
     return True;
 }
 
 template<class T> __ss_bool set<T>::issuperset(set<T> *s) {
-    if(__len__() < s->__len__()) return False;
-    typename set<T>::for_in_unit e;
-    typename set<T>::for_in_loop __3;
-    int __2;
-    set<T> *__1;
-    FOR_IN(e,s,1,2,3)
-        if(!__contains__(e))
-            return False;
-    END_FOR
-    return True;
+    return s->issubset(this);
 }
 
 template<class T> __ss_bool set<T>::isdisjoint(set<T> *other) {
-    typename __GC_SET<T>::iterator it = gcs.begin();
-    while (it != gcs.end())
-        if (other->__contains__(*it++))
+    set<T> *a = this, *b = other;
+    if(b->gcs.size() < a->gcs.size()) { a = other; b = this; } /* probe larger set */
+    for(typename __GC_SET<T>::iterator it = a->gcs.begin(); it != a->gcs.end(); ++it)
+        if(b->gcs.contains(*it, it.hash()))
             return False;
     return True;
 }
@@ -627,6 +608,7 @@ template<class T> set<T> *set<T>::__deepcopy__(dict<void *, pyobj *> *memo) {
 }
 
 template<class T> __setiter<T>::__setiter(set<T> *s) {
+    p = s;
     it = s->gcs.begin();
 }
 
@@ -0,0 +1,162 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef SS_SORT_HPP
+#define SS_SORT_HPP
+
+/* stable natural merge sort (after CPython's listsort)
+
+   the array is split into maximal ascending (or strictly descending, which are reversed in-place)
+   runs, short runs are extended to a minimum length using binary insertion, and runs are merged
+   as they are pushed on a stack so that run lengths stay balanced. before merging two runs, the
+   elements already in place at either end are skipped using binary search, so (partially)
+   ordered input is sorted in close to linear time. */
+
+#define __SS_SORT_MAXRUNS 85
+
+template<class T, class L> class __timsort {
+    struct run { size_t base, len; };
+
+    T *a;
+    L lt;
+    __GC_VECTOR(T) tmp;
+    run runs[__SS_SORT_MAXRUNS];
+    int nruns;
+
+    static size_t minrun(size_t n) {
+        size_t r = 0;
+        while(n >= 64) {
+            r |= n & 1;
+            n >>= 1;
+        }
+        return n + r;
+    }
+
+    size_t count_run(size_t lo, size_t hi) {
+        size_t i = lo + 1;
+        if(i == hi)
+            return 1;
+        if(lt(a[i], a[lo])) {
+            for(i++; i < hi && lt(a[i], a[i-1]); i++);
+            std::reverse(a + lo, a + i);
+        } else
+            for(i++; i < hi && !lt(a[i], a[i-1]); i++);
+        return i - lo;
+    }
+
+    void binary_insertion(size_t lo, size_t hi, size_t start) {
+        for(; start < hi; start++) {
+            T pivot = a[start];
+            T *pos = std::upper_bound(a + lo, a + start, pivot, lt);
+            std::move_backward(pos, a + start, a + start + 1);
+            *pos = pivot;
+        }
+    }
+
+    void merge_lo(T *pa, size_t na, T *pb, size_t nb) {
+        tmp.assign(pa, pa + na);
+        T *t = tmp.data(), *tend = t + na, *bend = pb + nb, *dest = pa;
+        while(t < tend && pb < bend)
+            *dest++ = lt(*pb, *t) ? *pb++ : *t++;
+        std::copy(t, tend, dest);
+    }
+
+    void merge_hi(T *pa, size_t na, T *pb, size_t nb) {
+        tmp.assign(pb, pb + nb);
+        T *t = tmp.data() + nb, *tbegin = tmp.data(), *ia = pa + na, *dest = pb + nb;
+        while(t > tbegin && ia > pa)
+            *--dest = lt(*(t-1), *(ia-1)) ? *--ia : *--t;
+        std::copy_backward(tbegin, t, dest);
+    }
+
+    void merge_at(int i) {
+        T *pa = a + runs[i].base, *pb = a + runs[i+1].base;
+        size_t na = runs[i].len, nb = runs[i+1].len;
+
+        runs[i].len = na + nb;
+        if(i == nruns - 3)
+            runs[i+1] = runs[i+2];
+        nruns--;
+
+        /* elements of A not greater than B[0] are already in place */
+        T *start = std::upper_bound(pa, pa + na, *pb, lt);
+        na -= start - pa;
+        pa = start;
+        if(na == 0)
+            return;
+
+        /* as are elements of B not less than A[-1] */
+        nb = std::lower_bound(pb, pb + nb, pa[na-1], lt) - pb;
+        if(nb == 0)
+            return;
+
+        if(na <= nb)
+            merge_lo(pa, na, pb, nb);
+        else
+            merge_hi(pa, na, pb, nb);
+    }
+
+    void merge_collapse() {
+        while(nruns > 1) {
+            int n = nruns - 2;
+            if((n > 0 && runs[n-1].len <= runs[n].len + runs[n+1].len) ||
+               (n > 1 && runs[n-2].len <= runs[n-1].len + runs[n].len)) {
+                if(runs[n-1].len < runs[n+1].len)
+                    n--;
+            }
+            else if(runs[n].len > runs[n+1].len)
+                break;
+            merge_at(n);
+        }
+    }
+
+    void merge_force_collapse() {
+        while(nruns > 1) {
+            int n = nruns - 2;
+            if(n > 0 && runs[n-1].len < runs[n+1].len)
+                n--;
+            merge_at(n);
+        }
+    }
+
+public:
+    __timsort(T *a, L lt) : a(a), lt(lt), nruns(0) {}
+
+    void sort(size_t n) {
+        if(n < 2)
+            return;
+        size_t lo = 0, mr = minrun(n);
+        while(lo < n) {
+            size_t len = count_run(lo, n);
+            if(len < mr) {
+                size_t force = std::min(mr, n - lo);
+                binary_insertion(lo, lo + force, lo + len);
+                len = force;
+            }
+            runs[nruns].base = lo;
+            runs[nruns].len = len;
+            nruns++;
+            merge_collapse();
+            lo += len;
+        }
+        merge_force_collapse();
+    }
+};
+
+template<class T, class L> inline void __ss_sort(T *a, size_t n, L lt) {
+    __timsort<T, L>(a, lt).sort(n);
+}
+
+/* decorated entry, so a key function is called only once per element */
+
+template<class K, class T> struct __sortentry {
+    K key;
+    T value;
+};
+
+template<class K, class T, class L> struct __sortentry_less {
+    L lt;
+    __sortentry_less(L lt) : lt(lt) {}
+    inline bool operator()(const __sortentry<K, T> &a, const __sortentry<K, T> &b) const { return lt(a.key, b.key); }
+};
+
+#endif
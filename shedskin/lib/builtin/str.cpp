@@ -4,19 +4,19 @@
 
 /* str methods */
 
-str::str() : hash(-1), charcache(0) {
+str::str() : hash(-1), charcache(0), interned(0) {
     __class__ = cl_str_;
 }
 
-str::str(const char *s) : unit(s), hash(-1), charcache(0) {
+str::str(const char *s) : unit(s), hash(-1), charcache(0), interned(0) {
     __class__ = cl_str_;
 }
 
-str::str(__GC_STRING s) : unit(s), hash(-1), charcache(0) {
+str::str(__GC_STRING s) : unit(std::move(s)), hash(-1), charcache(0), interned(0) {
     __class__ = cl_str_;
 }
 
-str::str(const char *s, size_t size) : unit(s, size), hash(-1), charcache(0) { /* '\0' delimiter in C */
+str::str(const char *s, size_t size) : unit(s, size), hash(-1), charcache(0), interned(0) { /* '\0' delimiter in C */
     __class__ = cl_str_;
 }
 
@@ -24,6 +24,14 @@ str *str::__str__() {
     return this;
 }
 
+str *str::__substr(size_t pos, size_t n) {
+    if(n == 1)
+        return __char_cache[(unsigned char)unit[pos]];
+    if(pos == 0 && n == unit.size())
+        return this;
+    return new str(unit.data()+pos, n);
+}
+
 char *str::c_str() const {
     return (char *)this->unit.c_str();
 }
@@ -202,28 +210,32 @@ str *str::expandtabs(__ss_int tabsize) {
 }
 
 str *str::strip(str *chars) {
-    return lstrip(chars)->rstrip(chars);
+    const __GC_STRING &remove = chars ? chars->unit : ws;
+    size_t first = unit.find_first_not_of(remove);
+    if( first == std::string::npos )
+        return new str("");
+    size_t last = unit.find_last_not_of(remove);
+    return __substr(first, last+1-first);
 }
 
 str *str::lstrip(str *chars) {
-    __GC_STRING remove;
-    if(chars) remove = chars->unit;
-    else remove = ws;
+    const __GC_STRING &remove = chars ? chars->unit : ws;
     size_t first = unit.find_first_not_of(remove);
     if( first == std::string::npos )
         return new str("");
-    return new str(unit.substr(first, this->unit.size()-first));
+    return __substr(first, this->unit.size()-first);
 }
 
 tuple2<str *, str *> *str::partition(str *separator)
 {
     size_t i;
 
-    i = this->unit.find(separator->unit.c_str());
-    if(i != std::string::npos)
-        return new tuple2<str *, str *>(3, new str(unit.substr(0, i)), new str(separator->unit), new str(unit.substr(i + separator->unit.length())));
-    else
-        return new tuple2<str *, str *>(3, new str(unit), new str(""), new str(""));
+    i = this->unit.find(separator->unit);
+    if(i != std::string::npos) {
+        size_t j = i + separator->unit.size();
+        return new tuple2<str *, str *>(3, __substr(0, i), separator, __substr(j, unit.size()-j));
+    } else
+        return new tuple2<str *, str *>(3, this, new str(""), new str(""));
 }
 
 tuple2<str *, str *> *str::rpartition(str *separator)
@@ -231,10 +243,11 @@ tuple2<str *, str *> *str::rpartition(str *separator)
     size_t i;
 
     i = unit.rfind(separator->unit);
-    if(i != std::string::npos)
-        return new tuple2<str *, str *>(3, new str(unit.substr(0, i)), new str(separator->unit), new str(unit.substr(i + separator->unit.length())));
-    else
-        return new tuple2<str *, str *>(3, new str(unit), new str(""), new str(""));
+    if(i != std::string::npos) {
+        size_t j = i + separator->unit.size();
+        return new tuple2<str *, str *>(3, __substr(0, i), separator, __substr(j, unit.size()-j));
+    } else
+        return new tuple2<str *, str *>(3, new str(""), new str(""), this);
 }
 
 list<str *> *str::rsplit(str *separator, __ss_int maxsep) // TODO reimplement like ::split
@@ -257,13 +270,13 @@ list<str *> *str::rsplit(str *separator, __ss_int maxsep) // TODO reimplement li
 
             i = unit.find_last_of(ws, j);
 
-            r->append(new str(unit.substr(i + 1, j - i)));
+            r->append(__substr(i + 1, j - i));
             curi++;
         }
 
         //thus we only bother about extra stuff here if we *have* found more whitespace
         if(i != std::string::npos && j != std::string::npos && (j = unit.find_last_not_of(ws, i)) != std::string::npos)
-            r->append(new str(unit.substr(0, j)));
+            r->append(__substr(0, j));
     }
 
     //split by seperator
@@ -285,14 +298,14 @@ list<str *> *str::rsplit(str *separator, __ss_int maxsep) // TODO reimplement li
                 break;
             }
 
-            r->append(new str(unit.substr(i + tslen, j - i - tslen)));
+            r->append(__substr(i + tslen, j - i - tslen));
 
             curi++;
         }
 
         //either left over (beyond max) or very last match (see loop break)
         if(i != std::string::npos)
-            r->append(new str(unit.substr(0, i)));
+            r->append(__substr(0, i));
     }
 
     r->reverse();
@@ -358,23 +371,21 @@ list<str *> *str::splitlines(__ss_int keepends)
         if(unit[i] == '\r' && unit[i + 1] == '\n') endlen = 2;
         else endlen = 1;
 
-        r->append(new str(unit.substr(j, i - j + (keepends ? endlen : 0))));
+        r->append(__substr(j, i - j + (keepends ? endlen : 0)));
     }
     while(i != std::string::npos);
 
-    if(j != this->unit.size()) r->append(new str(unit.substr(j)));
+    if(j != this->unit.size()) r->append(__substr(j, unit.size() - j));
 
     return r;
 }
 
 str *str::rstrip(str *chars) {
-    __GC_STRING remove;
-    if(chars) remove = chars->unit;
-    else remove = ws;
+    const __GC_STRING &remove = chars ? chars->unit : ws;
     size_t last = unit.find_last_not_of(remove);
     if( last == std::string::npos )
         return new str("");
-    return new str(unit.substr(0,last+1));
+    return __substr(0, last+1);
 }
 
 list<str *> *str::split(str *sep_, __ss_int maxsplit) {
@@ -395,11 +406,11 @@ list<str *> *str::split(str *sep_, __ss_int maxsplit) {
             pos_end = unit.find(sep_->unit, pos_start);
 
         if(pos_end == std::string::npos || ((maxsplit != -1) && splits >= maxsplit)) {
-            result->append(new str(unit.substr(pos_start, unit.size()-pos_start)));
+            result->append(__substr(pos_start, unit.size()-pos_start));
             break;
         }
 
-        result->append(new str(unit.substr(pos_start, pos_end-pos_start)));
+        result->append(__substr(pos_start, pos_end-pos_start));
         splits += 1;
 
         if(sep_ == NULL) {
@@ -409,7 +420,7 @@ list<str *> *str::split(str *sep_, __ss_int maxsplit) {
         } else {
             pos_start = pos_end + sep_->unit.size();
             if(pos_start == unit.size()) {
-                result->append(new str(unit.substr(pos_start, unit.size()-pos_start)));
+                result->append(__substr(pos_start, unit.size()-pos_start));
                 break;
             }
         }
@@ -468,6 +479,10 @@ __ss_int str::__cmp__(pyobj *p) {
 
 __ss_bool str::__eq__(pyobj *p) {
     str *q = (str *)p;
+    if(this == q)
+        return True;
+    if(interned and q->interned)
+        return False;
     size_t len = this->unit.size();
     if(len != q->unit.size() or (hash != -1 and q->hash != -1 and hash != q->hash))
         return False;
@@ -505,6 +520,28 @@ long str::__hash__() {
     return hash; 
 }
 
+/* return the canonical instance for this value, registering s if there is none yet */
+str *__intern(str *s) {
+    if(s->interned)
+        return s;
+    if(s->unit.size() == 1)
+        return __char_cache[(unsigned char)s->unit[0]];
+#ifdef __SS_THREADS
+    std::lock_guard<std::mutex> guard(__intern_lock);
+#endif
+    __GC_SET<str *> &t = __intern_table->gcs;
+    __GC_SET<str *>::iterator it = t.find(s);
+    if(it != t.end())
+        return *it;
+#ifdef __SS_ARENA
+    __ss_arena_keep keep; /* the table outlives gc.arena_reset */
+    s = new str(s->unit);
+#endif
+    s->interned = 1;
+    t.insert(s);
+    return s;
+}
+
 str *str::__add__(str *b) {
     str *s = new str();
 
@@ -522,7 +559,7 @@ str *str::__slice__(__ss_int x, __ss_int l, __ss_int u, __ss_int s) {
     size_t len = this->unit.size();
     slicenr(x, l, u, s, (__ss_int)len);
     if(s == 1)
-        return new str(unit.data()+l, (size_t)(u-l));
+        return __substr((size_t)l, (size_t)(u-l));
     else {
         __GC_STRING r;
         if(!(x&1) && !(x&2) && s==-1) {
@@ -549,13 +586,13 @@ __ss_int str::find(str *s, __ss_int a) {
     __ss_int step = 1;
     __ss_int b = this->__len__();
     slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, this->unit.size()-(size_t)a).find(s->unit), a);
+    return __fixstart(std::string_view(unit).substr((size_t)a).find(s->unit), a);
 }
 
 __ss_int str::find(str *s, __ss_int a, __ss_int b) {
     __ss_int step = 1;
     slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, (size_t)(b-a)).find(s->unit), a);
+    return __fixstart(std::string_view(unit).substr((size_t)a, (size_t)(b-a)).find(s->unit), a);
 
 }
 
@@ -563,13 +600,13 @@ __ss_int str::rfind(str *s, __ss_int a) {
     __ss_int step = 1;
     __ss_int b = this->__len__();
     slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, this->unit.size()-(size_t)a).rfind(s->unit), a);
+    return __fixstart(std::string_view(unit).substr((size_t)a).rfind(s->unit), a);
 }
 
 __ss_int str::rfind(str *s, __ss_int a, __ss_int b) {
     __ss_int step = 1;
     slicenr(3, a, b, step, this->__len__());
-    return __fixstart(unit.substr((size_t)a, (size_t)(b-a)).rfind(s->unit), a);
+    return __fixstart(std::string_view(unit).substr((size_t)a, (size_t)(b-a)).rfind(s->unit), a);
 }
 
 __ss_int str::__checkneg(__ss_int i) {
@@ -592,7 +629,7 @@ __ss_int str::count(str *s, __ss_int start, __ss_int end) {
 
     i = (size_t)start;
     count = 0;
-    while( ((i = this->unit.find(s->c_str(), i)) != std::string::npos) && (i <= (size_t)end-s->unit.size()) )
+    while( ((i = this->unit.find(s->unit, i)) != std::string::npos) && (i <= (size_t)end-s->unit.size()) )
     {
         i += s->unit.size();
         count++;
@@ -645,7 +682,7 @@ str *str::upper() {
     if(this->unit.size() == 1)
         return __char_cache[((unsigned char)(::toupper(unit[0])))];
 
-    str *toReturn = new str(*this);
+    str *toReturn = new str(unit);
     std::transform(toReturn->unit.begin(), toReturn->unit.end(), toReturn->unit.begin(), toupper);
 
     return toReturn;
@@ -655,7 +692,7 @@ str *str::lower() {
     if(this->unit.size() == 1)
         return __char_cache[((unsigned char)(::tolower(unit[0])))];
 
-    str *toReturn = new str(*this);
+    str *toReturn = new str(unit);
     std::transform(toReturn->unit.begin(), toReturn->unit.end(), toReturn->unit.begin(), tolower);
 
     return toReturn;
@@ -707,7 +744,7 @@ str *str::capitalize() {
 }
 
 #ifdef __SS_BIND
-str::str(PyObject *p) : hash(-1) {
+str::str(PyObject *p) : hash(-1), charcache(0), interned(0) {
     // if(!PyBytes_Check(p))
     if(!PyUnicode_Check(p))
     // if(!PyString_Check(p))
@@ -732,7 +769,21 @@ PyObject *str::__to_py__() {
 #endif
 
 #ifdef __SS_LONG
+#ifdef __SS_BIGINT
+static str *__str_small(long long i, int base);
+
 str *__str(__ss_int i, __ss_int base) {
+    if(!i.small()) {
+        std::string s = (i < 0 ? "-" : "") + __bi_digits(i, base);
+        return new str(s.data(), s.size());
+    }
+    return __str_small(i.value(), base);
+}
+
+static str *__str_small(long long i, int base) {
+#else
+str *__str(__ss_int i, __ss_int base) {
+#endif
     if(i<10 && i>=0 && base==10)
         return __char_cache[((unsigned char)('0'+i))];
     char buf[70];
@@ -743,7 +794,7 @@ str *__str(__ss_int i, __ss_int base) {
     *psz = 0;
     if(neg) i = -i;
     if(base == 10) {
-        __ss_int pos;
+        int pos;
         while(i > 999) {
             pos = 4*(i%1000);
             i = i/1000;
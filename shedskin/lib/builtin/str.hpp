@@ -9,6 +9,9 @@ public:
     __GC_STRING unit;
     long hash;
     bool charcache;
+    bool interned; /* canonical instance (intern table or char cache), so equal means identical */
+
+    __SS_GC_TYPED(str, member(&str::unit).member(&str::hash).member(&str::charcache).member(&str::interned))
 
     str();
     str(const char *s);
@@ -51,6 +54,7 @@ public:
     tuple2<str *, str *> *partition(str *sep);
     list<str *> *splitlines(__ss_int keepends = 0);
 
+    str *__substr(size_t pos, size_t n); /* one copy at most: reuses this or the char cache */
     __ss_int __fixstart(size_t a, __ss_int b);
     __ss_int __checkneg(__ss_int i);
 
@@ -152,6 +156,10 @@ template <class U> str *str::join(U *iter) {
     typename U::for_in_unit e;
     typename U::for_in_loop __3;
     U *__1;
+#ifdef __SS_THREADS
+    if(!__join_cache)
+        __join_cache = new (NoGC) list<str *>();
+#endif
     __join_cache->units.resize(0);
     total = 0;
     FOR_IN(e,iter,1,2,3)
@@ -8,6 +8,8 @@ public:
     A first;
     B second;
 
+    __SS_GC_TYPED(tuple2, member(&tuple2::first).member(&tuple2::second))
+
     tuple2();
     tuple2(int n, A a, B b);
     void __init2__(A a, B b);
@@ -4,7 +4,6 @@
 #define __COLLECTIONS_HPP
 
 #include "builtin.hpp"
-#include <deque>
 
 using namespace __shedskin__;
 
@@ -16,72 +15,181 @@ template <class T> class __dequeiter;
 extern class_ *cl_deque;
 template <class A> class deque : public pyiter<A> {
 public:
-    std::deque<A, gc_allocator<A> > units;
-    typename std::deque<A, gc_allocator<A> >::iterator iter;
+    /* ring buffer: the capacity is zero or a power of two, and element i
+       lives at units[(head+i) & mask] */
+    __GC_VECTOR(A) units;
+    size_t head, count, mask;
+    size_t maxlen; /* (SIZE_MAX: unbounded) */
 
-    /* XXX modulo rotate, specialized reversed, copy, deepcopy */
+    /* XXX specialized copy, deepcopy */
 
     deque(pyiter<A> *iterable=0) {
+        __init_deque(SIZE_MAX, iterable);
+    }
+
+    deque(pyiter<A> *iterable, void *) {
+        __init_deque(SIZE_MAX, iterable);
+    }
+
+    deque(pyiter<A> *iterable, __ss_int maxlen_) {
+        if(maxlen_ < 0)
+            throw new ValueError(new str("maxlen must be non-negative"));
+        __init_deque((size_t)maxlen_, iterable);
+    }
+
+    deque(void *, void *) {
+        __init_deque(SIZE_MAX, 0);
+    }
+
+    deque(void *, __ss_int maxlen_) {
+        if(maxlen_ < 0)
+            throw new ValueError(new str("maxlen must be non-negative"));
+        __init_deque((size_t)maxlen_, 0);
+    }
+
+    void __init_deque(size_t maxlen_, pyiter<A> *iterable) {
         this->__class__ = cl_deque;
-        if(iterable)
-            extend(iterable);
+        head = count = mask = 0;
+        maxlen = maxlen_;
+        if(iterable) {
+            if(iterable->__class__ == cl_list)
+                extend(static_cast<list<A> *>(iterable));
+            else if(iterable->__class__ == cl_deque)
+                extend(static_cast<deque<A> *>(iterable));
+            else
+                extend(iterable);
+        }
+    }
+
+    inline A &__at(size_t i) {
+        return units[(head+i) & mask];
+    }
+
+    void __reserve(size_t n) {
+        if(n <= units.size())
+            return;
+        size_t cap = units.empty() ? 8 : units.size();
+        while(cap < n)
+            cap <<= 1;
+        __GC_VECTOR(A) fresh(cap);
+        if(count) {
+            size_t first = std::min(count, units.size()-head);
+            memcpy(&fresh[0], &units[head], sizeof(A)*first);
+            memcpy(&fresh[first], &units[0], sizeof(A)*(count-first));
+        }
+        units.swap(fresh);
+        head = 0;
+        mask = cap-1;
+    }
+
+    /* (evicted slots are cleared, so the GC can reclaim their elements) */
+    void __drop_left(size_t k) {
+        for(size_t i=0; i<k; i++) {
+            units[head] = A();
+            head = (head+1) & mask;
+        }
+        count -= k;
+    }
+
+    void __drop_right(size_t k) {
+        for(size_t i=0; i<k; i++)
+            units[(head+count-1-i) & mask] = A();
+        count -= k;
     }
 
     void *append(A a) {
-        units.push_back(a);
+        if(count == maxlen) {
+            if(!count)
+                return NULL;
+            __drop_left(1);
+        }
+        if(count == units.size())
+            __reserve(count+1);
+        units[(head+count) & mask] = a;
+        count++;
         return NULL;
     }
 
     void *appendleft(A a) {
-        units.push_front(a);
+        if(count == maxlen) {
+            if(!count)
+                return NULL;
+            __drop_right(1);
+        }
+        if(count == units.size())
+            __reserve(count+1);
+        head = (head-1) & mask;
+        units[head] = a;
+        count++;
         return NULL;
     }
 
     A pop() {
-        if(units.empty())
+        if(!count)
             throw new IndexError(new str("pop from an empty deque"));
-        A x = units.back();
-        units.pop_back();
+        A x = __at(count-1);
+        __drop_right(1);
         return x;
     }
 
     A popleft() {
-        if(units.empty())
+        if(!count)
             throw new IndexError(new str("pop from an empty deque"));
-        A x = units.front();
-        units.pop_front();
+        A x = units[head];
+        __drop_left(1);
         return x;
     }
 
     A __getitem__(__ss_int i) {
         i = __wrap(this, i);
-        return units[i];
+        return __at((size_t)i);
     }
 
     void *__setitem__(__ss_int i, A value) {
         i = __wrap(this, i);
-        units[i] = value;
+        __at((size_t)i) = value;
         return NULL;
     }
 
     void *__delitem__(__ss_int i) {
         i = __wrap(this, i);
-        units.erase(units.begin()+i);
+        __erase((size_t)i);
         return NULL;
     }
 
-    __ss_bool __contains__(A value) {
-        iter = units.begin();
-        while(iter != units.end()) {
-            if(__eq(*iter, value))
-                return True;
-            iter++;
+    /* shift whichever side of the hole is shorter */
+    void __erase(size_t k) {
+        if(k < count/2) {
+            for(size_t j=k; j>0; j--)
+                __at(j) = __at(j-1);
+            __drop_left(1);
+        } else {
+            for(size_t j=k; j+1<count; j++)
+                __at(j) = __at(j+1);
+            __drop_right(1);
         }
-        return False;
+    }
+
+    /* scan the (at most two) contiguous runs of the buffer */
+    size_t __find(A value) {
+        size_t first = std::min(count, units.size()-head);
+        A *p = units.data()+head;
+        for(size_t i=0; i<first; i++)
+            if(__eq(p[i], value))
+                return i;
+        p = units.data();
+        for(size_t i=first; i<count; i++)
+            if(__eq(p[i-first], value))
+                return i;
+        return count;
+    }
+
+    __ss_bool __contains__(A value) {
+        return __mbool(__find(value) != count);
     }
 
     __ss_int __len__() {
-        return (__ss_int)units.size();
+        return (__ss_int)count;
     }
 
     __iter<A> *__iter__() {
@@ -90,15 +198,66 @@ public:
 
     str * __repr__() {
         str *r = new str("deque([");
-        for(__ss_int i = 0; i<this->__len__();i++) {
-            r->unit += repr(units[i])->unit;
-            if (i<this->__len__()-1)
+        for(size_t i=0; i<count; i++) {
+            r->unit += repr(__at(i))->unit;
+            if (i+1<count)
                 r->unit += ", ";
         }
-        r->unit += "])";
+        r->unit += "]";
+        if(maxlen != SIZE_MAX)
+            r->unit += ", maxlen=" + std::to_string(maxlen);
+        r->unit += ")";
         return r;
     }
 
+    /* copy a contiguous run in with (at most) two memcpy calls */
+    void __extend_items(const A *src, size_t n) {
+        if(n >= maxlen) {
+            src += n-maxlen;
+            n = maxlen;
+            __drop_left(count);
+        } else if(count+n > maxlen)
+            __drop_left(count+n-maxlen);
+        if(!n)
+            return;
+        __reserve(count+n);
+        size_t start = (head+count) & mask;
+        size_t first = std::min(n, units.size()-start);
+        memcpy(&units[start], src, sizeof(A)*first);
+        memcpy(&units[0], src+first, sizeof(A)*(n-first));
+        count += n;
+    }
+
+    void __extendleft_items(const A *src, size_t n) {
+        if(n >= maxlen) {
+            src += n-maxlen;
+            n = maxlen;
+            __drop_right(count);
+        } else if(count+n > maxlen)
+            __drop_right(count+n-maxlen);
+        if(!n)
+            return;
+        __reserve(count+n);
+        for(size_t i=0; i<n; i++) {
+            head = (head-1) & mask;
+            units[head] = src[i];
+        }
+        count += n;
+    }
+
+    void *extend(list<A> *l) {
+        __extend_items(l->units.data(), l->units.size());
+        return NULL;
+    }
+
+    void *extend(deque<A> *d) {
+        __GC_VECTOR(A) items(d->count);
+        for(size_t i=0; i<d->count; i++)
+            items[i] = d->__at(i);
+        __extend_items(items.data(), items.size());
+        return NULL;
+    }
+
     template<class U> void *extend(U *iter_) {
         typename U::for_in_unit e;
         typename U::for_in_loop __3;
@@ -110,6 +269,19 @@ public:
         return NULL;
     }
 
+    void *extendleft(list<A> *l) {
+        __extendleft_items(l->units.data(), l->units.size());
+        return NULL;
+    }
+
+    void *extendleft(deque<A> *d) {
+        __GC_VECTOR(A) items(d->count);
+        for(size_t i=0; i<d->count; i++)
+            items[i] = d->__at(i);
+        __extendleft_items(items.data(), items.size());
+        return NULL;
+    }
+
     template<class U> void *extendleft(U *iter_) {
         typename U::for_in_unit e;
         typename U::for_in_loop __3;
@@ -122,54 +294,83 @@ public:
     }
 
    void *remove(A value) {
-       iter = units.begin();
-       while(iter != units.end()) {
-           if(__eq(*iter, value)) {
-               units.erase(iter);
-               return NULL;
-           }
-           iter++;
-       }
-       throw new ValueError(new str("hops"));
+       size_t i = __find(value);
+       if(i == count)
+           throw new ValueError(new str("deque.remove(x): x not in deque"));
+       __erase(i);
        return NULL;
    }
 
+   /* a full buffer only moves its head; otherwise the shorter side moves */
    void *rotate(__ss_int n) {
-       if(!units.empty()) {
-           n = n % __len__();
-           if(n<0)
-               for(__ss_int i=0; i>n; i--)
-                   append(popleft());
-           else
-               for(__ss_int i=0; i<n; i++)
-                   appendleft(pop());
-       }
+       if(count < 2)
+           return NULL;
+       __ss_int len = (__ss_int)count;
+       n = n % len;
+       if(n < 0)
+           n += len;
+       size_t k = (size_t)n;
+       if(count == units.size())
+           head = (head-k) & mask;
+       else if(k <= count/2)
+           for(size_t i=0; i<k; i++) {
+               head = (head-1) & mask;
+               units[head] = units[(head+count) & mask];
+           }
+       else
+           for(size_t i=k; i<count; i++) {
+               units[(head+count) & mask] = units[head];
+               head = (head+1) & mask;
+           }
        return NULL;
    }
 
    void *clear() {
-       units.clear();
+       __GC_VECTOR(A)().swap(units);
+       head = count = mask = 0;
        return NULL;
    }
 
    __ss_int truth() {
-       return !units.empty();
+       return count != 0;
    }
 
    deque<A> *__copy__() {
        deque<A> *c = new deque<A>();
        c->units = this->units;
+       c->head = this->head;
+       c->count = this->count;
+       c->mask = this->mask;
+       c->maxlen = this->maxlen;
        return c;
    }
 
    deque<A> *__deepcopy__(dict<void *, pyobj *> *memo) {
        deque<A> *c = new deque<A>();
+       c->maxlen = this->maxlen;
        memo->__setitem__(this, c);
-       for(__ss_int i=0; i<this->__len__(); i++)
-           c->units.push_back(__deepcopy(this->units[i], memo));
+       for(size_t i=0; i<count; i++)
+           c->append(__deepcopy(__at(i), memo));
        return c;
    }
 
+    /* iteration */
+
+    typedef A for_in_unit;
+    typedef size_t for_in_loop;
+
+    inline size_t for_in_init() {
+        return 0;
+    }
+
+    inline bool for_in_has_next(size_t i) {
+        return i < count;
+    }
+
+    inline A for_in_next(size_t &i) {
+        return units[(head+i++) & mask];
+    }
+
 };
 
 template <class T> class __dequeiter : public __iter<T> {
@@ -179,30 +380,30 @@ public:
 
     __dequeiter(deque<T> *d) {
         p = d;
-        size = p->units.size();
+        size = p->count;
         i = 0;
     }
 
     T __next__() {
-        if(i == size)
+        if(i == size || i >= p->count)
             throw new StopIteration();
-        return p->units[i++];
+        return p->__at(i++);
     }
 };
 
 template <class T> class __dequereviter : public __iter<T> {
 public:
     deque<T> *p;
-    __ss_int i;
+    size_t i;
 
     __dequereviter(deque<T> *p_) {
         p = p_;
-        i = p_->units.size()-1;
+        i = p_->count;
     }
 
     T __next__() {
-        if(i >= 0)
-            return p->units[i--];
+        if(i > 0 && i <= p->count)
+            return p->__at(--i);
         throw new StopIteration();
     }
 };
@@ -1,7 +1,7 @@
 # Copyright 2005-2011 Mark Dufour and contributors; License Expat (See LICENSE)
 
 class deque(pyiter):
-    def __init__(self, iterable=None):
+    def __init__(self, iterable=None, maxlen=None):
         self.unit = iterable.unit
 
     def append(self, x):
@@ -2,6 +2,10 @@
 
 #include "csv.hpp"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace __csv__ {
 
 tuple2<str *, str *> *const_3;
@@ -124,177 +128,256 @@ class reader
 
 class_ *cl_reader;
 
-void *reader::parse_process_char(str *c) {
-    __ss_int __11, __13, __7, __9;
+/* the reader scans runs of plain field characters blockwise, using the lines as they lie in the
+   file buffer, and allocates each field once from its run. only fields containing escapes or
+   doubled quotes, or spanning lines, are first collected in 'field' */
 
-    if (this->state == START_RECORD) {
-        if (__eq(c, const_7)) {
-            return NULL;
-        }
-        else if ((const_8)->__contains__(c)) {
-            this->state = EAT_CRNL;
-            return NULL;
-        }
-        this->state = START_FIELD;
+void __csv_stops::init(int a, int b, int c, int d) {
+    int stops[5] = {a, b, c, d, '\0'};
+    memset(table, 0, sizeof(table));
+    for(int i = 0; i < 5; i++) {
+        if(stops[i] < 0)
+            stops[i] = '\0';
+        needle[i] = (char)stops[i];
+        table[(unsigned char)stops[i]] = true;
     }
-    if (this->state == START_FIELD) {
-        if ((const_9)->__contains__(c)) {
-            this->parse_save_field();
-            if (__eq(c, const_7)) {
-                this->state = START_RECORD;
-            }
-            else {
+}
+
+static inline const char *__csv_scan(const char *p, const char *end, const __csv_stops &s) {
+#ifdef __SSE2__
+    const __m128i n0 = _mm_set1_epi8(s.needle[0]), n1 = _mm_set1_epi8(s.needle[1]), n2 = _mm_set1_epi8(s.needle[2]), n3 = _mm_set1_epi8(s.needle[3]), n4 = _mm_set1_epi8(s.needle[4]);
+    for(; end - p >= 16; p += 16) {
+        __m128i b = _mm_loadu_si128((const __m128i *)p);
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(b, n0), _mm_cmpeq_epi8(b, n1)),
+                                 _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(b, n2), _mm_cmpeq_epi8(b, n3)), _mm_cmpeq_epi8(b, n4)));
+        int mask = _mm_movemask_epi8(m);
+        if(mask)
+            return p + __builtin_ctz(mask);
+    }
+#endif
+    while(p < end and !s.table[(unsigned char)*p])
+        p++;
+    return p;
+}
+
+static inline int __csv_char(str *s) {
+    return (s and s->unit.size() == 1) ? (unsigned char)s->unit[0] : -1;
+}
+
+static inline void __csv_check_limit(size_t size) {
+    if(size > (size_t)_field_limit)
+        throw ((new Error(__mod6(const_17, 1, _field_limit))));
+}
+
+void reader::parse_add(const char *run, const char *p) {
+    field.append(run, p);
+    __csv_check_limit(field.size());
+}
+
+void reader::parse_save_field(const char *run, const char *p) {
+    str *s;
+    if(field.empty()) {
+        size_t size = (size_t)(p - run);
+        __csv_check_limit(size);
+        if(size == 0)
+            s = const_16;
+        else if(size == 1)
+            s = __char_cache[(unsigned char)*run];
+        else
+            s = new str(run, size);
+    } else {
+        parse_add(run, p);
+        s = new str(field.data(), field.size());
+        field.clear();
+    }
+    this->fields->append(s);
+}
+
+/* feed one line to the state machine; its end acts as the '\0' that ends each line in CPython */
+void reader::parse_line(const char *p, const char *end) {
+    const char *run = p; /* start of the current run of plain characters */
+    unsigned char c;
+
+    while(p < end) {
+        switch((int)this->state) {
+        case 0: /* START_RECORD */
+            c = *p;
+            if(c == '\n' or c == '\r') {
                 this->state = EAT_CRNL;
+                p++;
+                break;
             }
-        }
-        else if (__AND(__eq(c, dialect->quotechar), (dialect->quoting!=QUOTE_NONE), 7)) {
-            this->state = IN_QUOTED_FIELD;
-        }
-        else if (__eq(c, dialect->escapechar)) {
-            this->state = ESCAPED_CHAR;
-        }
-        else if (__AND(__eq(c, const_10), dialect->skipinitialspace, 9)) {
-        }
-        else if (__eq(c, dialect->delimiter)) {
-            this->parse_save_field();
-        }
-        else {
-            if (dialect->quoting == QUOTE_NONNUMERIC) {
-                this->numeric_field = 1;
-            }
-            this->parse_add_char(c);
-            this->state = IN_FIELD;
-        }
-    }
-    else if (this->state == ESCAPED_CHAR) {
-        if (__eq(c, const_7)) {
-            c = const_11;
-        }
-        this->parse_add_char(c);
-        this->state = IN_FIELD;
-    }
-    else if (this->state == IN_FIELD) {
-        if ((const_12)->__contains__(c)) {
-            this->parse_save_field();
-            if (__eq(c, const_7)) {
-                this->state = START_RECORD;
+            this->state = START_FIELD;
+            /* fall through */
+
+        case 1: /* START_FIELD */
+            c = *p;
+            if(c == '\0')
+                throw ((new Error(const_15)));
+            p++;
+            if(c == '\n' or c == '\r') {
+                this->parse_save_field(p, p);
+                this->state = EAT_CRNL;
+            } else if(c == quotechar) {
+                this->state = IN_QUOTED_FIELD;
+                run = p;
+            } else if(c == escapechar) {
+                this->state = ESCAPED_CHAR;
+            } else if(c == ' ' and dialect->skipinitialspace) {
+            } else if(c == delimiter) {
+                this->parse_save_field(p, p);
+            } else {
+                this->state = IN_FIELD;
+                run = p - 1;
             }
-            else {
+            break;
+
+        case 2: /* ESCAPED_CHAR */
+        case 5: /* ESCAPE_IN_QUOTED_FIELD */
+            c = *p;
+            if(c == '\0')
+                throw ((new Error(const_15)));
+            run = p++;
+            this->state = (this->state == ESCAPED_CHAR) ? IN_FIELD : IN_QUOTED_FIELD;
+            break;
+
+        case 3: /* IN_FIELD */
+            p = __csv_scan(p, end, field_stops);
+            if(p == end)
+                break;
+            c = *p;
+            if(c == '\0')
+                throw ((new Error(const_15)));
+            if(c == '\n' or c == '\r') {
+                this->parse_save_field(run, p);
                 this->state = EAT_CRNL;
+            } else if(c == escapechar) {
+                this->parse_add(run, p);
+                this->state = ESCAPED_CHAR;
+            } else { /* delimiter */
+                this->parse_save_field(run, p);
+                this->state = START_FIELD;
             }
-        }
-        else if (__eq(c, dialect->escapechar)) {
-            this->state = ESCAPED_CHAR;
-        }
-        else if (__eq(c, dialect->delimiter)) {
-            this->parse_save_field();
-            this->state = START_FIELD;
-        }
-        else {
-            this->parse_add_char(c);
-        }
-    }
-    else if (this->state == IN_QUOTED_FIELD) {
-        if (__eq(c, const_7)) {
-        }
-        else if (__eq(c, dialect->escapechar)) {
-            this->state = ESCAPE_IN_QUOTED_FIELD;
-        }
-        else if (__AND(__eq(c, dialect->quotechar), (dialect->quoting!=QUOTE_NONE), 11)) {
-            if (dialect->doublequote) {
+            p++;
+            break;
+
+        case 4: /* IN_QUOTED_FIELD */
+            p = __csv_scan(p, end, quoted_stops);
+            if(p == end)
+                break;
+            c = *p;
+            if(c == '\0')
+                throw ((new Error(const_15)));
+            if(c == escapechar) {
+                this->parse_add(run, p);
+                this->state = ESCAPE_IN_QUOTED_FIELD;
+            } else if(dialect->doublequote) { /* quotechar */
                 this->state = QUOTE_IN_QUOTED_FIELD;
-            }
-            else {
+            } else {
+                this->parse_add(run, p);
+                run = p + 1;
                 this->state = IN_FIELD;
             }
-        }
-        else {
-            this->parse_add_char(c);
-        }
-    }
-    else if (this->state == ESCAPE_IN_QUOTED_FIELD) {
-        if (__eq(c, const_7)) {
-            c = const_11;
-        }
-        this->parse_add_char(c);
-        this->state = IN_QUOTED_FIELD;
-    }
-    else if (this->state == QUOTE_IN_QUOTED_FIELD) {
-        if (__AND((dialect->quoting!=QUOTE_NONE), __eq(c, dialect->quotechar), 13)) {
-            this->parse_add_char(c);
-            this->state = IN_QUOTED_FIELD;
-        }
-        else if (__eq(c, dialect->delimiter)) {
-            this->parse_save_field();
-            this->state = START_FIELD;
-        }
-        else if ((const_12)->__contains__(c)) {
-            this->parse_save_field();
-            if (__eq(c, const_7)) {
-                this->state = START_RECORD;
-            }
-            else {
+            p++;
+            break;
+
+        case 6: /* QUOTE_IN_QUOTED_FIELD: the quote is at p-1 */
+            c = *p;
+            if(c == '\0')
+                throw ((new Error(const_15)));
+            if(c == quotechar) {
+                this->parse_add(run, p);
+                run = p + 1;
+                this->state = IN_QUOTED_FIELD;
+            } else if(c == delimiter) {
+                this->parse_save_field(run, p - 1);
+                this->state = START_FIELD;
+            } else if(c == '\n' or c == '\r') {
+                this->parse_save_field(run, p - 1);
                 this->state = EAT_CRNL;
+            } else if(!dialect->strict) {
+                this->parse_add(run, p - 1);
+                run = p;
+                this->state = IN_FIELD;
+            } else {
+                throw ((new Error(__mod6(const_13, 2, dialect->delimiter, dialect->quotechar))));
             }
-        }
-        else if ((!dialect->strict)) {
-            this->parse_add_char(c);
-            this->state = IN_FIELD;
-        }
-        else {
-            throw ((new Error(__mod6(const_13, 2, dialect->delimiter, dialect->quotechar))));
-        }
-    }
-    else if (this->state==EAT_CRNL) {
-        if ((const_8)->__contains__(c)) {
-        }
-        else if (__eq(c, const_7)) {
-            this->state = START_RECORD;
-        }
-        else {
-            throw ((new Error(const_14)));
+            p++;
+            break;
+
+        default: /* EAT_CRNL */
+            c = *p;
+            if(c == '\0')
+                throw ((new Error(const_15)));
+            if(c != '\n' and c != '\r')
+                throw ((new Error(const_14)));
+            p++;
         }
     }
-    return 0;
-}
 
-void *reader::parse_reset() {
-    
-    this->fields = (new list<str *>());
-    this->field = (new list<str *>());
-    this->state = START_RECORD;
-    this->numeric_field = 0;
-    return NULL;
+    switch((int)this->state) {
+    case 1: /* START_FIELD */
+        this->parse_save_field(end, end);
+        this->state = START_RECORD;
+        break;
+    case 2: /* ESCAPED_CHAR */
+        this->field.push_back('\n');
+        this->state = IN_FIELD;
+        break;
+    case 3: /* IN_FIELD */
+        this->parse_save_field(run, end);
+        this->state = START_RECORD;
+        break;
+    case 4: /* IN_QUOTED_FIELD */
+        this->parse_add(run, end);
+        break;
+    case 5: /* ESCAPE_IN_QUOTED_FIELD */
+        this->field.push_back('\n');
+        this->state = IN_QUOTED_FIELD;
+        break;
+    case 6: /* QUOTE_IN_QUOTED_FIELD */
+        this->parse_save_field(run, end - 1);
+        this->state = START_RECORD;
+        break;
+    case 7: /* EAT_CRNL */
+        this->state = START_RECORD;
+    }
 }
 
-list<str *> *reader::__next__() {
-    list<str *> *fields_;
-    str *line;
+/* read lines until a record is complete. false at the end of the input */
+bool reader::parse_record() {
+    const char *data;
+    size_t size;
+    size_t width = this->fields ? this->fields->units.size() : 0;
 
-    this->parse_reset();
+    this->fields = new list<str *>();
+    this->fields->units.reserve(width);
+    this->field.clear();
+    this->state = START_RECORD;
 
     while (1) {
-        line = (this->input_iter)->__next__();
+        if(!this->input_iter->__next_line(data, size))
+            return false;
         this->line_num = (this->line_num+1);
-        str *c;
-        str::for_in_loop __3;
-        int __2;
-        str *__1;
-        FOR_IN(c,line,1,2,3)
-            if (__eq(c, const_7)) {
-                throw ((new Error(const_15)));
-            }
-            this->parse_process_char(c);
-        END_FOR
-
-        this->parse_process_char(const_7);
-        if (this->state == START_RECORD) {
-            break;
-        }
+        this->parse_line(data, data + size);
+        if (this->state == START_RECORD)
+            return true;
     }
-    fields_ = this->fields;
-    this->fields = (new list<str *>());
-    return fields_;
+}
+
+list<str *> *reader::__next__() {
+    if(!this->parse_record())
+        throw new StopIteration();
+    return this->fields;
+}
+
+list<list<str *> *> *reader::read_rows(__ss_int n) {
+    list<list<str *> *> *rows = new list<list<str *> *>();
+    if(n > 0)
+        rows->units.reserve((size_t)std::min(n, (__ss_int)1024));
+    for(; n != 0 and this->parse_record(); n--)
+        rows->units.push_back(this->fields);
+    return rows;
 }
 
 void *reader::__init__(file *input_iter_, str *dialect_, str *delimiter, str *quotechar, __ss_int doublequote, __ss_int skipinitialspace, str *lineterminator, __ss_int quoting, str *escapechar, __ss_int strict) {
@@ -303,28 +386,14 @@ void *reader::__init__(file *input_iter_, str *dialect_, str *delimiter, str *qu
     }
     this->input_iter = input_iter_;
     this->line_num = 0;
+    this->fields = NULL;
     this->dialect = _get_dialect(dialect_, delimiter, quotechar, doublequote, skipinitialspace, lineterminator, quoting, escapechar, strict);
-    return NULL;
-}
-
-void *reader::parse_save_field() {
-    str *field_;
 
-    field_ = (const_16)->join(this->field);
-    this->field = (new list<str *>());
-    if (this->numeric_field) {
-        this->numeric_field = 0;
-    }
-    (this->fields)->append(field_);
-    return NULL;
-}
-
-void *reader::parse_add_char(str *c) {
-    
-    if ((len(this->field)>=_field_limit)) {
-        throw ((new Error(__mod6(const_17, 1, _field_limit))));
-    }
-    (this->field)->append(c);
+    this->delimiter = __csv_char(dialect->delimiter);
+    this->quotechar = (dialect->quoting != QUOTE_NONE) ? __csv_char(dialect->quotechar) : -1;
+    this->escapechar = __csv_char(dialect->escapechar);
+    this->field_stops.init(this->delimiter, this->escapechar, '\n', '\r');
+    this->quoted_stops.init(this->quotechar, this->escapechar, -1, -1);
     return NULL;
 }
 
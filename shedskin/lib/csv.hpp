@@ -61,29 +61,41 @@ public:
     list<str *> *__next__();
 };
 
+/* bytes that end a run of plain field characters (always including '\0') */
+struct __csv_stops {
+    char needle[5];
+    bool table[256];
+
+    void init(int a, int b, int c, int d);
+};
+
 extern class_ *cl_reader;
 class reader : public pyiter<list<str *> *> {
 public:
     Excel *dialect;
     __ss_int line_num;
     list<str *> *fields;
-    list<str *> *field;
+    __GC_STRING field; /* for fields that are not a single run of one line */
     __ss_int state;
-    __ss_int numeric_field;
     file *input_iter;
 
+    int delimiter, quotechar, escapechar;
+    __csv_stops field_stops, quoted_stops;
+
     reader() {}
     reader(file *input_iter_, str *dialect_, str *delimiter, str *quotechar, __ss_int doublequote, __ss_int skipinitialspace, str *lineterminator, __ss_int quoting, str *escapechar, __ss_int strict) {
         this->__class__ = cl_reader;
         __init__(input_iter_, dialect_, delimiter, quotechar, doublequote, skipinitialspace, lineterminator, quoting, escapechar, strict);
     }
-    void *parse_process_char(str *c);
-    void *parse_reset();
     list<str *> *__next__();
     __csviter *__iter__();
     void *__init__(file *input_iter_, str *dialect_, str *delimiter, str *quotechar, __ss_int doublequote, __ss_int skipinitialspace, str *lineterminator, __ss_int quoting, str *escapechar, __ss_int strict);
-    void *parse_save_field();
-    void *parse_add_char(str *c);
+    list<list<str *> *> *read_rows(__ss_int n=-1);
+
+    bool parse_record();
+    void parse_line(const char *p, const char *end);
+    void parse_add(const char *run, const char *p);
+    void parse_save_field(const char *run, const char *p);
 };
 
 extern class_ *cl_writer;
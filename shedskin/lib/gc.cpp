@@ -8,23 +8,160 @@ void __init() {
 
 }
 
+/* (GC_enable/GC_disable nest, while python's enable/disable do not) */
+
 void *enable() {
-    GC_enable();
+#ifndef __SS_ARENA
+    if(GC_is_disabled())
+        GC_enable();
+#endif
 
     return NULL;
 }
 
 void *disable() {
-    GC_disable();
+#ifndef __SS_ARENA
+    if(!GC_is_disabled())
+        GC_disable();
+#endif
 
     return NULL;
 }
 
+__ss_bool isenabled() {
+#ifdef __SS_ARENA
+    return False;
+#else
+    return __mbool(!GC_is_disabled());
+#endif
+}
+
 void *collect() {
+#ifndef __SS_ARENA
     GC_gcollect();
+#endif
 
     return NULL;
 }
 
-} // module namespace
+/* as in cpython, a dict per generation. the boehm gc does not count collected objects, and
+   without incremental mode every collection is a full one, so all are counted as generation 2 */
+
+list<dict<str *, __ss_int> *> *get_stats() {
+    list<dict<str *, __ss_int> *> *generations = new list<dict<str *, __ss_int> *>();
+    for(int generation = 0; generation < 3; generation++) {
+        dict<str *, __ss_int> *stats = new dict<str *, __ss_int>();
+#ifdef __SS_ARENA
+        stats->__setitem__(new str("collections"), 0);
+#else
+        stats->__setitem__(new str("collections"), generation == 2 ? (__ss_int)GC_get_gc_no() : 0);
+#endif
+        stats->__setitem__(new str("collected"), 0);
+        stats->__setitem__(new str("uncollectable"), 0);
+        generations->append(stats);
+    }
+    return generations;
+}
+
+/* heap statistics, shedskin only (also written at exit when SHEDSKIN_STATS is set) */
+
+dict<str *, __ss_int> *get_heap_stats() {
+    dict<str *, __ss_int> *stats = new dict<str *, __ss_int>();
+
+#ifdef __SS_ARENA
+    const char *keys[] = {"heap_size", "free_bytes", "unmapped_bytes", "bytes_since_gc", "total_bytes", "collections", "pause_total_us", "pause_max_us", "parallel_markers"};
+    for(const char *key : keys)
+        stats->__setitem__(new str(key), 0);
+    stats->__setitem__(new str("heap_size"), (__ss_int)__ss_arena_mapped());
+    stats->__setitem__(new str("total_bytes"), (__ss_int)__ss_arena_mapped());
+#else
+    stats->__setitem__(new str("heap_size"), (__ss_int)GC_get_heap_size());
+    stats->__setitem__(new str("free_bytes"), (__ss_int)GC_get_free_bytes());
+    stats->__setitem__(new str("unmapped_bytes"), (__ss_int)GC_get_unmapped_bytes());
+    stats->__setitem__(new str("bytes_since_gc"), (__ss_int)GC_get_bytes_since_gc());
+    stats->__setitem__(new str("total_bytes"), (__ss_int)GC_get_total_bytes());
+    stats->__setitem__(new str("collections"), (__ss_int)GC_get_gc_no());
+    stats->__setitem__(new str("pause_total_us"), (__ss_int)__gc_pause_total);
+    stats->__setitem__(new str("pause_max_us"), (__ss_int)__gc_pause_max);
+    stats->__setitem__(new str("parallel_markers"), (__ss_int)GC_get_parallel());
+#endif
+
+    return stats;
+}
+
+/* tuning */
+
+__ss_int get_free_space_divisor() {
+#ifdef __SS_ARENA
+    return 0;
+#else
+    return (__ss_int)GC_get_free_space_divisor();
+#endif
+}
+
+void *set_free_space_divisor(__ss_int divisor) {
+    if(divisor < 1)
+        throw new ValueError(new str("free space divisor must be positive"));
+#ifndef __SS_ARENA
+    GC_set_free_space_divisor((GC_word)divisor);
+#endif
+
+    return NULL;
+}
+
+__ss_bool expand_heap(__ss_int nbytes) {
+    if(nbytes < 0)
+        throw new ValueError(new str("negative heap expansion"));
+#ifdef __SS_ARENA
+    return False;
+#else
+    return __mbool(GC_expand_hp((size_t)nbytes) != 0);
+#endif
+}
+
+void *enable_incremental() {
+#ifndef __SS_ARENA
+    GC_enable_incremental();
+#endif
+
+    return NULL;
+}
+
+__ss_bool isincremental() {
+#ifdef __SS_ARENA
+    return False;
+#else
+    return __mbool(GC_is_incremental_mode());
+#endif
+}
 
+/* region reset points (--arena): everything the calling thread allocated after arena_mark()
+   is released by arena_reset(mark), and must no longer be used. without --arena, these do
+   nothing */
+
+__ss_int arena_mark() {
+#ifdef __SS_ARENA
+    return (__ss_int)__ss_arena_mark();
+#else
+    return 0;
+#endif
+}
+
+void *arena_reset(__ss_int mark) {
+#ifdef __SS_ARENA
+    /* (drop per-thread scratch buffers, which may have grown since the mark) */
+    if(__join_cache)
+        __GC_VECTOR(str *)().swap(__join_cache->units);
+    if(__join_cache_bin)
+        __GC_VECTOR(bytes *)().swap(__join_cache_bin->units);
+    if(mark < 0 || !__ss_arena_reset((size_t)mark))
+        throw new ValueError(new str("invalid arena mark"));
+#else
+    if(mark < 0)
+        throw new ValueError(new str("invalid arena mark"));
+#endif
+
+    return NULL;
+}
+
+} // module namespace
@@ -14,7 +14,27 @@ void *enable();
 
 void *disable();
 
+__ss_bool isenabled();
+
 void *collect();
 
+list<dict<str *, __ss_int> *> *get_stats();
+
+dict<str *, __ss_int> *get_heap_stats();
+
+__ss_int get_free_space_divisor();
+
+void *set_free_space_divisor(__ss_int divisor);
+
+__ss_bool expand_heap(__ss_int nbytes);
+
+void *enable_incremental();
+
+__ss_bool isincremental();
+
+__ss_int arena_mark();
+
+void *arena_reset(__ss_int mark);
+
 } // module namespace
 #endif
@@ -6,5 +6,35 @@ def enable():
 def disable():
     pass
 
+def isenabled():
+    return True
+
 def collect():
     pass
+
+def get_stats():
+    return [{'': 1}]
+
+def get_heap_stats():
+    return {'': 1}
+
+def get_free_space_divisor():
+    return 1
+
+def set_free_space_divisor(divisor):
+    pass
+
+def expand_heap(nbytes):
+    return True
+
+def enable_incremental():
+    pass
+
+def isincremental():
+    return True
+
+def arena_mark():
+    return 1
+
+def arena_reset(mark):
+    pass
@@ -20,7 +20,7 @@ public:
     void *seek(__ss_int i, __ss_int w=0);
     __ss_int tell() { return pos; }
     void *truncate(int size=-1) {
-        s->unit.resize((size_t)(size == -1 ? pos : size));
+        s->unit.resize((size_t)(size == -1 ? pos : (__ss_int)size));
         return NULL;
     }
     void *write(bytes *data);
@@ -43,7 +43,7 @@ public:
     void *seek(__ss_int i, __ss_int w=0);
     __ss_int tell() { return pos; }
     void *truncate(int size=-1) {
-        s->unit.resize((size_t)(size == -1 ? pos : size));
+        s->unit.resize((size_t)(size == -1 ? pos : (__ss_int)size));
         return NULL;
     }
     void *write(str *data);
@@ -15,7 +15,7 @@ namespace __itertools__ {
 /* Local helpers */
 
 template<class T> static bool _identity(T value) {
-    return value;
+    return (bool)value;
 }
 
 /* Infinite Iterators */
@@ -564,7 +564,7 @@ void *mmap::seek(__ss_int offset, __ss_int whence)
 {
     __raise_if_closed();
     const iterator restore = m_begin + tell();
-    switch (whence)
+    switch ((int)whence)
     {
     case 0: /* SEEK_SET: relative to start.*/
         if (offset < 0L or size_t(offset) > __size())
@@ -711,7 +711,7 @@ bytes *mmap::__slice__(__ss_int kind, __ss_int lower, __ss_int upper, __ss_int)
 
     iterator start = m_begin;
     size_t size = 0;
-    switch (kind)
+    switch ((int)kind)
     {
     case 1: // step[x:]
         start = m_begin + __subscript(lower);
@@ -737,7 +737,7 @@ void *mmap::__setslice__(__ss_int kind, __ss_int lower, __ss_int upper, __ss_int
     __raise_if_closed_or_not_writable();
     iterator start = m_end;
     iterator finish = m_end;
-    switch (kind)
+    switch ((int)kind)
     {
     case 1: // step[x:]
         start = m_begin + __subscript(lower, true);
@@ -57,7 +57,7 @@ class mmap: public pyobj
     typedef char* iterator;
 
 
-    static const __ss_int all = -1;
+    static const int all = -1;
     /**
       * Constructors.
       */
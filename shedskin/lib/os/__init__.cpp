@@ -83,7 +83,7 @@ struct stat sbuf;
 struct statvfs vbuf;
 #endif
 
-const __ss_int MAXENTRIES = 4096; /* XXX fix functions that use this */
+const int MAXENTRIES = 4096; /* XXX fix functions that use this */
 
 str *altsep, *curdir, *defpath, *devnull, *extsep, *pardir, *pathsep, *sep;
 
@@ -281,7 +281,7 @@ __ss_int __cstat::__len__() {
 
 __ss_int __cstat::__getitem__(__ss_int i) {
     i = __wrap(this, i);
-    switch(i) {
+    switch((int)i) {
         case 0: return (__ss_int)st_mode;
         case 1: return (__ss_int)st_ino;
         case 2: return (__ss_int)st_dev;
@@ -985,7 +985,7 @@ __ss_int __vfsstat::__len__() {
 
 __ss_int __vfsstat::__getitem__(__ss_int i) {
     i = __wrap(this, i);
-    switch(i) {
+    switch((int)i) {
         case 0: return (__ss_int)vbuf.f_bsize;
         case 1: return (__ss_int)vbuf.f_frsize;
         case 2: return (__ss_int)vbuf.f_blocks;
@@ -4,6 +4,30 @@
 
 namespace __re__ {
 
+/* key for the compiled pattern cache */
+struct __cache_key {
+    str *pattern;
+    __ss_int flags;
+};
+
+}
+
+namespace __shedskin__ {
+
+template<> inline size_t __table_hash(const __re__::__cache_key &key) {
+    size_t hash = (size_t)hasher<str *>(key.pattern) ^ ((size_t)key.flags * 0x9e3779b9);
+    if(hash >= __SS_HASH_DUMMY)
+        hash -= 2;
+    return hash;
+}
+template<> inline bool __table_eq(__re__::__cache_key a, __re__::__cache_key b) {
+    return a.flags == b.flags && __table_eq<str *>(a.pattern, b.pattern);
+}
+
+}
+
+namespace __re__ {
+
 //flags
 const __ss_int
     I = 0x02, IGNORECASE    = 0x02,
@@ -13,7 +37,9 @@ const __ss_int
     U = 0x20, __ss_UNICODE  = 0x20,
     X = 0x40, VERBOSE       = 0x40;
 
-const unsigned char *local_table;
+//allocation (through the garbage collector) and compilation contexts
+pcre2_general_context *general_context;
+pcre2_compile_context *compile_context, *locale_context;
 
 class_ *cl_error;
 
@@ -230,43 +256,142 @@ __GC_STRING re_object::__expand(__GC_STRING *subj, int *captured, __GC_STRING tp
 
 
 //replacing pcre's allocation functions with ours using the garbage collector
-void *re_malloc(size_t n)
+//(with --arena, compiled patterns and match data must survive gc.arena_reset, so use malloc)
+void *re_malloc(PCRE2_SIZE n, void *)
 {
+#ifdef __SS_ARENA
+    return malloc(n);
+#else
     return GC_MALLOC(n);
+#endif
 }
 
-void re_free(void *o)
+void re_free(void *o, void *)
 {
+#ifdef __SS_ARENA
+    free(o);
+#else
     GC_FREE(o);
+#endif
+}
+
+#ifdef __SS_THREADS
+//serializes access to the pattern cache, and lazy compilation of anchored variants
+static std::mutex __cache_lock;
+
+//with threads, match data is kept per thread instead of per re_object. it is allocated
+//outside of the garbage collected heap, as thread-local storage is not scanned, and freed
+//when the thread exits
+struct __match_data_holder
+{
+    pcre2_match_data *data = NULL;
+    ~__match_data_holder() { if(data) pcre2_match_data_free(data); }
+};
+static thread_local __match_data_holder __thread_match_data;
+#endif
+
+pcre2_match_data *re_object::__match_data()
+{
+#ifdef __SS_THREADS
+    pcre2_match_data *&data = __thread_match_data.data;
+    if(!data || pcre2_get_ovector_count(data) < (uint32_t)capture_count + 1)
+    {
+        if(data) pcre2_match_data_free(data);
+        data = pcre2_match_data_create((uint32_t)capture_count + 1, 0);
+    }
+
+    return data;
+#else
+    return match_data;
+#endif
+}
+
+//jit-compiled code lives outside of the garbage collected heap
+static void __free_jit(void *obj, void *)
+{
+    re_object *ro = (re_object *)obj;
+
+    pcre2_code_free(ro->compiled_pattern);
+    if(ro->anchored_pattern.load()) pcre2_code_free(ro->anchored_pattern.load());
+}
+
+//anything but 'no match' (match or depth limit, jit stack, bad utf..) is an error
+static void __throw_match_error(int errcode)
+{
+    PCRE2_UCHAR errmsg[256];
+    pcre2_get_error_message(errcode, errmsg, sizeof(errmsg));
+    throw new error(new str((char *)errmsg));
+}
+
+//match against (a prefix of length len of) subj, leaving offsets in match_data
+int re_object::__match(str *subj, size_t len, size_t pos, uint32_t options)
+{
+    pcre2_code *code = compiled_pattern;
+
+    if((options & PCRE2_ANCHORED) && jit)
+    {
+        code = anchored_pattern.load(std::memory_order_acquire);
+        if(!code)
+        {
+#ifdef __SS_THREADS
+            std::lock_guard<std::mutex> guard(__cache_lock);
+            code = anchored_pattern.load(std::memory_order_relaxed);
+            if(!code)
+#endif
+            {
+                code = __compile_code(pattern, flags, PCRE2_ANCHORED);
+                pcre2_jit_compile(code, PCRE2_JIT_COMPLETE);
+                anchored_pattern.store(code, std::memory_order_release);
+            }
+        }
+
+        options &= ~PCRE2_ANCHORED;
+    }
+
+    int r = pcre2_match(
+        code,
+        (PCRE2_SPTR)subj->unit.data(),
+        len,
+        pos,
+        options,
+        __match_data(),
+        0
+    );
+
+    if(r < 0 && r != PCRE2_ERROR_NOMATCH && r != PCRE2_ERROR_PARTIAL)
+        __throw_match_error(r);
+
+    return r;
+}
+
+//copy offsets from match_data, using -1 for unset groups
+void re_object::__captured(int *captured)
+{
+    PCRE2_SIZE *ovector;
+    int i;
+
+    ovector = pcre2_get_ovector_pointer(__match_data());
+
+    for(i = 0; i < (capture_count + 1) * 2; i++)
+        captured[i] = ovector[i] == PCRE2_UNSET ? -1 : (int)ovector[i];
 }
 
 str *re_object::__subn(str *repl, str *subj, __ss_int maxn, int *howmany)
 {
     __GC_STRING *s, out;
-    int *captured, clen, i, cur;
-    const char *c_subj;
+    int *captured, i, cur;
 
     //temporary data
-    clen = (capture_count + 1) * 2 * 3;
-    captured = (int *)GC_MALLOC((size_t)clen * sizeof(int));
+    captured = (int *)GC_MALLOC_ATOMIC((size_t)(capture_count + 1) * 2 * sizeof(int));
 
     out = "";
 
     s = &subj->unit;
-    c_subj = s->c_str();
     for(cur = i = 0; maxn <= 0 || cur < maxn; cur++)
     {
         //get a match
-        if(pcre_exec(
-            compiled_pattern,
-            study_info,
-            c_subj,
-            (int)s->size(),
-            i,
-            0,
-            captured,
-            clen
-        ) <= 0) break;
+        if(__match(subj, s->size(), (size_t)i, 0) <= 0) break;
+        __captured(captured);
 
         //append stuff we skipped
         out += s->substr((size_t)i, (size_t)(captured[0] - i));
@@ -336,31 +461,20 @@ list<str *> *re_object::__splitfind(str *subj, __ss_int maxn, char onlyfind, __s
 {
     __GC_STRING *subjs;
     list<str *> *r;
-    int *captured, clen, i, j, cur;
-    const char *c_subj;
+    int *captured, i, j, cur;
 
     //temporary data
-    clen = (capture_count + 1) * 2 * 3;
-    captured = (int *)GC_MALLOC((size_t)clen * sizeof(int));
+    captured = (int *)GC_MALLOC_ATOMIC((size_t)(capture_count + 1) * 2 * sizeof(int));
 
     //'permanent' (in respect to the lifetime of this function)
     r = new list<str *>();
 
     subjs = &subj->unit;
-    c_subj = subjs->c_str();
     for(cur = i = 0; maxn <= 0 || cur < maxn; cur++)
     {
         //get a match
-        if(pcre_exec(
-            compiled_pattern,
-            study_info,
-            c_subj,
-            (int)subjs->size(),
-            i,
-            flags_,
-            captured,
-            clen
-        ) <= 0) break;
+        if(__match(subj, subjs->size(), (size_t)i, (uint32_t)flags_) <= 0) break;
+        __captured(captured);
 
         //this whole subroutine is very similar to findall, so we might as well save some code and merge them...
         if(onlyfind)
@@ -448,14 +562,10 @@ __iter<match_object *> *re_object::finditer(str *subj, __ss_int pos, __ss_int en
 match_object *re_object::__exec(str *subj, __ss_int pos, __ss_int endpos, __ss_int flags_)
 {
     match_object *mobj;
-    int *captured, clen, r, t, mx_i, nendpos;
+    int *captured, r, t, mx_i, nendpos;
     str *mx_s;
     mx_s = NULL;
 
-    //allocate captured array
-    clen = (capture_count + 1) * 2 * 3;
-    captured = (int *)GC_MALLOC((size_t)clen * sizeof(int));
-
     //sanity checking
     if(endpos == -1) nendpos = (__ss_int)subj->unit.size() - 1;
     else if(endpos < pos) throw new error(new str("end position less than initial"));
@@ -463,20 +573,15 @@ match_object *re_object::__exec(str *subj, __ss_int pos, __ss_int endpos, __ss_i
 
     if(subj->unit.size()!=0 and (unsigned int)pos >= subj->unit.size()) throw new error(new str("starting position >= string length"));
 
-    r = pcre_exec(
-        compiled_pattern,
-        study_info,
-        subj->c_str(),
-        nendpos + 1,
-        pos,
-        flags_,
-        captured,
-        clen
-    );
+    r = __match(subj, (size_t)(nendpos + 1), (size_t)pos, (uint32_t)flags_);
 
-    //no match was found (dont have to worry about freeing thanks to the garbage collector)
+    //no match was found
     if(r < 0) return (match_object *)NULL;
 
+    //copy offsets, as match_data is reused
+    captured = (int *)GC_MALLOC_ATOMIC((size_t)(capture_count + 1) * 2 * sizeof(int));
+    __captured(captured);
+
     //create object now that we know we're successful
     mobj = new match_object();
     mobj->re = this;
@@ -511,7 +616,7 @@ match_object *re_object::__exec(str *subj, __ss_int pos, __ss_int endpos, __ss_i
 
 match_object *re_object::match(str *subj, __ss_int pos, __ss_int endpos)
 {
-    return __exec(subj, pos, endpos, PCRE_ANCHORED);
+    return __exec(subj, pos, endpos, PCRE2_ANCHORED);
 }
 
 match_object *re_object::search(str *subj, __ss_int pos, __ss_int endpos)
@@ -524,7 +629,7 @@ match_object *re_object::search(str *subj, __ss_int pos, __ss_int endpos)
 __ss_int __convert_flags(__ss_int flags)
 {
     int ta[] = {IGNORECASE, MULTILINE, DOTALL, __ss_UNICODE, VERBOSE},
-        tb[] = {PCRE_CASELESS, PCRE_MULTILINE, PCRE_DOTALL, PCRE_UTF8, PCRE_EXTENDED};
+        tb[] = {PCRE2_CASELESS, PCRE2_MULTILINE, PCRE2_DOTALL, PCRE2_UTF, PCRE2_EXTENDED};
     int i, r;
 
     r = 0;
@@ -534,49 +639,66 @@ __ss_int __convert_flags(__ss_int flags)
     return r;
 }
 
-re_object *compile(str *pat, __ss_int flags)
+pcre2_code *__compile_code(str *pat, __ss_int flags, uint32_t options)
 {
-    re_object *reobj;
     __GC_STRING fullerr;
-    pcre *cpat;
-    char *errmsg, *nametable;
-    int options, erroff, ntlen, nteach, i;
-
-    //convert flags
-    options = __convert_flags(flags);
+    pcre2_code *code;
+    PCRE2_UCHAR errmsg[256];
+    PCRE2_SIZE erroff;
+    int errcode;
 
     //attempt a compilation
-    cpat = pcre_compile(
-        pat->c_str(),
-        options,
-        (const char **)&errmsg,
+    code = pcre2_compile(
+        (PCRE2_SPTR)pat->unit.data(),
+        pat->unit.size(),
+        options | (uint32_t)__convert_flags(flags),
+        &errcode,
         &erroff,
-        (flags & LOCALE ? local_table : 0)
+        (flags & LOCALE ? locale_context : compile_context)
     );
 
     //...
-    if(!cpat)
+    if(!code)
     {
-        fullerr = "char " + erroff;
+        pcre2_get_error_message(errcode, errmsg, sizeof(errmsg));
+
+        fullerr = "char ";
+        fullerr += __str((__ss_int)erroff)->unit;
         fullerr += ":";
-        fullerr += errmsg;
+        fullerr += (char *)errmsg;
 
         throw new error(new str(fullerr));
     }
 
+    return code;
+}
+
+static re_object *__compile(str *pat, __ss_int flags)
+{
+    re_object *reobj;
+    PCRE2_SPTR nametable;
+    uint32_t ntlen, nteach, capture_count, i;
+
     //everythings ok, create object
     reobj = new re_object();
-    reobj->compiled_pattern = cpat;
+    reobj->compiled_pattern = __compile_code(pat, flags, 0);
+    reobj->anchored_pattern = 0;
+
+    //compile to machine code where supported (falls back to interpretation otherwise)
+    reobj->jit = pcre2_jit_compile(reobj->compiled_pattern, PCRE2_JIT_COMPLETE) == 0;
+    if(reobj->jit)
+        GC_register_finalizer_no_order(reobj, __free_jit, 0, 0, 0);
 
-    //might as well study it
-    reobj->study_info = pcre_study(cpat, 0, (const char **)&errmsg);
+#ifndef __SS_THREADS
+    reobj->match_data = pcre2_match_data_create_from_pattern(reobj->compiled_pattern, general_context);
+#endif
 
     //any named indices?
     reobj->groupindex = new dict<str *, __ss_int>();
 
-    pcre_fullinfo(cpat, reobj->study_info, PCRE_INFO_NAMECOUNT, (void *)&ntlen);
-    pcre_fullinfo(cpat, reobj->study_info, PCRE_INFO_NAMEENTRYSIZE, (void *)&nteach);
-    pcre_fullinfo(cpat, reobj->study_info, PCRE_INFO_NAMETABLE, (void *)&nametable);
+    pcre2_pattern_info(reobj->compiled_pattern, PCRE2_INFO_NAMECOUNT, &ntlen);
+    pcre2_pattern_info(reobj->compiled_pattern, PCRE2_INFO_NAMEENTRYSIZE, &nteach);
+    pcre2_pattern_info(reobj->compiled_pattern, PCRE2_INFO_NAMETABLE, &nametable);
 
     for(i = 0; i < ntlen; i++)
     {
@@ -589,11 +711,75 @@ re_object *compile(str *pat, __ss_int flags)
     //extra info
     reobj->pattern = new str(pat->unit);
     reobj->flags = flags;
-    pcre_fullinfo(cpat, 0, PCRE_INFO_CAPTURECOUNT, &reobj->capture_count);
+    pcre2_pattern_info(reobj->compiled_pattern, PCRE2_INFO_CAPTURECOUNT, &capture_count);
+    reobj->capture_count = capture_count;
 
     return reobj;
 }
 
+/* compiled pattern cache (cf. CPython's re._cache), so that module-level functions and
+   repeated compile calls do not recompile the same (pattern, flags). it is bounded, and
+   entries are kept in order of last use (a hit moves the entry to the end of the table),
+   so the least recently used pattern is evicted first (with --arena: the oldest one) */
+
+static __GC_DICT<__cache_key, re_object *> *__cache;
+
+re_object *compile(str *pat, __ss_int flags)
+{
+    __cache_key key = {pat, flags};
+    re_object *reobj;
+
+#ifdef __SS_THREADS
+    std::lock_guard<std::mutex> guard(__cache_lock);
+#endif
+#ifdef __SS_ARENA
+    __ss_arena_keep keep; //the cache outlives gc.arena_reset
+#endif
+
+    auto it = __cache->find(key);
+    if(it != __cache->end())
+    {
+        reobj = it->second;
+
+#ifndef __SS_ARENA
+        if(it.pos != __cache->entries.size() - 1)
+        {
+            bool inserted;
+            key.pattern = it->first.pattern;
+            __cache->erase(it);
+            __cache->insert(key, reobj, inserted);
+        }
+#endif
+
+        return reobj;
+    }
+
+    reobj = __compile(pat, flags);
+    key.pattern = reobj->pattern; //(a copy)
+
+    //(with --arena, an evicted pattern is never freed: it lives in the kept region, and there
+    //are no finalizers to release its pcre2 code. that is also why hits do not reorder)
+    if(__cache->size() >= __SS_RE_MAXCACHE)
+        __cache->erase(__cache->begin());
+
+    bool inserted;
+    __cache->insert(key, reobj, inserted);
+
+    return reobj;
+}
+
+void *purge()
+{
+#ifdef __SS_THREADS
+    std::lock_guard<std::mutex> guard(__cache_lock);
+#endif
+#ifdef __SS_ARENA
+    __ss_arena_keep keep;
+#endif
+    __cache->clear();
+    return NULL;
+}
+
 str *escape(str *s)
 {
     __GC_STRING *ps, out;
@@ -627,27 +813,25 @@ str *escape(str *s)
     return new str(out);
 }
 
-match_object *__exec_once(str *pat, str *subj, __ss_int flags)
+match_object *__exec_once(str *pat, str *subj, __ss_int flags, __ss_int flags_)
 {
     re_object *r;
-    match_object *mo;
 
+    //compiled objects are cached, so don't free
     r = compile(pat, flags);
-    mo = r->__exec(subj, 0, -1, 0);
 
-    if(!mo) GC_FREE(r);
-
-    return mo;
+    return r->__exec(subj, 0, -1, flags_);
 }
 
 match_object *search(str *pat, str *subj, __ss_int flags)
 {
-    return __exec_once(pat, subj, flags);
+    return __exec_once(pat, subj, flags, 0);
 }
 
 match_object *match(str *pat, str *subj, __ss_int flags)
 {
-    return __exec_once(pat, subj, flags | PCRE_ANCHORED);
+    //anchor at execution time (PCRE2_ANCHORED is not a python flag)
+    return __exec_once(pat, subj, flags, PCRE2_ANCHORED);
 }
 
 __iter<match_object *> *finditer(str *pat, str *subj, __ss_int pos, __ss_int endpos, __ss_int flags)
@@ -719,10 +903,13 @@ void __init(void)
 {
     cl_error = new class_("error");
 
-    pcre_malloc = &re_malloc;
-    pcre_free = &re_free;
+    general_context = pcre2_general_context_create(&re_malloc, &re_free, 0);
+    compile_context = pcre2_compile_context_create(general_context);
+
+    locale_context = pcre2_compile_context_create(general_context);
+    pcre2_set_character_tables(locale_context, pcre2_maketables(general_context));
 
-    local_table = pcre_maketables();
+    __cache = new __GC_DICT<__cache_key, re_object *>();
 
 }
 
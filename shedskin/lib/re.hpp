@@ -4,19 +4,20 @@
 #define __RE_HPP
 
 //depending on what you want...
-//#define PCRE_STATIC
+//#define PCRE2_STATIC
 
 #include "builtin.hpp"
+#include <atomic>
 
-#ifndef __sun
-#include <pcre.h>
-#else
-#include <pcre/pcre.h>
-#endif
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
 
 
 using namespace __shedskin__;
 
+/* maximum number of compiled patterns kept around (as in CPython) */
+#define __SS_RE_MAXCACHE 512
+
 namespace __re__ {
 
 extern const __ss_int I, L, M, S, U, X,
@@ -131,9 +132,19 @@ public:
     __GC_STRING __group(__GC_STRING *subj, int *captured, str *m);
     __GC_STRING __expand(__GC_STRING *subj, int *captured, __GC_STRING tpl);
 
-    //the compiled pattern + extra info for optimization
-    pcre *compiled_pattern;
-    pcre_extra *study_info;
+    //the compiled pattern (jit-compiled if possible), and an anchored variant for
+    //match(), compiled on first use (by whichever thread gets there first), as the jit
+    //does not support anchoring at match time
+    pcre2_code *compiled_pattern;
+    std::atomic<pcre2_code *> anchored_pattern;
+    bool jit;
+
+    //match data (ovector), reused across matches
+    pcre2_match_data *match_data;
+    pcre2_match_data *__match_data();
+
+    int __match(str *subj, size_t len, size_t pos, uint32_t options);
+    void __captured(int *captured);
 
     match_object *__exec(str *subj, __ss_int pos = 0, __ss_int endpos = -1, __ss_int flags_ = 0);
     str *__subn(str *repl, str *subj, __ss_int maxn = -1, int *howmany = 0);
@@ -173,15 +184,18 @@ str *sub(str *pat, replfunc repl, str *subj, __ss_int maxn = 0);
 tuple2<str *, __ss_int> *subn(str *pat, str *repl, str *subj, __ss_int maxn = 0);
 list<str *> *findall(str *pat, str *subj, __ss_int flags = 0);
 str *escape(str *s);
+void *purge();
 
 list<str *> *__splitfind_once(str *pat, str *subj, __ss_int maxn, char onlyfind, __ss_int flags);
-match_object *__exec_once(str *subj, __ss_int flags);
+match_object *__exec_once(str *pat, str *subj, __ss_int flags, __ss_int flags_);
 
 //internal functions
 void __init(void);
 
-void *re_malloc(size_t n);
-void re_free(void *o);
+pcre2_code *__compile_code(str *pat, __ss_int flags, uint32_t options);
+
+void *re_malloc(PCRE2_SIZE n, void *data);
+void re_free(void *o, void *data);
 
 }
 #endif
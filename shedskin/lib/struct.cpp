@@ -5,7 +5,7 @@
 
 namespace __struct__ {
 
-void *buffy;
+alignas(8) __SS_THREAD_LOCAL char buffy[8];
 class_ *cl_error;
 bool little_endian;
 
@@ -76,8 +76,11 @@ __ss_int unpack_int(char o, char c, unsigned int d, bytes *data, __ss_int *pos)
             result |= (c2 << 8*i);
     }
     *pos += (__ss_int)itemsize;
-    if(c == 'h')
-        return (short)result;
+    if(c == 'b' or c == 'h' or c == 'i' or c == 'l' or c == 'q') { /* sign-extend */
+        if(itemsize < 8 and (result >> (8*itemsize-1)) & 1)
+            result |= ~0ULL << (8*itemsize);
+        return (__ss_int)(long long)result;
+    }
     return (__ss_int)result;
 }
 
@@ -333,11 +336,218 @@ void fillbuf_float(char c, double t, char, unsigned int) {
     }
 }
 
+/* struct.Struct */
+
+class_ *cl_Struct;
+
+Struct::Struct(str *fmt) {
+    this->__class__ = cl_Struct;
+    format = fmt;
+
+    char order = '@';
+    size_t pos = 0;
+    size_t i = 0, n = fmt->unit.size();
+    if(n and strchr("@=<>!", fmt->unit[0]))
+        order = fmt->unit[i++];
+
+    while(i < n) {
+        char c = fmt->unit[i++];
+        if(isspace((unsigned char)c))
+            continue;
+        size_t count = 1;
+        if(isdigit((unsigned char)c)) {
+            count = 0;
+            while(isdigit((unsigned char)c)) {
+                count = 10*count + (size_t)(c - '0');
+                if(i == n)
+                    throw new error(new str("repeat count given without format specifier"));
+                c = fmt->unit[i++];
+            }
+        }
+        __struct_item it;
+        it.code = c;
+        it.swap = false;
+        switch(c) {
+            case 'b':
+            case 'B':
+            case 'h':
+            case 'H':
+            case 'i':
+            case 'I':
+            case 'l':
+            case 'L':
+            case 'q':
+            case 'Q':
+            case 'N':
+            case 'f':
+            case 'd':
+                if(c == 'N' and order != '@')
+                    throw new error(new str("bad char in struct format"));
+                it.size = get_itemsize(order, c);
+                it.swap = swap_endian(order);
+                if(count)
+                    pos += (size_t)padding(order, (__ss_int)pos, it.size);
+                for(size_t k=0; k<count; k++, pos += it.size) {
+                    it.offset = pos;
+                    items.push_back(it);
+                }
+                break;
+            case 'c':
+            case '?':
+                it.size = 1;
+                for(size_t k=0; k<count; k++, pos++) {
+                    it.offset = pos;
+                    items.push_back(it);
+                }
+                break;
+            case 's':
+            case 'p':
+                it.size = (unsigned int)count;
+                it.offset = pos;
+                items.push_back(it);
+                pos += count;
+                break;
+            case 'x':
+                pos += count;
+                break;
+            case 'P':
+                throw new error(new str("unsupported 'P' char in struct format"));
+            default:
+                throw new error(new str("bad char in struct format"));
+        }
+    }
+    size = (__ss_int)pos;
+}
+
+void Struct::check_items(const char *method, size_t n) {
+    if(n != items.size())
+        throw new error(__mod6(new str("%s expected %d items for packing (got %d)"), 3, new str(method), (__ss_int)items.size(), (__ss_int)n));
+}
+
+size_t Struct::check_buffer(const char *method, __ss_int buffer_size, __ss_int offset) {
+    if(offset < 0) {
+        if(offset + size > 0)
+            throw new error(__mod6(new str("no space to %s %d bytes at offset %d"), 3, new str(method[0] == 'p' ? "pack" : "unpack"), size, offset));
+        if(offset + buffer_size < 0)
+            throw new error(__mod6(new str("offset %d out of range for %d-byte buffer"), 2, offset, buffer_size));
+        offset += buffer_size;
+    }
+    if(buffer_size - offset < size)
+        throw new error(__mod6(new str("%s requires a buffer of at least %d bytes for %s %d bytes at offset %d (actual buffer size is %d)"), 6, new str(method), size + offset, new str(method[0] == 'p' ? "packing" : "unpacking"), size, offset, buffer_size));
+    return (size_t)offset;
+}
+
+void __struct_pack_error(const __struct_item &it) {
+    switch(it.code) {
+        case 'f':
+        case 'd':
+            throw new error(new str("required argument is not a float"));
+        case 'c':
+            throw new error(new str("char format requires a bytes object of length 1"));
+        case 's':
+            throw new error(new str("argument for 's' must be a bytes object"));
+        case 'p':
+            throw new error(new str("argument for 'p' must be a bytes object"));
+        default:
+            throw new error(new str("required argument is not an integer"));
+    }
+}
+
+static void __struct_range_error(const __struct_item &it, long long lo, unsigned long long hi) {
+    char msg[80];
+    snprintf(msg, sizeof(msg), "'%c' format requires %lld <= number <= %llu", it.code, lo, hi);
+    throw new error(new str(msg));
+}
+
+void __struct_pack_int(const __struct_item &it, char *p, long long v) {
+    p += it.offset;
+    switch(it.code) {
+        case '?':
+            *p = v ? '\x01' : '\x00';
+            return;
+        case 'b':
+        case 'h':
+        case 'i':
+        case 'l':
+        case 'q':
+            if(it.size < 8) {
+                long long bound = 1LL << (8*it.size-1);
+                if(v < -bound or v >= bound)
+                    __struct_range_error(it, -bound, (unsigned long long)(bound-1));
+            }
+            break;
+        case 'B':
+        case 'H':
+        case 'I':
+        case 'L':
+        case 'Q':
+        case 'N':
+            if(v < 0 or (it.size < 8 and v >= (1LL << (8*it.size))))
+                __struct_range_error(it, 0, ~0ULL >> (64-8*it.size));
+            break;
+        default:
+            __struct_pack_error(it);
+    }
+    __struct_store(it, p, (unsigned long long)v);
+}
+
+void __struct_pack_float(const __struct_item &it, char *p, double v) {
+    if(it.size == 4) {
+        float f = (float)v;
+        uint32_t bits;
+        memcpy(&bits, &f, 4);
+        __struct_store(it, p + it.offset, bits);
+    } else {
+        uint64_t bits;
+        memcpy(&bits, &v, 8);
+        __struct_store(it, p + it.offset, bits);
+    }
+}
+
+void __struct_pack_bytes(const __struct_item &it, char *p, bytes *b) {
+    size_t n = b->unit.size();
+    p += it.offset;
+    switch(it.code) {
+        case '?':
+            *p = n ? '\x01' : '\x00';
+            return;
+        case 'c':
+            if(n != 1)
+                __struct_pack_error(it);
+            *p = b->unit[0];
+            return;
+        case 's':
+            memcpy(p, b->unit.data(), std::min(n, (size_t)it.size));
+            return;
+        case 'p':
+            if(it.size == 0)
+                return;
+            n = std::min(n, std::min((size_t)it.size-1, (size_t)255));
+            *p = (char)n;
+            memcpy(p+1, b->unit.data(), n);
+            return;
+        default:
+            __struct_pack_error(it);
+    }
+}
+
+bytes *Struct::unpack_bytes_at(const __struct_item &it, const char *record) {
+    const char *p = record + it.offset;
+    size_t n = it.size;
+    if(it.code == 'p') {
+        if(n == 0)
+            return new bytes();
+        n = std::min((size_t)(unsigned char)*p, n-1);
+        p++;
+    }
+    return new bytes(p, (int)n);
+}
+
 void __init() {
     cl_error = new class_("error");
+    cl_Struct = new class_("Struct");
     int num = 1;
     little_endian = (*(char *)&num == 1);
-    buffy = malloc(8);
 }
 
 } // module namespace
@@ -8,7 +8,7 @@
 using namespace __shedskin__;
 namespace __struct__ {
 
-extern void *buffy;
+extern __SS_THREAD_LOCAL char buffy[8]; /* per thread scratch space for (un)packing */
 
 extern class_ *cl_error;
 class error : public Exception {
@@ -288,6 +288,200 @@ template<class ... Args> void *pack_into(int n, str *fmt, bytes *buffer, __ss_in
 str *unpack();
 str *unpack_from();
 
+/* struct.Struct: the format is parsed once, into one item per value (with its offset in the
+   record), so packing and unpacking only index into the plan. values are read from and written
+   to the buffer directly: bytes, bytearray or mmap */
+
+struct __struct_item {
+    char code;
+    bool swap;
+    unsigned int size; /* for 's' and 'p', of the whole field */
+    size_t offset;
+};
+
+inline char *__buffer_data(bytes *b) { return &b->unit[0]; }
+template<class T> inline char *__buffer_data(T *b) { return b->data(); }
+
+inline unsigned long long __struct_load(const __struct_item &it, const char *p) {
+    switch(it.size) {
+        case 1:
+            return (unsigned char)*p;
+        case 2: {
+            uint16_t v;
+            memcpy(&v, p, 2);
+            return it.swap ? __builtin_bswap16(v) : v;
+        }
+        case 4: {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            return it.swap ? __builtin_bswap32(v) : v;
+        }
+        default: {
+            uint64_t v;
+            memcpy(&v, p, 8);
+            return it.swap ? __builtin_bswap64(v) : v;
+        }
+    }
+}
+
+inline void __struct_store(const __struct_item &it, char *p, unsigned long long bits) {
+    switch(it.size) {
+        case 1:
+            *p = (char)bits;
+            break;
+        case 2: {
+            uint16_t v = it.swap ? __builtin_bswap16((uint16_t)bits) : (uint16_t)bits;
+            memcpy(p, &v, 2);
+            break;
+        }
+        case 4: {
+            uint32_t v = it.swap ? __builtin_bswap32((uint32_t)bits) : (uint32_t)bits;
+            memcpy(p, &v, 4);
+            break;
+        }
+        default: {
+            uint64_t v = it.swap ? __builtin_bswap64((uint64_t)bits) : (uint64_t)bits;
+            memcpy(p, &v, 8);
+        }
+    }
+}
+
+void __struct_pack_int(const __struct_item &it, char *p, long long v);
+void __struct_pack_float(const __struct_item &it, char *p, double v);
+void __struct_pack_bytes(const __struct_item &it, char *p, bytes *b);
+void __struct_pack_error(const __struct_item &it);
+
+template<class T> inline void __struct_pack(const __struct_item &it, char *p, T arg) {
+    if(it.code != '?')
+        __struct_pack_error(it);
+    p[it.offset] = ___bool(arg) ? '\x01' : '\x00';
+}
+template<> inline void __struct_pack(const __struct_item &it, char *p, __ss_int arg) {
+    if(it.code == 'f' or it.code == 'd')
+        __struct_pack_float(it, p, (double)arg);
+    else
+        __struct_pack_int(it, p, (long long)arg);
+}
+template<> inline void __struct_pack(const __struct_item &it, char *p, __ss_bool arg) {
+    __struct_pack_int(it, p, arg.value);
+}
+template<> inline void __struct_pack(const __struct_item &it, char *p, __ss_float arg) {
+    if(it.code == '?')
+        p[it.offset] = arg ? '\x01' : '\x00';
+    else if(it.code == 'f' or it.code == 'd')
+        __struct_pack_float(it, p, arg);
+    else
+        __struct_pack_error(it);
+}
+template<> inline void __struct_pack(const __struct_item &it, char *p, bytes *arg) {
+    __struct_pack_bytes(it, p, arg);
+}
+
+extern class_ *cl_Struct;
+class Struct : public pyobj {
+public:
+    str *format;
+    __ss_int size;
+    __GC_VECTOR(__struct_item) items;
+
+    Struct(str *format);
+
+    /* packing */
+
+    template<class ... Args> bytes *pack(int, Args ... args) {
+        check_items("pack", sizeof...(args));
+        bytes *result = new bytes();
+        result->unit.resize((size_t)size);
+        pack_items(&result->unit[0], args...);
+        return result;
+    }
+
+    template<class B, class ... Args> void *pack_into(int, B *buffer, __ss_int offset, Args ... args) {
+        check_items("pack_into", sizeof...(args));
+        char *p = __buffer_data(buffer) + check_buffer("pack_into", len(buffer), offset);
+        memset(p, 0, (size_t)size);
+        pack_items(p, args...);
+        return NULL;
+    }
+
+    template<class ... Args> void pack_items(char *p, Args ... args) {
+        size_t k = 0;
+        (__struct_pack(items[k++], p, args), ...);
+    }
+
+    /* unpacking: a, b, .. = s.unpack(..) becomes a call per value, at a position checked by
+       unpack_start (or unpack_from_start, iter_unpack_start) */
+
+    template<class B> __ss_int unpack_start(B *buffer) {
+        if(len(buffer) != size)
+            throw new error(__mod6(new str("unpack requires a buffer of %d bytes"), 1, size));
+        return 0;
+    }
+    template<class B> __ss_int unpack_from_start(B *buffer, __ss_int offset) {
+        return (__ss_int)check_buffer("unpack_from", len(buffer), offset);
+    }
+    template<class B> __ss_int iter_unpack_start(B *buffer) {
+        if(size == 0)
+            throw new error(new str("cannot iteratively unpack with a struct of length 0"));
+        if(len(buffer) % size != 0)
+            throw new error(__mod6(new str("iterative unpacking requires a buffer of a multiple of %d bytes"), 1, size));
+        return 0;
+    }
+
+    /* otherwise (with a warning), only the check */
+
+    template<class B> void *unpack(B *buffer) {
+        unpack_start(buffer);
+        return NULL;
+    }
+    template<class B> void *unpack_from(B *buffer, __ss_int offset=0) {
+        unpack_from_start(buffer, offset);
+        return NULL;
+    }
+    template<class B> void *iter_unpack(B *buffer) {
+        iter_unpack_start(buffer);
+        return NULL;
+    }
+
+    template<class B> inline __ss_int unpack_int(size_t k, B *buffer, __ss_int pos) {
+        const __struct_item &it = items[k];
+        unsigned long long bits = __struct_load(it, __buffer_data(buffer) + (size_t)pos + it.offset);
+        switch(it.code) {
+            case 'b': return (__ss_int)(signed char)bits;
+            case 'h': return (__ss_int)(int16_t)bits;
+            case 'i':
+            case 'l': if(it.size == 4) return (__ss_int)(int32_t)bits; /* fall through */
+            case 'q': return (__ss_int)(long long)bits;
+        }
+        return (__ss_int)bits;
+    }
+    template<class B> inline __ss_float unpack_float(size_t k, B *buffer, __ss_int pos) {
+        const __struct_item &it = items[k];
+        unsigned long long bits = __struct_load(it, __buffer_data(buffer) + (size_t)pos + it.offset);
+        if(it.size == 4) {
+            uint32_t b32 = (uint32_t)bits;
+            float f;
+            memcpy(&f, &b32, 4);
+            return f;
+        }
+        double d;
+        memcpy(&d, &bits, 8);
+        return d;
+    }
+    template<class B> inline __ss_bool unpack_bool(size_t k, B *buffer, __ss_int pos) {
+        return __mbool(__buffer_data(buffer)[(size_t)pos + items[k].offset] != '\x00');
+    }
+    template<class B> inline bytes *unpack_bytes(size_t k, B *buffer, __ss_int pos) {
+        return unpack_bytes_at(items[k], __buffer_data(buffer) + (size_t)pos);
+    }
+
+    /* internal */
+
+    bytes *unpack_bytes_at(const __struct_item &it, const char *record);
+    void check_items(const char *method, size_t n);
+    size_t check_buffer(const char *method, __ss_int buffer_size, __ss_int offset);
+};
+
 /* internal */
 
 void __init();
@@ -17,3 +17,23 @@ def unpack_from(format, buffer, offset=0):
 
 def calcsize(format):
     return 1
+
+class Struct:
+    def __init__(self, format):
+        self.format = ''
+        self.size = 1
+
+    def pack(self, *vals):
+        return b''
+
+    def pack_into(self, buffer, offset, *vals):
+        pass
+
+    def unpack(self, buffer):
+        pass
+
+    def unpack_from(self, buffer, offset=0):
+        pass
+
+    def iter_unpack(self, buffer):
+        pass
@@ -64,5 +64,9 @@ void *setrecursionlimit(__ss_int) {
     return NULL;
 }
 
+str *intern(str *s) {
+    return __intern(s);
+}
+
 } // module namespace
 
@@ -24,5 +24,7 @@ template<class T> void __ss_exit(T x) {
 
 void *setrecursionlimit(__ss_int limit);
 
+str *intern(str *s);
+
 } // module namespace
 #endif
@@ -0,0 +1,267 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#include "threading.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+namespace __threading__ {
+
+str *__name__;
+
+class_ *cl_Thread, *cl_Lock, *cl_RLock;
+
+/* threads that have been started and have not yet finished. this keeps them reachable
+   for the GC, and allows waiting for them at exit */
+static __GC_VECTOR(Thread *) __active;
+static std::mutex __active_lock;
+static std::atomic<__ss_int> __counter;
+
+static Thread *__main;
+static thread_local Thread *__current;
+
+static __ss_int __thread_ident(std::thread::id id) {
+    return (__ss_int)std::hash<std::thread::id>()(id);
+}
+
+static void __bootstrap(Thread *t) {
+#ifndef __SS_ARENA
+    struct GC_stack_base sb;
+    GC_get_stack_base(&sb);
+    GC_register_my_thread(&sb);
+#endif
+
+    __current = t;
+
+    try {
+        t->run();
+
+    } catch (SystemExit *) {
+
+    } catch (BaseException *e) {
+        str *s = __str(e);
+        print_(0, False, __ss_stderr, NULL, NULL, __add_strs(3, new str("Exception in thread "), t->name, new str(":")));
+        if(___bool(s))
+            print_(0, False, __ss_stderr, NULL, NULL, __add_strs(3, e->__class__->__name__, new str(": "), s));
+        else
+            print_(0, False, __ss_stderr, NULL, NULL, e->__class__->__name__);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(__active_lock);
+        __active.erase(std::find(__active.begin(), __active.end(), t));
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(t->mutex);
+        t->finished = true;
+    }
+    t->done.notify_all();
+
+#ifndef __SS_ARENA
+    GC_unregister_my_thread();
+#endif
+}
+
+/* wait for non-daemon threads at exit, as python does */
+static void __shutdown() {
+    while(true) {
+        Thread *t = NULL;
+        {
+            std::lock_guard<std::mutex> guard(__active_lock);
+            for(Thread *u : __active)
+                if(!u->daemon && u != __current) {
+                    t = u;
+                    break;
+                }
+        }
+        if(!t)
+            break;
+        t->join(-1);
+    }
+}
+
+/* class Thread */
+
+void *Thread::__init__(void *, str *name, __ss_bool daemon) {
+    if(name)
+        this->name = name;
+    else
+        this->name = __add_strs(2, new str("Thread-"), __str(++__counter));
+    this->daemon = daemon;
+    ident = 0;
+    started = finished = false;
+    return NULL;
+}
+
+void *Thread::start() {
+    if(started)
+        throw new RuntimeError(new str("threads can only be started once"));
+    started = true;
+
+    {
+        std::lock_guard<std::mutex> guard(__active_lock);
+#ifdef __SS_ARENA
+        __ss_arena_keep keep; /* (the list outlives gc.arena_reset) */
+#endif
+        __active.push_back(this);
+    }
+
+    /* join() waits for the finished flag, so the native thread is detached right away:
+       a daemon thread, or one that is never joined, cannot terminate the program */
+    std::thread handle(__bootstrap, this);
+    ident = __thread_ident(handle.get_id());
+    handle.detach();
+
+    return NULL;
+}
+
+void *Thread::run() {
+    if(target)
+        target();
+    return NULL;
+}
+
+void *Thread::join(__ss_float timeout) {
+    if(!started)
+        throw new RuntimeError(new str("cannot join thread before it is started"));
+    if(this == __current)
+        throw new RuntimeError(new str("cannot join current thread"));
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if(timeout < 0)
+        done.wait(lock, [this] { return finished; });
+    else
+        done.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return finished; });
+
+    return NULL;
+}
+
+__ss_bool Thread::is_alive() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return __mbool(started && !finished);
+}
+
+str *Thread::__repr__() {
+    const char *state = !started ? "initial" : (is_alive() ? "started" : "stopped");
+    return __add_strs(5, new str("<Thread("), name, new str(", "), new str(state), new str(")>"));
+}
+
+/* class Lock */
+
+__ss_bool Lock::acquire(__ss_bool blocking, __ss_float timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if(is_locked) {
+        if(!blocking)
+            return False;
+        if(timeout < 0)
+            released.wait(lock, [this] { return !is_locked; });
+        else if(!released.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return !is_locked; }))
+            return False;
+    }
+    is_locked = true;
+    return True;
+}
+
+void *Lock::release() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if(!is_locked)
+            throw new RuntimeError(new str("release unlocked lock"));
+        is_locked = false;
+    }
+    released.notify_one();
+    return NULL;
+}
+
+__ss_bool Lock::locked() {
+    std::lock_guard<std::mutex> guard(mutex);
+    return __mbool(is_locked);
+}
+
+void Lock::__enter__() {
+    acquire();
+}
+
+void Lock::__exit__() {
+    release();
+}
+
+/* class RLock */
+
+__ss_bool RLock::acquire(__ss_bool blocking, __ss_float timeout) {
+    std::thread::id me = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(mutex);
+    if(count && owner == me) {
+        count++;
+        return True;
+    }
+    if(count) {
+        if(!blocking)
+            return False;
+        if(timeout < 0)
+            released.wait(lock, [this] { return count == 0; });
+        else if(!released.wait_for(lock, std::chrono::duration<double>(timeout), [this] { return count == 0; }))
+            return False;
+    }
+    owner = me;
+    count = 1;
+    return True;
+}
+
+void *RLock::release() {
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+        if(!count || owner != std::this_thread::get_id())
+            throw new RuntimeError(new str("cannot release un-acquired lock"));
+        if(--count)
+            return NULL;
+    }
+    released.notify_one();
+    return NULL;
+}
+
+void RLock::__enter__() {
+    acquire();
+}
+
+void RLock::__exit__() {
+    release();
+}
+
+/* module functions */
+
+Thread *current_thread() {
+    return __current;
+}
+
+Thread *main_thread() {
+    return __main;
+}
+
+__ss_int get_ident() {
+    return __thread_ident(std::this_thread::get_id());
+}
+
+__ss_int active_count() {
+    std::lock_guard<std::mutex> guard(__active_lock);
+    return (__ss_int)__active.size() + 1;
+}
+
+void __init() {
+    __name__ = new str("threading");
+
+    cl_Thread = new class_("Thread");
+    cl_Lock = new class_("Lock");
+    cl_RLock = new class_("RLock");
+
+    __main = new Thread(NULL, new str("MainThread"));
+    __main->started = true;
+    __main->ident = get_ident();
+    __current = __main;
+
+    std::atexit(__shutdown);
+}
+
+} // module namespace
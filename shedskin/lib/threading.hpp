@@ -0,0 +1,103 @@
+/* Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE) */
+
+#ifndef __THREADING_HPP
+#define __THREADING_HPP
+
+#ifndef __SS_THREADS
+#error "the threading module requires a runtime compiled with -D__SS_THREADS"
+#endif
+
+#include "builtin.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace __shedskin__;
+namespace __threading__ {
+
+/* there is no GIL, so threads run compiled code in parallel. builtin containers are
+   not synchronized: shared mutable state should be protected using a Lock */
+
+extern str *__name__;
+
+extern class_ *cl_Thread, *cl_Lock, *cl_RLock;
+
+class Thread : public pyobj {
+public:
+    str *name;
+    __ss_int ident;
+    __ss_bool daemon;
+
+    std::function<void()> target;
+    std::mutex mutex;
+    std::condition_variable done;
+    bool started, finished;
+
+    Thread() {}
+    Thread(void *target, str *name=0, __ss_bool daemon=False) {
+        this->__class__ = cl_Thread;
+        __init__(target, name, daemon);
+    }
+    template<class F> Thread(F *target, str *name=0, __ss_bool daemon=False) {
+        this->__class__ = cl_Thread;
+        __init__(target, name, daemon);
+    }
+
+    void *__init__(void *target, str *name, __ss_bool daemon);
+    template<class F> void *__init__(F *target, str *name, __ss_bool daemon) {
+        __init__((void *)NULL, name, daemon);
+        this->target = [target]() { target(); };
+        return NULL;
+    }
+
+    void *start();
+    virtual void *run();
+    void *join(__ss_float timeout=-1);
+    __ss_bool is_alive();
+
+    str *__repr__();
+};
+
+class Lock : public pyobj {
+public:
+    std::mutex mutex;
+    std::condition_variable released;
+    bool is_locked;
+
+    Lock() { this->__class__ = cl_Lock; is_locked = false; }
+
+    __ss_bool acquire(__ss_bool blocking=True, __ss_float timeout=-1);
+    void *release();
+    __ss_bool locked();
+
+    void __enter__();
+    void __exit__();
+};
+
+class RLock : public pyobj {
+public:
+    std::mutex mutex;
+    std::condition_variable released;
+    std::thread::id owner;
+    __ss_int count;
+
+    RLock() { this->__class__ = cl_RLock; count = 0; }
+
+    __ss_bool acquire(__ss_bool blocking=True, __ss_float timeout=-1);
+    void *release();
+
+    void __enter__();
+    void __exit__();
+};
+
+Thread *current_thread();
+Thread *main_thread();
+__ss_int get_ident();
+__ss_int active_count();
+
+void __init();
+
+} // module namespace
+#endif
@@ -0,0 +1,62 @@
+# Copyright 2005-2024 Mark Dufour and contributors; License Expat (See LICENSE)
+
+class Thread:
+    def __init__(self, target=None, name=None, daemon=False):
+        self.name = ''
+        self.ident = 0
+        self.daemon = False
+        target()
+        self.run()
+
+    def start(self):
+        self.run()
+
+    def run(self):
+        pass
+
+    def join(self, timeout=-1.0):
+        pass
+
+    def is_alive(self):
+        return False
+
+class Lock:
+    def acquire(self, blocking=True, timeout=-1.0):
+        return True
+
+    def release(self):
+        pass
+
+    def locked(self):
+        return False
+
+    def __enter__(self):
+        pass
+
+    def __exit__(self):
+        pass
+
+class RLock:
+    def acquire(self, blocking=True, timeout=-1.0):
+        return True
+
+    def release(self):
+        pass
+
+    def __enter__(self):
+        pass
+
+    def __exit__(self):
+        pass
+
+def current_thread():
+    return Thread()
+
+def main_thread():
+    return Thread()
+
+def get_ident():
+    return 0
+
+def active_count():
+    return 0
@@ -82,7 +82,7 @@ tm* tuple2tm(struct_time* tuple) {
     time_tuple->tm_mday = tuple->tm_mday;
     time_tuple->tm_mon = tuple->tm_mon - 1;
     time_tuple->tm_year = tuple->tm_year - 1900;
-    time_tuple->tm_wday = tuple->tm_wday == 6 ? 0 : tuple->tm_wday + 1;
+    time_tuple->tm_wday = tuple->tm_wday == 6 ? (__ss_int)0 : tuple->tm_wday + 1;
     time_tuple->tm_yday = tuple->tm_yday - 1 ;
     time_tuple->tm_isdst = tuple->tm_isdst;
 
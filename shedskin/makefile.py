@@ -134,6 +134,8 @@ def generate_makefile(gx: 'config.GlobalInfo') -> None:
                 line += " -D__SS_INT64"
             if gx.int128:
                 line += " -D__SS_INT128"
+            if gx.bigint:
+                line += " -D__SS_BIGINT"
             if gx.float32:
                 line += " -D__SS_FLOAT32"
             if gx.float64:
@@ -142,6 +144,12 @@ def generate_makefile(gx: 'config.GlobalInfo') -> None:
                 line += " -D__SS_BACKTRACE -rdynamic -fno-inline"
             if gx.nogc:
                 line += " -D__SS_NOGC"
+            if gx.arena:
+                line += " -D__SS_ARENA"
+            if gx.profile:
+                line += " -D__SS_PROFILE"
+            if gx.nogil or "threading" in [m.ident for m in modules]:
+                line += " -D__SS_THREADS -pthread"
             if gx.pyextension_product:
                 if sys.platform == "win32":
                     line += " -I%s\\include -D__SS_BIND" % prefix
@@ -164,7 +172,9 @@ def generate_makefile(gx: 'config.GlobalInfo') -> None:
                     line += " -Wno-register -shared -Xlinker -export-dynamic " + ldflags
 
             if "re" in [m.ident for m in modules]:
-                line += " -lpcre"
+                line += " -lpcre2-8"
+            if gx.nogil or "threading" in [m.ident for m in modules]:
+                line += " -pthread"
             if "socket" in (m.ident for m in modules):
                 if sys.platform == "win32":
                     line += " -lws2_32"
@@ -193,7 +203,7 @@ def generate_makefile(gx: 'config.GlobalInfo') -> None:
         write("GC_STATIC=$(STATIC_LIBDIR)/libgc.a")
         write("GCCPP_STATIC=$(STATIC_LIBDIR)/libgccpp.a")
         write("GC_INCLUDE=$(STATIC_INCLUDE)/include")
-        write("PCRE_STATIC=$(STATIC_LIBDIR)/libpcre.a")
+        write("PCRE_STATIC=$(STATIC_LIBDIR)/libpcre2-8.a")
         write("PCRE_INCLUDE=$(STATIC_INCLUDE)/include")
         write()
         write("STATIC_LIBS=$(GC_STATIC) $(GCCPP_STATIC) $(PCRE_STATIC)")
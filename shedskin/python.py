@@ -284,6 +284,7 @@ class Variable:
         self.looper: Optional[ast.AST] = None
         self.wopper: Optional[ast.AST] = None
         self.const_assign: List[ast.Constant] = []
+        self.struct_assign: List[ast.AST] = []  # formats of struct.Struct(..) assignments
 
     def masks_global(self) -> bool:
         if isinstance(self.parent, Class):
@@ -29,6 +29,7 @@ function(add_shedskin_product)
         NAME
         MAIN_MODULE
         EXTRA_LIB_DIR
+        EXTENSION_TEST
     )
     set(multiValueArgs
         SYS_MODULES
@@ -108,11 +109,8 @@ function(add_shedskin_product)
         endforeach()
     endif()
 
-    if(SHEDSKIN_CMDLINE_OPTIONS)
-        join(${SHEDSKIN_CMDLINE_OPTIONS} " " opts)
-    else()
-        set(opts)
-    endif()
+    # (a list, so that each option is passed as a separate argument)
+    set(opts ${SHEDSKIN_CMDLINE_OPTIONS})
 
     if(SIMPLE_PROJECT)
         set(PROJECT_EXE_DIR ${PROJECT_BINARY_DIR}/exe)
@@ -125,6 +123,7 @@ function(add_shedskin_product)
     # module-specific cases
     set(IMPORTS_OS_MODULE OFF)
     set(IMPORTS_RE_MODULE OFF)
+    set(IMPORTS_THREADING_MODULE OFF)
 
     # if ${name} starts_with test_ then set IS_TEST to ON
     string(FIND "${name}" "test_" index)
@@ -197,12 +196,19 @@ function(add_shedskin_product)
         else()
             if(mod STREQUAL "re")
                 set(IMPORTS_RE_MODULE ON)
+            elseif(mod STREQUAL "threading")
+                set(IMPORTS_THREADING_MODULE ON)
             endif()
             list(APPEND sys_module_list "${SHEDSKIN_LIB}/${mod}.cpp")
             list(APPEND sys_module_list "${SHEDSKIN_LIB}/${mod}.hpp")
         endif()
     endforeach()
 
+    # --nogil needs the thread-safe runtime, as does the threading module
+    if("--nogil" IN_LIST SHEDSKIN_CMDLINE_OPTIONS)
+        set(IMPORTS_THREADING_MODULE ON)
+    endif()
+
     # special case win32: if none of the dep mgrs is enabled then default to conan
     # if(WIN32 AND NOT ENABLE_EXTERNAL_PROJECT AND NOT ENABLE_SPM AND NOT ENABLE_CONAN)
     #     set(ENABLE_CONAN ON)
@@ -211,11 +217,11 @@ function(add_shedskin_product)
     if (UNIX)
         set(LIBGC libgc.a)
         set(LIBGCCPP libgccpp.a)
-        set(LIBGPCRE libpcre.a)
+        set(LIBPCRE libpcre2-8.a)
     else() # i.e windows
         set(LIBGCa gc.lib)
         set(LIBGCCPP gccpp.lib)
-        set(LIBPCRE pcre.lib)
+        set(LIBPCRE pcre2-8-static.lib)
     endif ()
 
     if(ENABLE_EXTERNAL_PROJECT)
@@ -240,16 +246,16 @@ function(add_shedskin_product)
         set(LIB_DEPS
             BDWgc::gc
             BDWgc::gccpp
-            $<$<BOOL:${IMPORTS_RE_MODULE}>:PCRE::PCRE>
+            $<$<BOOL:${IMPORTS_RE_MODULE}>:PCRE2::PCRE2>
         )
         set(LIB_DIRS
             ${BDWgc_LIB_DIRS}
-            $<$<BOOL:${IMPORTS_RE_MODULE}>:${PCRE_LIB_DIRS}>
+            $<$<BOOL:${IMPORTS_RE_MODULE}>:${PCRE2_LIB_DIRS}>
         )
-        # include PCRE headers irrespective (even if not used) to prevent header not found error
+        # include PCRE2 headers irrespective (even if not used) to prevent header not found error
         set(LIB_INCLUDES
             ${BDWgc_INCLUDE_DIRS}
-            ${PCRE_INCLUDE_DIRS}
+            ${PCRE2_INCLUDE_DIRS}
         )
     else()
         # adding -lutil for every use of os is not a good idea should only be temporary
@@ -272,7 +278,7 @@ function(add_shedskin_product)
         set(LIB_DEPS
             "-lgc"
             "-lgccpp"
-            "$<$<BOOL:${IMPORTS_RE_MODULE}>:-lpcre>"
+            "$<$<BOOL:${IMPORTS_RE_MODULE}>:-lpcre2-8>"
             # "$<$<BOOL:${IMPORTS_OS_MODULE}>:-lutil>"
             ${SHEDSKIN_LINK_LIBS}
         )
@@ -365,6 +371,8 @@ function(add_shedskin_product)
             $<$<BOOL:${UNIX}>:-Wno-unused-result>
             $<$<BOOL:${UNIX}>:-Wno-missing-field-initializers>
             $<$<BOOL:${UNIX}>:-Wno-cast-function-type> # (PyCFunction) cast in extmods
+            $<$<BOOL:${IMPORTS_THREADING_MODULE}>:-D__SS_THREADS>
+            $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${IMPORTS_THREADING_MODULE}>>:-pthread>
             $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${ENABLE_WARNINGS}>>:-Wall>
             $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${ENABLE_WARNINGS}>>:-Wextra>
             $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${ENABLE_WARNINGS}>>:-Wpedantic>
@@ -394,6 +402,7 @@ function(add_shedskin_product)
 
         target_link_options(${EXE} PRIVATE
             ${SHEDSKIN_LINK_OPTIONS}
+            $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${IMPORTS_THREADING_MODULE}>>:-pthread>
             "$<$<BOOL:${APPLE}>:-Wl,-ld_classic>"
         )
 
@@ -506,6 +515,8 @@ function(add_shedskin_product)
             $<$<BOOL:${UNIX}>:-Wno-unused-but-set-variable>
             $<$<BOOL:${UNIX}>:-Wno-missing-field-initializers>
             $<$<BOOL:${UNIX}>:-Wno-cast-function-type> # (PyCFunction) cast in extmods
+            $<$<BOOL:${IMPORTS_THREADING_MODULE}>:-D__SS_THREADS>
+            $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${IMPORTS_THREADING_MODULE}>>:-pthread>
             $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${ENABLE_WARNINGS}>>:-Wall>
             $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${ENABLE_WARNINGS}>>:-Wextra>
             $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${ENABLE_WARNINGS}>>:-Wconversion>
@@ -524,6 +535,7 @@ function(add_shedskin_product)
             # "-fno-common" # can be excluded because it is already the default
             "-dynamic" # can be excluded because it is already the default
             ${SHEDSKIN_LINK_OPTIONS}
+            $<$<AND:$<BOOL:${UNIX}>,$<BOOL:${IMPORTS_THREADING_MODULE}>>:-pthread>
             "$<$<BOOL:${APPLE}>:-Wl,-ld_classic>"
         )
 
@@ -537,15 +549,22 @@ function(add_shedskin_product)
             $<$<BOOL:${WIN32}>:${Python_LIBRARY_DIRS}>
         )
 
+        # a test may instead provide a python script, run against the extension module
+        if(SHEDSKIN_EXTENSION_TEST)
+            set(ext_test_code "import runpy; runpy.run_path('${CMAKE_CURRENT_SOURCE_DIR}/${SHEDSKIN_EXTENSION_TEST}', run_name='__main__')")
+        else()
+            set(ext_test_code "from ${name} import test_all; test_all()")
+        endif()
+
         if(BUILD_TEST AND IS_TEST)
             if(${WIN32})
                 add_test(NAME ${EXT}
-                    COMMAND ${Python_EXECUTABLE} -c "from ${name} import test_all; test_all()"
+                    COMMAND ${Python_EXECUTABLE} -c "${ext_test_code}"
 			        WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/${CMAKE_BUILD_TYPE}
                 )
 	    else()
 		    add_test(NAME ${EXT}
-                COMMAND ${Python_EXECUTABLE} -c "from ${name} import test_all; test_all()"
+                COMMAND ${Python_EXECUTABLE} -c "${ext_test_code}"
 		    )
 	    endif()
         endif()
@@ -374,6 +374,7 @@ def typestrnew(
             ]
         )
         and not (cl.mv.module.ident == "collections" and cl.ident == "defaultdict")
+        and not (cl.mv.module.ident == "array" and cl.ident == "array")
     ):
         raise ExtmodError()
 
@@ -0,0 +1,13 @@
+import struct
+
+class Reader:
+    def __init__(self):
+        self.s = struct.Struct('<ih')
+
+    def read(self, buf):
+        a, b = self.s.unpack(buf)
+        return a + b
+
+print(Reader().read(b'\x01\x00\x00\x00\x02\x00'))
+
+#*ERROR* 48.py:8: unsupported use of Struct.unpack
@@ -0,0 +1,9 @@
+import struct
+
+s = struct.Struct('<ih')
+a, b = s.unpack(b'\x01\x00\x00\x00\x02\x00')
+s = struct.Struct('<hi')
+c, d = s.unpack(b'\x02\x00\x01\x00\x00\x00')
+print(a, b, c, d)
+
+#*ERROR* 49.py:6: 's' is assigned more than one struct.Struct
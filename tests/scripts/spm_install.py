@@ -9,7 +9,7 @@ shedskin
             src
                 bdwgc
                     build
-                pcre
+                pcre2-10.42
                     build
 """
 import os
@@ -70,9 +70,9 @@ class ShedskinPackageManager:
     def targets_exist(self):
         libgc = self.lib_dir / f'libgc{self.lib_suffix}'
         libgccpp = self.lib_dir / f'libgccpp{self.lib_suffix}'
-        libpcre = self.lib_dir / f'libgccpp{self.lib_suffix}'
+        libpcre = self.lib_dir / f'libpcre2-8{self.lib_suffix}'
         gc_h = self.include_dir / 'gc.h'
-        pcre_h = self.include_dir / 'pcre.h'
+        pcre_h = self.include_dir / 'pcre2.h'
  
         targets = [libgc, libgccpp, libpcre, gc_h, pcre_h]
         return all(t.exists() for t in targets)
@@ -105,27 +105,27 @@ class ShedskinPackageManager:
         cmake_install(bdwgc_build)
 
     def install_pcre(self):
-        """download / build / install pcre"""
-        pcre_url = 'https://sourceforge.net/projects/pcre/files/pcre/8.45/pcre-8.45.tar.gz'
-        pcre_archive = self.downloads_dir / 'pcre-8.45.tar.gz'
-        pcre_src = self.src_dir / 'pcre-8.45'
+        """download / build / install pcre2"""
+        pcre_url = 'https://github.com/PCRE2Project/pcre2/releases/download/pcre2-10.42/pcre2-10.42.tar.gz'
+        pcre_archive = self.downloads_dir / 'pcre2-10.42.tar.gz'
+        pcre_src = self.src_dir / 'pcre2-10.42'
         pcre_build = pcre_src / 'build'
 
-        print("download / build / install pcre")
+        print("download / build / install pcre2")
         wget(pcre_url, self.downloads_dir)
         tar(pcre_archive, self.src_dir)
         # pcre_archive.unlink()
         pcre_build.mkdir(parents=True, exist_ok=True)
         cmake_generate(pcre_src, pcre_build, prefix=self.deps_dir,
             BUILD_SHARED_LIBS=False,
-            PCRE_BUILD_PCREGREP=False,
-            PCRE_BUILD_PCRECPP=True,
-            PCRE_SUPPORT_LIBREADLINE=False,
-            PCRE_SUPPORT_LIBEDIT=False,
-            PCRE_SUPPORT_LIBZ=False,
-            PCRE_SUPPORT_LIBBZ2=False,
-            PCRE_BUILD_TESTS=False,
-            PCRE_SHOW_REPORT=False,
+            PCRE2_SUPPORT_JIT=True,
+            PCRE2_BUILD_PCRE2GREP=False,
+            PCRE2_SUPPORT_LIBREADLINE=False,
+            PCRE2_SUPPORT_LIBEDIT=False,
+            PCRE2_SUPPORT_LIBZ=False,
+            PCRE2_SUPPORT_LIBBZ2=False,
+            PCRE2_BUILD_TESTS=False,
+            PCRE2_SHOW_REPORT=False,
         )
         cmake_build(pcre_build)
         cmake_install(pcre_build)
@@ -0,0 +1,63 @@
+"""exit status of 'shedskin bench' (BenchRunner), without building anything: the
+build and run steps of the examples are replaced
+
+run with: pytest tests/scripts/test_bench_runner.py
+"""
+
+import argparse
+import json
+import os
+import pathlib
+import sys
+
+import pytest
+
+sys.path.insert(0, str(pathlib.Path(__file__).resolve().parents[2]))
+
+from shedskin import cmake
+
+
+def make_runner(tmp_path, monkeypatch, build_ok=True, run_ok=True, wall_time=1.0, update=False):
+    monkeypatch.chdir(tmp_path)
+    (tmp_path / "CMakeLists.txt").write_text("add_subdirectory(hello)\n")
+    options = argparse.Namespace(
+        include=None, repeat=2, timeout=10, baseline="bench.json", threshold=10,
+        update=update, generator=None, jobs=None, build_type="Release", reset=False,
+        conan=False, spm=False, extproject=False,
+    )
+    runner = cmake.BenchRunner(options)
+    monkeypatch.setattr(runner, "cmake_config", lambda options: None)
+    monkeypatch.setattr(runner, "cmake_build", lambda options: None)
+    monkeypatch.setattr(runner, "compile", lambda name: 1.0 if build_ok else None)
+    monkeypatch.setattr(runner, "get_executable", lambda name: tmp_path / name if build_ok else None)
+    run = {"wall_time": wall_time, "max_rss": None, "gc": None}
+    monkeypatch.setattr(runner, "execute", lambda name, executable: dict(run) if run_ok else None)
+    return runner
+
+
+def exit_status(runner):
+    try:
+        runner.run_benchmarks()
+    except SystemExit as e:
+        return e.code
+    return 0
+
+
+def test_success(tmp_path, monkeypatch):
+    assert exit_status(make_runner(tmp_path, monkeypatch)) == 0
+    assert "hello" in json.loads((tmp_path / "bench.json").read_text())["examples"]
+
+
+def test_build_failure(tmp_path, monkeypatch):
+    assert exit_status(make_runner(tmp_path, monkeypatch, build_ok=False)) != 0
+
+
+def test_run_failure(tmp_path, monkeypatch):
+    assert exit_status(make_runner(tmp_path, monkeypatch, run_ok=False)) != 0
+    assert exit_status(make_runner(tmp_path, monkeypatch, run_ok=False, update=True)) != 0
+
+
+def test_regression(tmp_path, monkeypatch):
+    assert exit_status(make_runner(tmp_path, monkeypatch, wall_time=1.0)) == 0
+    assert exit_status(make_runner(tmp_path, monkeypatch, wall_time=2.0)) != 0
+    assert exit_status(make_runner(tmp_path, monkeypatch, wall_time=2.0, update=True)) == 0
@@ -0,0 +1,75 @@
+"""checks on the C++ code generated for some of the tests, for options whose effect
+is not visible in the program output
+
+run with: pytest tests/scripts/test_codegen.py
+"""
+
+import os
+import pathlib
+import re
+import subprocess
+import sys
+
+ROOT = pathlib.Path(__file__).resolve().parents[2]
+TESTS = ROOT / "tests"
+
+
+def translate(tmp_path, test, *options):
+    """translate tests/<test>/<test>.py with the given options, returning (hpp, cpp)"""
+    subprocess.run(
+        [sys.executable, "-m", "shedskin", "translate", "--nomakefile",
+         "-o", str(tmp_path), *options, f"{test}.py"],
+        cwd=TESTS / test, env=dict(os.environ, PYTHONPATH=str(ROOT)), check=True,
+        stdout=subprocess.DEVNULL,
+    )
+    return (tmp_path / f"{test}.hpp").read_text(), (tmp_path / f"{test}.cpp").read_text()
+
+
+def test_vtuples(tmp_path):
+    hpp, cpp = translate(tmp_path, "test_func_vtuples", "--vtuples")
+    assert "__vtuple<__ss_int, __ss_int> divmod2(__ss_int a, __ss_int b);" in hpp
+    assert "__vtuple<str *, __ss_int> sign(__ss_int n);" in hpp
+    assert "__vtuple<__ss_int, __ss_int, __ss_int> triple(__ss_int x);" in hpp
+    assert "std::tie(q, r) = divmod2(" in cpp
+
+    # the result of escapes() is also used as a tuple, so it stays allocated
+    assert "tuple<__ss_int> *escapes(__ss_int x);" in hpp
+
+    hpp, cpp = translate(tmp_path, "test_func_vtuples")
+    assert "__vtuple" not in hpp + cpp
+
+
+def test_gc_layout(tmp_path):
+    hpp, cpp = translate(tmp_path, "test_class_gc_layout")
+    assert "__SS_GC_TYPED(Point, member(&Point::y).member(&Point::x))" in hpp
+
+    # scalar members, own or inherited, are listed; pointer members are not
+    for cl in ("Node", "Labeled", "Measured"):
+        layout = next(line for line in hpp.splitlines() if f"__SS_GC_TYPED({cl}," in line)
+        for member in ("value", "weight", "flag", "size"):
+            assert f"member(&{cl}::{member})" in layout
+        for member in ("name", "next", "label", "points"):
+            assert f"::{member})" not in layout
+
+
+def test_escape(tmp_path):
+    hpp, cpp = translate(tmp_path, "test_class_escape")
+
+    def func(name):
+        start = re.search(rf"^\S.*[ *]{name}\(.*\) {{$", cpp, re.M).start()
+        return cpp[start:cpp.index("\n}\n", start)]
+
+    local = func("test_local")
+    for alloc in ("new (&__stack0) Vec(", "new (&__stack1) Vec(", "new (&__stack2) Vec3("):
+        assert alloc in local
+    assert "new (&__stack" in func("test_sequences")
+
+    # escaping objects, and objects built from the previous one, are allocated
+    escaping = func("test_escaping")
+    assert "new (&__stack" not in escaping
+    previous = func("fib")
+    assert "new (&__stack0) Seed(" in previous
+    assert "(new Fib(" in previous
+
+    hpp, cpp = translate(tmp_path, "test_class_escape", "--noescape")
+    assert "__stack" not in cpp
@@ -11,6 +11,11 @@ datafile = os.path.join(testdata, 'hoppa')
 outputfile = os.path.join(testdata, 'hoppa_write')
 
 
+def tempfile(name):
+    tmpdir = os.environ.get('TMPDIR', os.environ.get('TEMP', '/tmp'))
+    return os.path.join(tmpdir, 'shedskin_%s_%d' % (name, os.getpid()))
+
+
 def test_open_for():
     f = open(datafile)
     assert [l for l in f] == ['hop\n', 'hop\n', 'hoppa!\n']
@@ -59,6 +64,66 @@ def test_open_enter_exit():
     assert f.read() == 'hop\nhop\nhoppa!\n'
     f.__exit__()
 
+def test_open_buffering():
+    path = tempfile('buffering')
+    f = open(path, 'w')
+    f.write('a\r\nbb\rccc\r\r\ndddd\neeeee')
+    f.close()
+    for buffering in [-1, 1, 2, 3, 5]:
+        with open(path, 'r', buffering) as g:
+            assert list(g) == ['a\n', 'bb\n', 'ccc\n', '\n', 'dddd\n', 'eeeee']
+        with open(path, 'r', buffering) as g:
+            assert g.readline(1) == 'a'
+            assert g.readline() == '\n'
+            assert g.readline() == 'bb\n'
+            assert g.read(2) == 'cc'
+            assert g.tell() == 8
+    os.remove(path)
+
+def test_open_truncated():
+    # shrinking a file while it is read: shedskin maps read-only files, and raises OSError
+    # instead of crashing; python simply runs out of lines
+    path = tempfile('truncated')
+    f = open(path, 'w')
+    for i in range(20000):
+        f.write('line %05d\n' % i)
+    f.close()
+    lines = 0
+    with open(path) as g:
+        assert g.readline() == 'line 00000\n'
+        open(path, 'w').close()
+        try:
+            for line in g:
+                lines += 1
+        except OSError:
+            pass
+    assert lines < 19999
+    os.remove(path)
+
+def test_open_many_truncated():
+    # more open files than shedskin maps at once (the rest is read through a buffer)
+    path = tempfile('many')
+    f = open(path, 'w')
+    for i in range(20000):
+        f.write('line %05d\n' % i)
+    f.close()
+    files = []
+    for i in range(100):
+        g = open(path)
+        assert g.readline() == 'line 00000\n'
+        files.append(g)
+    open(path, 'w').close()
+    total = 0
+    for g in files:
+        try:
+            for line in g:
+                total += 1
+        except OSError:
+            pass
+        g.close()
+    assert total < 100 * 19999
+    os.remove(path)
+
 # def test_with_open_write():
 #     with open(outputfile, 'w') as f: # FIXME doesn't work
 #         f.write('hop\nhop\nhoppa!\n')
@@ -99,6 +164,9 @@ def test_all():
     # test_open_read2() # FIXME: fails
     test_open_readlines()
     test_with_open_read()
+    test_open_buffering()
+    test_open_truncated()
+    test_open_many_truncated()
     test_open_write()
     test_open_enter_exit()
     # test_lineendings()
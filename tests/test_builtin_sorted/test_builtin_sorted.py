@@ -52,6 +52,37 @@ def test_sorted3():
     c = ["b", "c", "aa"]
     assert list(sorted(c)) == ['aa', 'b', 'c']
 
+def test_sorted_stable():
+    events = [(3, 'a'), (1, 'b'), (3, 'c'), (2, 'd'), (1, 'e'), (3, 'f')]
+    assert sorted(events, key=lambda e: e[0]) == [(1, 'b'), (1, 'e'), (2, 'd'), (3, 'a'), (3, 'c'), (3, 'f')]
+    assert sorted(events, key=lambda e: e[0], reverse=True) == [(3, 'a'), (3, 'c'), (3, 'f'), (2, 'd'), (1, 'b'), (1, 'e')]
+    words = ['bb', 'a', 'ccc', 'dd', 'e']
+    words.sort(key=len)
+    assert words == ['a', 'e', 'bb', 'dd', 'ccc']
+
+calls = [0]
+
+def stamp(e):
+    calls[0] += 1
+    return e[0]
+
+def test_sorted_key_once():
+    events = [(i * 7 % 100, i) for i in range(1000)]
+    result = sorted(events, key=stamp)
+    assert calls[0] == 1000
+    assert result == sorted(events)
+
+def test_sorted_runs():
+    a = list(range(500)) + list(range(250))
+    a[100], a[101] = a[101], a[100]
+    assert sorted(a) == sorted(a, reverse=True)[::-1]
+    b = sorted(a)
+    assert all(b[i] <= b[i+1] for i in range(len(b)-1))
+    c = list(range(1000, 0, -1)) + list(range(1000))
+    assert sorted(c)[:4] == [0, 1, 1, 2]
+    assert sorted([2.5, -1.0, 3.25, 0.0]) == [-1.0, 0.0, 2.5, 3.25]
+    assert sorted(['b', 'ab', 'a', '', 'abc'], reverse=True) == ['b', 'abc', 'ab', 'a', '']
+
 def test_reversed():
     assert [z for z in reversed(range(10))] == [9, 8, 7, 6, 5, 4, 3, 2, 1, 0]
     assert list(reversed(['a','c','b'])) == ['b', 'c', 'a']
@@ -115,6 +146,9 @@ def test_all():
     test_sorted1()
     test_sorted2()
     test_sorted3()
+    test_sorted_stable()
+    test_sorted_key_once()
+    test_sorted_runs()
     test_reversed()
     # test_sort_dict()
 
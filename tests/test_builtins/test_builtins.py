@@ -182,6 +182,16 @@ def test_max():
     assert max(xs) == 3
     assert max(xs, key=neg) == 1
 
+    ys = [(i * 37) % 101 - 50 for i in range(101)]
+    assert max(ys) == 50
+    assert max(ys[:5]) == 24
+    assert max([0.5 * y for y in ys]) == 25.0
+
+    zs = [-1.0] * 16  # equal values: the first one
+    zs[1] = -0.0
+    zs[8] = 0.0
+    assert str(max(zs)) == '-0.0'
+
 
 def test_min():
     assert min([1]) == 1
@@ -205,6 +215,23 @@ def test_min():
     assert min(xs) == 1
     assert min(xs, key=neg) == 3
 
+    ys = [(i * 37) % 101 - 50 for i in range(101)]
+    assert min(ys) == -50
+    assert min(ys[:5]) == -50
+    assert min([0.5 * y for y in ys]) == -25.0
+
+    zs = [1.0] * 16  # equal values: the first one
+    zs[1] = 0.0
+    zs[8] = -0.0
+    assert str(min(zs)) == '0.0'
+
+    raised = False
+    try:
+        min([1.0][:0])
+    except ValueError:
+        raised = True
+    assert raised
+
 
 def test_oct():
     assert oct(10) == '0o12'
@@ -326,6 +353,9 @@ def test_sum():
     assert sum([1, 2, 3], 4) == 10
     assert sum([[1], [2], [3, 4]], [0]) == [0, 1, 2, 3, 4]
     assert sum([[1], [2], [3, 4]], []) == [1, 2, 3, 4]
+    assert sum(list(range(1001))) == 500500
+    assert sum(list(range(1001)), 5) == 500505
+    assert sum([0.25] * 1001) == 250.25
 
 
 def test_tuple():
@@ -17,6 +17,13 @@ def test_logic_all():
     assert not all(set([0, 1]))
     assert all({})
 
+    ones = [1] * 37
+    assert all(ones)
+    ones[35] = 0
+    assert not all(ones)
+    assert all([0.5] * 20)
+    assert not all([0.5] * 20 + [0.0])
+
 
 def test_logic_any():
     assert any([True, False, False])
@@ -26,6 +33,13 @@ def test_logic_any():
     assert not any([])
     assert any(set([1, 2]))
 
+    zeros = [0] * 37
+    assert not any(zeros)
+    zeros[35] = 3
+    assert any(zeros)
+    assert not any([0.0] * 20)
+    assert any([0.0] * 20 + [0.5])
+
 
 def test_and():
     assert 1 and 1
@@ -0,0 +1,129 @@
+# objects that do not escape are constructed in local storage
+
+
+class Vec:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+    def dot(self, other):
+        return self.x * other.x + self.y * other.y
+
+    def norm2(self):
+        return self.dot(self)
+
+    def __add__(self, other):
+        return Vec(self.x + other.x, self.y + other.y)
+
+    def __imul__(self, f):
+        self.x *= f
+        self.y *= f
+        return self
+
+    def me(self):
+        return self
+
+class Vec3(Vec):
+    def __init__(self, x, y, z):
+        Vec.__init__(self, x, y)
+        self.z = z
+
+class Fib:
+    def __init__(self, prev):
+        self.a = prev.b
+        self.b = prev.a + prev.b
+
+class Seed(Fib):
+    def __init__(self):
+        self.a = 0
+        self.b = 1
+
+class Node:
+    def __init__(self, value, next):
+        self.value = value
+        self.next = next
+
+kept = []
+kept_lists = []
+
+def length(v):
+    return (v.x * v.x + v.y * v.y) ** 0.5
+
+def keep(v):
+    kept.append(v)
+
+
+def test_local():
+    total = 0.0
+    for i in range(10):
+        a = Vec(i, 1.0)
+        b = Vec(1.0, i)
+        total += a.dot(b) + b.norm2() + length(a)
+        c = a + b
+        total += c.x
+        a *= 2.0
+        total += a.x
+        d = Vec3(i, i, i)
+        total += d.x + d.z
+    assert int(total) == 667
+
+def test_escaping():
+    last = None
+    for i in range(5):
+        a = Vec(i, i)
+        keep(a)
+        b = Vec(i, 0)
+        c = b.me()
+        n = Node(i, last)
+        last = n
+    assert [v.x for v in kept] == [0, 1, 2, 3, 4]
+    total = 0
+    while last:
+        total += last.value
+        last = last.next
+    assert total == 10
+
+def test_sequences():
+    total = 0
+    for i in range(5):
+        t = (i, i * 2)
+        a, b = t
+        total += a + b + t[1] + len(t)
+        l = [1, 2, i]
+        l.append(i)
+        for x in l:
+            total += x
+        if 3 in l:
+            total += 100
+        m = [i]
+        kept_lists.append(m)
+    assert total == 195
+    assert kept_lists == [[0], [1], [2], [3], [4]]
+
+def test_rebind_in_loop():
+    l = [1, 2, 3]
+    total = 0
+    for x in l:
+        l = [x * 10]
+        total += l[0]
+    assert total == 60
+
+def fib(n):  # each new object is built from the previous one
+    s = Seed()
+    for i in range(n):
+        s = Fib(s)
+    return s.b
+
+def test_previous_as_argument():
+    assert fib(10) == 89
+
+
+def test_all():
+    test_local()
+    test_escaping()
+    test_sequences()
+    test_rebind_in_loop()
+    test_previous_as_argument()
+
+if __name__ == '__main__':
+    test_all()
@@ -0,0 +1,77 @@
+# classes with int/float members are allocated with a precise GC layout: their
+# pointer members must still keep other objects alive across collections
+import gc
+
+
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+class Node:
+    def __init__(self, value, weight, next):
+        self.value = value
+        self.name = 'node%d' % value
+        self.weight = weight
+        self.next = next
+        self.flag = value % 2 == 0
+
+class Labeled(Node):  # inherits a layout, adds a pointer member
+    def __init__(self, value, weight, next, label):
+        Node.__init__(self, value, weight, next)
+        self.label = label
+
+class Measured(Node):  # adds scalar members of its own
+    def __init__(self, value, weight, next, size):
+        Node.__init__(self, value, weight, next)
+        self.size = size
+        self.points = [Point(size, -size)]
+
+def build(n):
+    head = None
+    for i in range(n):
+        if i % 3 == 0:
+            head = Labeled(i, i * 0.5, head, 'label%d' % i)
+        elif i % 3 == 1:
+            head = Measured(i, i * 0.5, head, i * 2)
+        else:
+            head = Node(i, i * 0.5, head)
+    return head
+
+def check(head, n):
+    i = n - 1
+    while head is not None:
+        assert head.value == i
+        assert head.name == 'node%d' % i
+        assert head.weight == i * 0.5
+        assert head.flag == (i % 2 == 0)
+        if i % 3 == 0:
+            assert head.label == 'label%d' % i
+        elif i % 3 == 1:
+            assert head.size == i * 2
+            assert head.points[0].x == i * 2 and head.points[0].y == -i * 2
+        head = head.next
+        i -= 1
+    assert i == -1
+
+
+def test_layout():
+    n = 20000
+    head = build(n)
+    for i in range(5):
+        garbage = [Point(j, j + 0.5) for j in range(10000)]
+        gc.collect()
+        check(head, n)
+    assert garbage[-1].y == 9999.5
+
+    points = [Point(i, float(i)) for i in range(1000)]
+    gc.collect()
+    assert sum([p.x for p in points]) == 499500
+    assert sum([p.y for p in points]) == 499500.0
+
+
+def test_all():
+    test_layout()
+
+if __name__ == '__main__':
+    test_all()
@@ -0,0 +1,32 @@
+# run against the extension module: compiled arrays come back as memoryviews over their
+# storage, and python buffers are accepted as arrays
+
+from array import array
+
+import test_extmod_buffer as m
+
+# no resizing while a view exists
+v = memoryview(m.keep(4))
+assert v.tolist() == [0.0, 0.5, 1.0, 1.5]
+v[0] = 2.0
+try:
+    m.grow()
+    assert False
+except BufferError:
+    pass
+v.release()
+assert m.first() == 2.0  # (no copy)
+assert m.grow() == 5
+
+# python buffers passed in
+assert m.total(array('d', [1.0, 2.0, 3.0])) == 6.0
+assert m.total(memoryview(array('d', [1.5]))) == 1.5
+
+# views keep their (otherwise unreferenced) arrays alive
+views = [memoryview(m.make(1000)) for i in range(20)]
+m.churn(200000)
+for v in views:
+    assert len(v) == 1000 and v[999] == 499.5
+del views
+
+m.test_all()
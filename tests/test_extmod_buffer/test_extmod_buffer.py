@@ -0,0 +1,61 @@
+# arrays exchanged with python through the buffer protocol. ext_buffer.py holds memoryviews
+# of compiled arrays: resizing them then raises BufferError, and the views keep them alive
+
+from array import array
+
+kept = [array('d')]
+
+
+def make(n):
+    return array('d', [i * 0.5 for i in range(n)])
+
+
+def keep(n):
+    kept[0] = make(n)
+    return kept[0]
+
+
+def grow():
+    kept[0].append(1.0)
+    return len(kept[0])
+
+
+def first():
+    return kept[0][0]
+
+
+def total(a):
+    s = 0.0
+    for x in a:
+        s += x
+    return s
+
+
+def churn(n):
+    count = 0
+    for i in range(n):
+        count += len([i] * 10)
+    return count
+
+
+def test_make():
+    a = make(4)
+    assert a.tolist() == [0.0, 0.5, 1.0, 1.5]
+    assert total(a) == 3.0
+
+
+def test_grow():
+    keep(3)
+    assert grow() == 4
+    assert first() == 0.0
+    assert kept[0].tolist() == [0.0, 0.5, 1.0, 1.0]
+
+
+def test_all():
+    test_make()
+    test_grow()
+    assert churn(1000) == 10000
+
+
+if __name__ == '__main__':
+    test_all()
@@ -0,0 +1,29 @@
+# run against the extension module: construct objects and use their attributes from several
+# python threads at once (each thread calls into compiled code with the GIL released)
+
+import threading
+
+import test_extmod_nogil as m
+
+N = 500
+results = {}
+
+
+def run(k):
+    s = 0
+    for i in range(N):
+        p = m.Point(i, k)
+        p.x = p.x + 1
+        s += p.moved(1).norm2() - p.y
+    results[k] = s + m.total(m.make_points(10, k))
+    assert m.work(k, N) == results[k]
+
+
+threads = [threading.Thread(target=run, args=(k,)) for k in range(8)]
+for t in threads:
+    t.start()
+for t in threads:
+    t.join()
+
+assert results == {k: m.expected(k, N) for k in range(8)}
+m.test_all()
@@ -0,0 +1,65 @@
+# objects created and used through the extension module, with the GIL released (--nogil).
+# ext_threads.py calls into the module from several python threads
+
+
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+    def norm2(self):
+        return self.x * self.x + self.y * self.y
+
+    def moved(self, dx):
+        return Point(self.x + dx, self.y)
+
+
+def make_points(n, y):
+    return [Point(i, y) for i in range(n)]
+
+
+def total(points):
+    s = 0
+    for p in points:
+        s += p.norm2()
+    return s
+
+
+def work(k, n):
+    s = 0
+    for i in range(n):
+        p = Point(i, k)
+        p.x = p.x + 1
+        s += p.moved(1).norm2() - p.y
+    return s + total(make_points(10, k))
+
+
+def expected(k, n):
+    s = 0
+    for i in range(n):
+        s += (i + 2) * (i + 2) + k * k - k
+    for i in range(10):
+        s += i * i + k * k
+    return s
+
+
+def test_point():
+    p = Point(3, 4)
+    assert p.norm2() == 25
+    q = p.moved(2)
+    assert (q.x, q.y) == (5, 4)
+    assert total(make_points(3, 1)) == 8
+
+
+def test_work():
+    for k in range(4):
+        assert work(k, 100) == expected(k, 100)
+
+
+def test_all():
+    test_point()
+    test_work()
+
+
+if __name__ == '__main__':
+    test_all()
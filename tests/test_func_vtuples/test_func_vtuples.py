@@ -0,0 +1,67 @@
+# tuples returned by value with --vtuples
+
+
+def divmod2(a, b):
+    return a // b, a % b
+
+def minmax(l):
+    lo, hi = l[0], l[0]
+    for x in l:
+        if x < lo:
+            lo = x
+        if x > hi:
+            hi = x
+    return lo, hi
+
+def sign(n):
+    if n >= 0:
+        return 'pos', n
+    return 'neg', -n
+
+def triple(x):
+    return x, x * 2, x * 3
+
+def escapes(x):
+    return x, x + 1
+
+
+def test_unpack():
+    q, r = divmod2(17, 5)
+    assert q == 3 and r == 2
+
+    total = 0
+    for i in range(1, 10):
+        q, r = divmod2(100, i)
+        total += q + r
+    assert total == 293
+
+def test_unpack_list():
+    lo, hi = minmax([3, 1, 4, 1, 5, 9, 2, 6])
+    assert lo == 1 and hi == 9
+
+def test_mixed_types():
+    s, m = sign(-4)
+    assert s == 'neg' and m == 4
+    s, m = sign(4)
+    assert s == 'pos' and m == 4
+
+def test_arity():
+    a, b, c = triple(7)
+    assert (a, b, c) == (7, 14, 21)
+
+def test_escaping():
+    t = escapes(1)
+    assert t == (1, 2)
+    u, v = escapes(3)
+    assert u == 3 and v == 4
+
+
+def test_all():
+    test_unpack()
+    test_unpack_list()
+    test_mixed_types()
+    test_arity()
+    test_escaping()
+
+if __name__ == '__main__':
+    test_all()
@@ -111,6 +111,87 @@ def test_sequence_mutable():
     assert arr.tolist() == [17, 21, 18, 12]
 
 
+def test_numeric():
+    ai = array.array('i', range(-50, 50))
+    assert sum(ai) == -50
+    assert sum(x for x in ai) == -50
+    assert min(ai) == -50
+    assert max(ai) == 49
+    assert ai.count(7) == 1
+    assert ai.index(-48) == 2
+
+    ab = array.array('B', [200, 100, 255, 7, 255])
+    assert sum(ab) == 817
+    assert min(ab) == 7
+    assert max(ab) == 255
+    assert ab.count(255) == 2
+    assert ab.count(-1) == 0
+    assert ab.count(511) == 0
+    assert ab.index(7) == 3
+
+    bi = array.array('i', [2] * 100)
+    assert sum(x * y for x, y in zip(ai, bi)) == -100
+
+    af = array.array('d', [0.5 * i for i in range(20)])
+    assert sum(af) == 95.0
+    assert min(af) == 0.0
+    assert max(x for x in af) == 9.5
+    bf = array.array('d', [2.0] * 20)
+    assert sum([x * y for x, y in zip(af, bf)]) == 190.0
+    assert af.count(1.5) == 1
+    assert af.index(9.5) == 19
+
+    zs = [1.0] * 16  # equal values: the first one
+    zs[1] = 0.0
+    zs[8] = -0.0
+    assert str(min(array.array('d', zs))) == '0.0'
+    assert str(max(array.array('d', [-z for z in zs]))) == '-0.0'
+    assert str(min(array.array('f', zs))) == '0.0'
+
+    ff = array.array('f', [1.5, 2.5, 0.1])
+    assert sum(ff) == 1.5 + 2.5 + float(ff[2])
+    assert ff.count(0.1) == 0
+
+    ah = array.array('h', [1, 2, 3])
+    ah.byteswap()
+    assert ah.tolist() == [256, 512, 768]
+
+    empty = array.array('i')
+    assert sum(empty) == 0
+    raised = False
+    try:
+        max(empty)
+    except ValueError:
+        raised = True
+    assert raised
+
+
+def test_kernels():
+    ai = array.array('i', range(-50, 50))
+    bi = array.array('i', [2] * 100)
+    try:
+        dot = ai.dot(bi)
+    except Exception:  # (AttributeError: shedskin only)
+        return
+    assert dot == -100
+    ai.scale(3)
+    assert ai[0] == -150
+    ai.elementwise_add(bi)
+    assert ai[0] == -148
+    ai.elementwise_mul(bi)
+    assert ai[0] == -296
+
+    af = array.array('d', [0.5 * i for i in range(20)])
+    bf = array.array('d', [2.0] * 20)
+    assert af.dot(bf) == 190.0
+    af.scale(2.0)
+    assert af[3] == 3.0
+    af.elementwise_add(bf)
+    assert af[3] == 5.0
+    af.elementwise_mul(bf)
+    assert af[3] == 10.0
+
+
 def test_all():
     test_typecodes()
     test_list()
@@ -118,6 +199,8 @@ def test_all():
     test_file()
     test_sequence_immutable()
     test_sequence_mutable()
+    test_numeric()
+    test_kernels()
 
 
 if __name__ == '__main__':
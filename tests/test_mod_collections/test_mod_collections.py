@@ -78,6 +78,72 @@ def test_collections_deque2():
     assert not list(d)
 
 
+def test_collections_deque3():
+    d = deque([1, 2, 3, 4], 3)
+    assert list(d) == [2, 3, 4]
+    d.append(5)
+    assert list(d) == [3, 4, 5]
+    d.appendleft(2)
+    assert list(d) == [2, 3, 4]
+    d.extend([6, 7])
+    assert list(d) == [4, 6, 7]
+    d.extendleft([8, 9, 10, 11])
+    assert list(d) == [11, 10, 9]
+    assert repr(d) == 'deque([11, 10, 9], maxlen=3)'
+
+    e = deque(maxlen=2)
+    for i in range(10):
+        e.append(i)
+    assert list(e) == [8, 9]
+
+    f = deque([1, 2], None)
+    f.extend(f)
+    assert list(f) == [1, 2, 1, 2]
+    assert repr(f) == 'deque([1, 2, 1, 2])'
+    f.extendleft(f)
+    assert list(f) == [2, 1, 2, 1, 1, 2, 1, 2]
+
+    h = deque([1, 2, 3], 4)
+    h.extendleft(h)
+    assert list(h) == [3, 2, 1, 1]
+
+    g = deque([0], 0)
+    g.append(1)
+    assert len(g) == 0
+
+
+def test_collections_deque4():
+    d = deque(range(10))
+    for i in range(5):
+        d.popleft()
+        d.append(d[0] + 10)
+    assert list(d) == [5, 6, 7, 8, 9, 11, 12, 13, 14, 15]
+
+    d.rotate(13)
+    assert list(d) == [13, 14, 15, 5, 6, 7, 8, 9, 11, 12]
+    d.rotate(-9)
+    assert list(d) == [12, 13, 14, 15, 5, 6, 7, 8, 9, 11]
+
+    assert 9 in d
+    assert 10 not in d
+    d.remove(15)
+    del d[1]
+    del d[-2]
+    assert list(d) == [12, 14, 5, 6, 7, 8, 11]
+
+    total = 0
+    for x in d:
+        total += x
+    assert total == 63
+
+    removed = True
+    try:
+        d.remove(100)
+    except ValueError:
+        removed = False
+    assert not removed
+
+
 
 
 
@@ -86,6 +152,8 @@ def test_all():
     test_collections_defaultdict2()
     test_collections_deque1()
     test_collections_deque2()
+    test_collections_deque3()
+    test_collections_deque4()
 
 if __name__ == '__main__':
     test_all()
@@ -1,8 +1,18 @@
 import csv
 import collections
+import io
+import itertools
 import os
 import os.path
 
+def read_rows(r, n=-1):
+    try:
+        return r.read_rows(n)
+    except Exception:  # (AttributeError: shedskin only)
+        if n < 0:
+            return list(r)
+        return list(itertools.islice(r, n))
+
 def test_program():
     if os.path.exists('testdata'):
         csvfile_in = os.path.join('testdata', 'woef.csv')
@@ -86,8 +96,33 @@ def test_program():
     )
 
 
+def test_reader():
+    data = 'a,"b,c",""\n"x ""y""\nz",\n\n1,2\\,3\n'
+    rows = list(csv.reader(io.StringIO(data)))
+    assert rows == [['a', 'b,c', ''], ['x "y"\nz', ''], [], ['1', '2\\', '3']]
+
+    r = csv.reader(io.StringIO(data), escapechar='\\')
+    assert r.__next__() == ['a', 'b,c', '']
+    assert r.line_num == 1
+    rows = read_rows(r, 2)
+    assert rows == [['x "y"\nz', ''], []]
+    assert r.line_num == 4
+    assert read_rows(r) == [['1', '2,3']]
+    assert read_rows(r, 1) == []
+
+    r = csv.reader(io.StringIO("'a' |b| 'c|d'\n"), delimiter='|', quotechar="'", skipinitialspace=1)
+    assert r.__next__() == ['a ', 'b', 'c|d']
+
+    try:
+        list(csv.reader(io.StringIO('"a"b\n'), strict=1))
+        assert False
+    except csv.Error as e:
+        assert str(e) == "',' expected after '\"'"
+
+
 def test_all():
     test_program()
+    test_reader()
 
 
 if __name__ == "__main__":
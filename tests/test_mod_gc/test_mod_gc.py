@@ -1,16 +1,82 @@
 import gc
 
 
+def collecting():
+    # (with --arena, there is no garbage collector: gc functions then do nothing)
+    gc.enable()
+    return gc.isenabled()
+
 def test_gc():
+    if not collecting():
+        return
     gc.enable()
-    # assert gc.isenabled()
+    assert gc.isenabled()
     gc.collect()
     gc.disable()
-    # assert not gc.isenabled() ## not implemented
-    assert True ## FIXME hack
+    assert not gc.isenabled()
+    gc.enable()
+
+def test_get_stats():
+    stats = gc.get_stats()
+    assert len(stats) == 3
+    for generation in stats:
+        assert generation['collections'] >= 0
+        assert generation['collected'] >= 0
+        assert generation['uncollectable'] >= 0
+
+def test_heap_stats():
+    try:
+        collections = gc.get_heap_stats()['collections']
+    except Exception:  # (AttributeError: shedskin only)
+        return
+    if not collecting():
+        return
+    garbage = [[i] for i in range(1000)]
+    gc.collect()
+    stats = gc.get_heap_stats()
+    assert stats['collections'] > collections
+    assert stats['pause_total_us'] >= stats['pause_max_us'] >= 0
+    for key in ['heap_size', 'free_bytes', 'unmapped_bytes', 'bytes_since_gc', 'total_bytes', 'parallel_markers']:
+        assert stats[key] >= 0
+
+def test_tuning():
+    try:
+        divisor = gc.get_free_space_divisor()
+    except Exception:  # (AttributeError: shedskin only)
+        return
+    if not collecting():
+        return
+    gc.set_free_space_divisor(divisor + 1)
+    assert gc.get_free_space_divisor() == divisor + 1
+    gc.set_free_space_divisor(divisor)
+    try:
+        gc.set_free_space_divisor(0)
+        assert False
+    except ValueError:
+        pass
+    assert gc.expand_heap(1 << 20)
+
+def test_arena():
+    # (without --arena, reset points do nothing)
+    try:
+        mark = gc.arena_mark()
+    except Exception:  # (AttributeError: shedskin only)
+        return
+    assert mark >= 0
+    garbage = [[i] for i in range(1000)]
+    gc.arena_reset(mark)
+    try:
+        gc.arena_reset(-1)
+        assert False
+    except ValueError:
+        pass
 
 def test_all():
     test_gc()
+    test_get_stats()
+    test_heap_stats()
+    test_tuning()
+    test_arena()
 
 if __name__ == '__main__':
     test_all()
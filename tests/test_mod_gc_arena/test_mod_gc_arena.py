@@ -0,0 +1,81 @@
+import gc
+import sys
+
+
+class Node:
+    def __init__(self, value, next):
+        self.value = value
+        self.next = next
+
+
+def handle(n):
+    head = None
+    for i in range(n):
+        head = Node(str(i), head)
+    words = []
+    while head:
+        words.append(head.value)
+        head = head.next
+    return len(','.join(words))
+
+def test_reset():
+    mark = gc.arena_mark()
+    total = 0
+    for request in range(100):
+        total += handle(1000)
+        gc.arena_reset(mark)
+        assert gc.arena_mark() == mark
+    assert total == 100 * 3889
+
+def test_nested():
+    outer = gc.arena_mark()
+    keep = [str(i) for i in range(100)]
+    inner = gc.arena_mark()
+    assert inner > outer
+    garbage = [[i] for i in range(10000)]
+    gc.arena_reset(inner)
+    assert ''.join(keep[:3]) == '012'
+    try:
+        gc.arena_reset(inner + (1 << 20))
+        assert False
+    except ValueError:
+        pass
+    gc.arena_reset(outer)
+
+def test_large():
+    mark = gc.arena_mark()
+    for i in range(10):
+        big = [i] * 1000000
+        assert big[-1] == i
+        gc.arena_reset(mark)
+    assert gc.get_heap_stats()['heap_size'] < 64 << 20
+
+def test_runtime_state():
+    # interned strings outlive a reset
+    mark = gc.arena_mark()
+    a = sys.intern('request' + str(42))
+    for i in range(100):
+        s = ''.join([str(j) for j in range(i)])
+        gc.arena_reset(mark)
+    b = sys.intern('request' + str(42))
+    assert b == 'request42'
+    assert sys.intern('request42') is b
+
+def test_gc_functions():
+    assert not gc.isenabled()
+    gc.collect()
+    assert gc.get_heap_stats()['collections'] == 0
+
+def test_all():
+    try:
+        gc.arena_mark()
+    except Exception:  # (AttributeError: shedskin only, translated with --arena)
+        return
+    test_reset()
+    test_nested()
+    test_large()
+    test_runtime_state()
+    test_gc_functions()
+
+if __name__ == '__main__':
+    test_all()
@@ -67,6 +67,17 @@ def test_re_compile():
     assert pat.match('bc').groups() ==('b', None, 'b', 'c')
     assert pat.match('bc').groups("") == ('b', "", 'b', 'c')
 
+def test_re_cache():
+    re.purge()
+    p = re.compile('a+b', re.I)
+    assert re.compile('a+b', re.I) is p
+    assert re.compile('a+b') is not p
+    assert re.search('a+b', 'xAAB', re.I).span() == (1, 4)
+
+    assert re.match('a+', 'baa') is None
+    assert re.match('a.b', 'a\nb') is None
+    assert re.match('a.b', 'a\nb', re.S).span() == (0, 3)
+
 def test_re_example1():
     a = re.compile(
         r"\b(?P<email_name>[\w.-]+?)@(?P<email_domain>[a-z.-]{3,})\b", re.IGNORECASE
@@ -107,6 +118,7 @@ def test_all():
     test_re_subn()
     test_re_split()
     test_re_compile()
+    test_re_cache()
     test_re_example1()
     test_re_example2()
     test_re_example3()
@@ -337,6 +337,65 @@ def test_order():
     assert a == b[::-1]
 
 
+RECORD = struct.Struct('<hId?2s')
+
+
+def test_struct():
+    assert RECORD.size == 17
+    assert RECORD.format == '<hId?2s'
+
+    data = RECORD.pack(-3, 40000, 2.5, True, b'ok')
+    assert len(data) == 17
+    a, b, c, d, e = RECORD.unpack(data)
+    assert a == -3 and b == 40000 and c == 2.5 and d and e == b'ok'
+
+    buf = bytearray(3 * RECORD.size)
+    for i in range(3):
+        RECORD.pack_into(buf, i * RECORD.size, i, 2 * i, i / 2, i == 1, b'x')
+    total = 0.0
+    for a, b, c, d, e in RECORD.iter_unpack(buf):
+        assert b == 2 * a and d == (a == 1) and e == b'x\x00'
+        total += c
+    assert total == 1.5
+
+    a, b, c, d, e = RECORD.unpack_from(buf, RECORD.size)
+    assert (a, b) == (1, 2)
+    a, b, c, d, e = RECORD.unpack_from(buf, -RECORD.size)
+    assert (a, b) == (2, 4)
+
+    native = struct.Struct('bxiHq2c')
+    data = native.pack(1, 2, 3, 4, b'a', b'b')
+    assert len(data) == native.size == struct.calcsize('bxiHq2c')
+    h, i, j, k, l, m = native.unpack(data)
+    assert [h, i, j, k] == [1, 2, 3, 4] and l + m == b'ab'
+
+    assert struct.Struct('<i?').pack(5, 1.5) == b'\x05\x00\x00\x00\x01'
+    assert struct.Struct('<hh?').pack(1, 2, 'x') == b'\x01\x00\x02\x00\x01'
+    assert struct.Struct('<hh?').pack(1, 2, '') == b'\x01\x00\x02\x00\x00'
+
+    error = ''
+    try:
+        RECORD.pack(1, 2)
+    except struct.error as err:
+        error = str(err)
+    assert error == 'pack expected 5 items for packing (got 2)'
+
+    error = ''
+    try:
+        a, b, c, d, e = RECORD.unpack_from(buf, 2 * RECORD.size + 1)
+    except struct.error as err:
+        error = str(err)
+    assert error.startswith('unpack_from requires a buffer of at least 52 bytes')
+
+    error = ''
+    try:
+        for a, b, c, d, e in RECORD.iter_unpack(buf[1:]):
+            pass
+    except struct.error as err:
+        error = str(err)
+    assert error == 'iterative unpacking requires a buffer of a multiple of 17 bytes'
+
+
 def test_all():
     test_unpack()
     test_unpack_from()
@@ -355,6 +414,7 @@ def test_all():
     test_multi_1()
     test_order()
     test_ws()
+    test_struct()
 
 
 if __name__ == '__main__':
@@ -10,8 +10,18 @@ def test_sys():
     sys.stdout.write(' ')
     sys.stderr.write(' ')
 
+def test_intern():
+    a = sys.intern(''.join(['hello', ' ', 'world']))
+    b = sys.intern('hello ' + 'world')
+    assert a == 'hello world'
+    assert a is b
+    assert sys.intern('x') == 'x'
+    d = {a: 1}
+    assert d['hello world'] == 1
+
 def test_all():
     test_sys()
+    test_intern()
 
 if __name__ == '__main__':
     test_all()
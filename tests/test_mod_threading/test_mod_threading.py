@@ -0,0 +1,186 @@
+import array
+import struct
+import threading
+
+
+counter = [0]
+counter_lock = threading.Lock()
+
+
+def increment():
+    for i in range(10000):
+        with counter_lock:
+            counter[0] += 1
+
+
+def nothing():
+    pass
+
+
+gate = threading.Lock()
+
+
+def blocked():
+    with gate:
+        pass
+
+
+class Summer(threading.Thread):
+    def __init__(self, n):
+        threading.Thread.__init__(self)
+        self.n = n
+        self.result = 0
+
+    def run(self):
+        s = 0
+        for i in range(self.n):
+            s += i
+        self.result = s
+
+
+class Packer(threading.Thread):
+    def __init__(self, value):
+        threading.Thread.__init__(self)
+        self.value = value
+        self.ok = False
+
+    def run(self):
+        a = array.array('d')
+        for i in range(20000):
+            a.append(self.value)
+            a[i] = self.value
+        packed = struct.pack('<d', self.value)
+        same = True
+        for i in range(20000):
+            if struct.pack('<d', self.value) != packed:
+                same = False
+        self.ok = same and a.count(self.value) == 20000
+
+
+def test_target():
+    threads = [threading.Thread(target=increment) for i in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    assert counter[0] == 40000
+    for t in threads:
+        assert not t.is_alive()
+
+
+def test_subclass():
+    workers = [Summer(1000 * (i + 1)) for i in range(4)]
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    assert [w.result for w in workers] == [499500, 1999000, 4498500, 7998000]
+
+
+def test_name():
+    t = threading.Thread(target=nothing, name='worker')
+    assert t.name == 'worker'
+    assert not t.is_alive()
+    t.start()
+    t.join()
+    assert not t.is_alive()
+
+    t = threading.Thread(target=nothing, daemon=True)
+    assert t.daemon
+    assert t.name.startswith('Thread-')
+
+
+def test_errors():
+    t = threading.Thread(target=nothing)
+    try:
+        t.join()
+        assert False
+    except RuntimeError:
+        pass
+    t.start()
+    try:
+        t.start()
+        assert False
+    except RuntimeError:
+        pass
+    t.join()
+
+
+def test_lock():
+    lock = threading.Lock()
+    assert not lock.locked()
+    assert lock.acquire()
+    assert lock.locked()
+    assert not lock.acquire(False)
+    assert not lock.acquire(True, 0.01)
+    lock.release()
+    assert not lock.locked()
+    try:
+        lock.release()
+        assert False
+    except RuntimeError:
+        pass
+
+
+def test_rlock():
+    rlock = threading.RLock()
+    assert rlock.acquire()
+    assert rlock.acquire()
+    rlock.release()
+    rlock.release()
+    try:
+        rlock.release()
+        assert False
+    except RuntimeError:
+        pass
+    with rlock:
+        with rlock:
+            pass
+
+
+def test_current():
+    assert threading.current_thread() is threading.main_thread()
+    assert threading.main_thread().name == 'MainThread'
+    assert threading.get_ident() == threading.main_thread().ident
+    assert threading.active_count() == 1
+
+
+def test_unjoined():
+    gate.acquire()
+    t = threading.Thread(target=blocked)
+    t.start()
+    t.join(0.01)
+    assert t.is_alive()
+    gate.release()
+    t.join()
+    assert not t.is_alive()
+
+    # never joined: waited for at exit, or (daemon) abandoned
+    threading.Thread(target=increment).start()
+    threading.Thread(target=nothing, daemon=True).start()
+
+
+def test_scratch_buffers():
+    # array stores and struct.pack go through a per-thread scratch buffer
+    packers = [Packer(i + 0.5) for i in range(4)]
+    for p in packers:
+        p.start()
+    for p in packers:
+        p.join()
+    assert [p.ok for p in packers] == [True, True, True, True]
+
+
+def test_all():
+    test_target()
+    test_subclass()
+    test_name()
+    test_errors()
+    test_lock()
+    test_rlock()
+    test_current()
+    test_unjoined()
+    test_scratch_buffers()
+
+
+if __name__ == '__main__':
+    test_all()
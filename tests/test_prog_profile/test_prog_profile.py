@@ -0,0 +1,58 @@
+# smoke test of the --profile report: the executable runs itself (with argument 'work') and
+# SHEDSKIN_PROFILE set, and the report is checked. (nothing to check under python)
+
+import os
+import sys
+
+
+def fib(n):
+    if n < 2:
+        return n
+    return fib(n - 1) + fib(n - 2)
+
+
+def work():
+    s = 0
+    for i in range(20):
+        s += fib(24)
+    return s
+
+
+def test_report():
+    exe = sys.argv[0]
+    if exe.endswith('.py') or not os.path.isfile(exe):
+        return
+    if '/' not in exe:
+        exe = './' + exe
+    report = 'profile_report.txt'
+    assert os.system('SHEDSKIN_PROFILE=%s %s work' % (report, exe)) == 0
+    lines = [line.rstrip('\n') for line in open(report)]
+    os.remove(report)
+
+    assert lines[1].startswith('shedskin profile: ')
+    assert lines[1].split()[3] == 'samples'
+    assert 'flat profile:' in lines
+    assert 'hot lines:' in lines
+    assert 'call graph:' in lines
+
+    flat = lines[lines.index('flat profile:') + 2:lines.index('hot lines:')]
+    assert flat[0].split() == ['%self', 'self', 's', '%total', 'total', 's', 'calls', 'function']
+    rows = {}
+    for line in flat[1:]:
+        if line:
+            fields = line.split()
+            assert fields[0].endswith('%') and fields[2].endswith('%')
+            rows[fields[5]] = int(fields[4])
+    assert rows['fib'] == 20 * 150049
+    assert rows['work'] == 1
+
+
+def test_all():
+    test_report()
+
+
+if __name__ == '__main__':
+    if sys.argv[1:] == ['work']:
+        assert work() == 20 * 46368
+    else:
+        test_all()
@@ -114,6 +114,65 @@ def test_pop():
     assert len(d) == 0
 
 
+def test_order():
+    d = {}
+    for i in range(100):
+        d[str(i)] = i
+    for i in range(0, 100, 2):
+        del d[str(i)]
+    d['0'] = -1  # re-inserted keys go to the end
+    d['1'] = -2  # existing keys keep their place
+    for i in range(100, 200):  # resize, dropping deleted entries
+        d[str(i)] = i
+    keys = list(d)
+    assert keys[:3] == ['1', '3', '5']
+    assert keys[49:52] == ['99', '0', '100']
+    assert keys[-1] == '199'
+    assert len(d) == 151
+    assert d['1'] == -2
+    assert list(d.values())[:2] == [-2, 3]
+    assert list(d.items())[50] == ('0', -1)
+
+
+def test_popitem():
+    d = {1: 'a', 2: 'b', 3: 'c'}
+    del d[2]
+    d[4] = 'd'
+    assert d.popitem() == (4, 'd')
+    assert d.popitem() == (3, 'c')
+    d[5] = 'e'
+    assert list(d) == [1, 5]
+    assert d.popitem() == (5, 'e')
+    assert d.popitem() == (1, 'a')
+    assert not d
+    try:
+        d.popitem()
+        assert False
+    except KeyError:
+        pass
+
+    # shrinking the dict while iterating over it stops the loop
+    # (CPython raises RuntimeError)
+    e = dict([(i, str(i)) for i in range(10)])
+    seen = []
+    try:
+        for k in e:
+            seen.append(k)
+            e.popitem()
+    except RuntimeError:
+        pass
+    assert seen[0] == 0 and len(seen) <= 5
+    f = dict([(i, i) for i in range(10)])
+    seen = []
+    try:
+        for k, v in f.items():
+            seen.append(k)
+            f.clear()
+    except RuntimeError:
+        pass
+    assert seen == [0]
+
+
 def test_all():
     test_dict()
     test_dict_get()
@@ -127,6 +186,8 @@ def test_all():
     # test_func_as_value()
     test_dict_fromkeys()
     test_pop()
+    test_order()
+    test_popitem()
 
 
 if __name__ == "__main__":
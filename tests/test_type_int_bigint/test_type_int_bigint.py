@@ -0,0 +1,109 @@
+# requires --bigint (see CMakeLists.txt); translated without it, the tests are skipped
+
+def unbounded():
+    try:
+        return str(int('9' * 30)) == '9' * 30
+    except Exception:
+        return False
+
+def test_overflow():
+    a = 1
+    for i in range(100):
+        a *= 3
+    assert a == 515377520732011331036461129765621272702107522001
+    assert a // 3**99 == 3
+    assert a % 1000007 == 664323
+    assert 2**63 - 1 + 1 == 9223372036854775808
+    assert -(2**62) - 1 == -4611686018427387905
+    assert 9223372036854775807 * 2 == 18446744073709551614
+    x = 2**64
+    x -= 2**64
+    assert x == 0
+
+def test_division():
+    assert 2**80 // 7 == 172703688516375596386596
+    assert 2**80 % 7 == 4
+    assert -(2**80) // 7 == -172703688516375596386597
+    assert -(2**80) % 7 == 3
+    assert -7 // 2 == -4
+    assert -7 % 2 == 1
+    assert divmod(2**100, 2**70 + 1) == (1073741823, 1180591620716337561601)
+    assert 2**80 / 2**78 == 4.0
+    try:
+        2**80 // 0
+        assert False
+    except ZeroDivisionError:
+        pass
+
+def test_bitwise():
+    assert 1 << 90 == 1237940039285380274899124224
+    assert (2**80) >> 3 == 151115727451828646838272
+    assert (-(2**80)) >> 5 == -37778931862957161709568
+    assert (2**70) & (2**70 - 1) == 0
+    assert (-(2**70)) | 3 == -1180591620717411303421
+    assert ~(2**70) == -1180591620717411303425
+    assert (2**70) ^ -1 == -1180591620717411303425
+    assert int.bit_count(2**70) == 1
+    assert int.bit_count(2**70 - 1) == 70
+
+def test_compare():
+    assert 2**70 > 5
+    assert 5.5 < 2**70
+    assert -(2**65) < -3
+    assert sorted([2**70, -3, 5, -(2**65)]) == [-(2**65), -3, 5, 2**70]
+    assert max(2**70, 3) == 2**70
+    assert min([2**65, 2**64]) == 2**64
+
+def test_conversion():
+    assert str(2**64) == '18446744073709551616'
+    assert repr(-(2**64)) == '-18446744073709551616'
+    assert hex(2**70) == '0x400000000000000000'
+    assert int('123456789012345678901234567890') == 123456789012345678901234567890
+    assert int('-ffffffffffffffffffff', 16) == -(2**80 - 1)
+    assert int('1' * 70, 2) == 2**70 - 1
+    assert int(1e25) == 10000000000000000905969664
+    assert float(2**80) == 1.2089258196146292e+24
+    assert abs(-(2**80)) == 2**80
+    assert pow(3, 200, 10**30) == 92490901302182994384699044001
+    assert 2**100 == 1267650600228229401496703205376
+
+def test_format():
+    assert '%d' % 2**65 == '36893488147419103232'
+    assert '%x' % 2**65 == '20000000000000000'
+    assert '%X|%-25d|%+d' % (2**65 - 1, -(2**65), 2**65) == '1FFFFFFFFFFFFFFFF|-36893488147419103232    |+36893488147419103232'
+    assert '%05d' % 3 == '00003'
+    assert f'{2**70}' == '1180591620717411303424'
+
+def test_hash():
+    d = {2**70: 'x', 5: 'y'}
+    assert d[2**69 * 2] == 'x'
+    assert d[5] == 'y'
+    assert len({2**64, 2**64 + 0, 2**65}) == 2
+
+    # as in python: modulo 2**61-1, and -1 is reserved
+    assert hash(5) == 5
+    assert hash(-1) == -2
+    assert hash(2**40) == 2**40
+    assert hash(-(2**40)) == -(2**40)
+    assert hash(2**61 - 1) == 0
+    assert hash(2**61) == 1
+    assert hash(2**62 + 3) == 5
+    assert hash(-(2**62) - 3) == -5
+    assert hash(2**100) == pow(2, 100, 2**61 - 1)
+    assert hash(-(2**100)) == -hash(2**100)
+    print(hash(2**40), hash(2**100), hash(-1))
+
+def test_all():
+    if not unbounded():
+        return
+    test_overflow()
+    test_division()
+    test_bitwise()
+    test_compare()
+    test_conversion()
+    test_format()
+    test_hash()
+
+
+if __name__ == "__main__":
+    test_all()
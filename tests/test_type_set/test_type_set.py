@@ -183,6 +183,60 @@ def test_set_syntax():
     assert s == set([1,2])
 
 
+def test_set_table():
+    # deletions leave dummy entries behind, which insertions reuse
+    s = set(range(1000))
+    for i in range(0, 1000, 2):
+        s.remove(i)
+    assert len(s) == 500
+    assert 2 not in s and 3 in s
+    assert sorted(s) == list(range(1, 1000, 2))
+    for i in range(0, 1000, 4):
+        s.add(i)
+    assert len(s) == 750
+    assert sum(s) == sum(range(1, 1000, 2)) + sum(range(0, 1000, 4))
+
+    # churn: the table must not fill up with dummies
+    t = set()
+    for i in range(10000):
+        t.add(i)
+        if i >= 10:
+            t.discard(i - 10)
+    assert sorted(t) == list(range(9990, 10000))
+
+    # iteration after removals and resizes
+    u = set()
+    for i in range(100):
+        u.add(str(i))
+    for i in range(90):
+        u.discard(str(i))
+    u.discard('missing')
+    assert len(u) == 10 and min(u) == '90' and max(u) == '99'
+    for i in range(200, 400):
+        u.add(str(i))
+    n = 0
+    for x in u:
+        n += 1
+    assert n == 210
+    assert '95' in u and '50' not in u and '399' in u
+
+    # pop empties the set, returning every element once
+    v = set(range(50))
+    v.remove(25)
+    total = 0
+    while v:
+        total += v.pop()
+    assert total == sum(range(50)) - 25
+    v.add(7)
+    assert 7 in v and len(v) == 1
+
+    # clear, then reuse
+    u.clear()
+    assert len(u) == 0
+    u.add('x')
+    assert 'x' in u and len(u) == 1
+
+
 def test_all():
     test_set1()
     test_set2()
@@ -195,6 +249,7 @@ def test_all():
     test_set_binary_elem()
     test_set_augmented_assign()
     test_set_syntax()
+    test_set_table()
 
 if __name__ == "__main__":
     test_all()
@@ -33,6 +33,8 @@ def test_expandtabs():
 def test_find():
     assert 'bla'.find('la') == 1
     assert 'bla'.find('ba') == -1
+    assert 'blabla'.find('la', 2) == 4
+    assert 'blabla'.find('la', 2, 4) == -1
 
 def test_format(): pass
 
@@ -141,6 +143,7 @@ def test_replace():
 def test_rfind():
     assert 'bla'.rfind('la') == 1
     assert 'bla'.rfind('ba') == -1
+    assert 'blabla'.rfind('la', 0, 4) == 1
 
 def test_rindex():
     assert 'bla'.rindex('la') == 1
@@ -153,6 +156,7 @@ def test_rjust():
 def test_rpartition():
     assert "a and b and c".rpartition("and") == ('a and b ', 'and', ' c')
     assert 'aa-bb-cc'.rpartition('-')
+    assert 'aa'.rpartition('-') == ('', '', 'aa')
 
 def test_rstrip():
     assert 'bla'.rstrip('a') == 'bl'
@@ -198,6 +202,9 @@ def test_startswith():
 def test_strip():
     assert 'bla  '.strip() == 'bla'
     assert '**bla**'.strip('*') == 'bla'
+    assert ' b '.strip() == 'b'
+    assert 'bla'.strip() == 'bla'
+    assert '   '.strip() == ''
 
 def test_swapcase():
     assert 'bLa'.swapcase() == 'BlA'
@@ -0,0 +1,53 @@
+# string constants are interned with --intern
+import sys
+
+
+def spam():
+    return 'spam_and_eggs'
+
+def also_spam():
+    return 'spam_and_eggs'
+
+def ham():
+    return 'ham_and_eggs'
+
+
+def test_identity():
+    assert spam() is also_spam()
+    assert spam() is not ham()
+
+    built = ''.join(['spam', '_and', '_eggs'])
+    assert built == spam()
+    assert sys.intern(built) is spam()
+    assert sys.intern(built) is sys.intern('spam_and_' + 'eggs')
+
+    x = 'xy'[0]
+    assert sys.intern(x) is sys.intern('x')
+
+def test_equality():
+    built = 'ham_and_' + ''.join(['e', 'g', 'g', 's'])
+    assert built == ham()
+    assert not (built != ham())
+    assert spam() != ham()
+    assert spam() < ham() or ham() < spam()
+
+def test_keys():
+    d = {'spam_and_eggs': 1, 'ham_and_eggs': 2}
+    key = ''.join(['ham', '_and', '_eggs'])
+    assert d[key] == 2
+    assert d[sys.intern(key)] == 2
+    assert 'spam_and_eggs' in d
+    assert 'eggs' not in d
+
+    s = set(['spam_and_eggs'])
+    assert ''.join(['spam_and', '_eggs']) in s
+    assert sys.intern('ham_and_eggs') not in s
+
+
+def test_all():
+    test_identity()
+    test_equality()
+    test_keys()
+
+if __name__ == '__main__':
+    test_all()